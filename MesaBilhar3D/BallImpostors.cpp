@@ -0,0 +1,160 @@
+#include "BallImpostors.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace P3D {
+
+    // O quad fica no plano que passa pelo centro, perpendicular ao raio câmara->centro, com o
+    // meio-lado do cone tangente à esfera nesse plano (r * d / sqrt(d² - r²)); em projeção
+    // ortográfica (minimapa) os raios são paralelos e basta o raio.
+    static const char* impostorVertexShaderSource = R"(
+#version 330 core
+layout(location=0) in vec2 corner;
+
+flat out vec3 vCenter;
+flat out float vRadius;
+out vec3 vViewPosition;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main(){
+    vec3 center = (view * vec4(model[3].xyz, 1.0)).xyz;
+    float radius = length(model[0].xyz);
+
+    bool orthographic = projection[3][3] == 1.0;
+    float centerDistance = length(center);
+    vec3 axis = orthographic ? vec3(0.0, 0.0, 1.0) : -center / centerDistance;
+    vec3 up = abs(axis.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+    vec3 right = normalize(cross(up, axis));
+    up = cross(axis, right);
+    float halfSize = orthographic ? radius : radius * centerDistance / sqrt(max(centerDistance * centerDistance - radius * radius, 1e-6));
+
+    vViewPosition = center + (corner.x * right + corner.y * up) * halfSize;
+    vCenter = center;
+    vRadius = radius;
+    gl_Position = projection * vec4(vViewPosition, 1.0);
+}
+)";
+
+    // A profundidade escrita é sempre menor que a do quad (o ponto atingido está entre a
+    // câmara e o plano do centro): com ARB_conservative_depth o early-z continua a funcionar
+    static const char* impostorFragmentShaderSource = R"(
+#version 330 core
+#extension GL_ARB_conservative_depth : enable
+#ifdef GL_ARB_conservative_depth
+layout(depth_less) out float gl_FragDepth;
+#endif
+
+flat in vec3 vCenter;
+flat in float vRadius;
+in vec3 vViewPosition;
+out vec4 FragColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform sampler2D diffuseMap;
+
+const float PI = 3.14159265358979;
+
+void main(){
+    bool orthographic = projection[3][3] == 1.0;
+    vec3 origin = orthographic ? vec3(vViewPosition.xy, 0.0) : vec3(0.0);
+    vec3 direction = orthographic ? vec3(0.0, 0.0, -1.0) : normalize(vViewPosition);
+
+    // Raio-esfera: t² + 2bt + c = 0, fica a interseção mais próxima
+    vec3 offset = origin - vCenter;
+    float b = dot(offset, direction);
+    float c = dot(offset, offset) - vRadius * vRadius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0) discard;
+    vec3 hit = origin + (-b - sqrt(discriminant)) * direction;
+
+    vec4 clip = projection * vec4(hit, 1.0);
+    gl_FragDepth = 0.5 * (gl_DepthRange.diff * (clip.z / clip.w) + gl_DepthRange.near + gl_DepthRange.far);
+
+    // As bolas não rodam: a normal no mundo é também a do modelo
+    vec3 normal = transpose(mat3(view)) * ((hit - vCenter) / vRadius);
+
+    // UVs do AppendSphere: u = longitude (atan(x, z)), v = 0 no polo norte. Na costura
+    // u = 0/1 as derivadas implícitas dariam o mipmap mais pequeno (uma linha de outra cor);
+    // em cada direção usa-se a derivada de u em [0,1) ou em [-0.5,0.5), a que for contínua
+    // aqui - a textura está em GL_REPEAT, por isso o valor amostrado é o mesmo. Junto aos
+    // polos as linhas da textura são constantes e u varia depressa: a derivada é escalada
+    // por sin(phi) para o polo não ficar com a média da textura toda.
+    float longitude = atan(normal.x, normal.z) / (2.0 * PI);
+    float wrapped = fract(longitude);
+    vec2 uv = vec2(wrapped, acos(clamp(normal.y, -1.0, 1.0)) / PI);
+    vec2 dx = dFdx(uv), dy = dFdy(uv);
+    float dxLongitude = dFdx(longitude), dyLongitude = dFdy(longitude);
+    if (abs(dxLongitude) < abs(dx.x)) dx.x = dxLongitude;
+    if (abs(dyLongitude) < abs(dy.x)) dy.x = dyLongitude;
+    float sinPhi = sqrt(max(1.0 - normal.y * normal.y, 0.0));
+    dx.x *= sinPhi;
+    dy.x *= sinPhi;
+
+    float diffuse = max(dot(normal, normalize(vec3(0.3,1.0,0.5))), 0.0);
+    FragColor = vec4(textureGrad(diffuseMap, uv, dx, dy).rgb * (0.3 + 0.7 * diffuse), 1.0);
+}
+)";
+
+    BallImpostors::BallImpostors()
+        : VAO(0), VBO(0), EBO(0)
+    {
+    }
+
+    BallImpostors::~BallImpostors() {
+        Destroy();
+    }
+
+    bool BallImpostors::Create() {
+        Destroy();
+
+        const float corners[8] = { -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f };
+        const unsigned int quad[6] = { 0, 1, 2, 2, 3, 0 };
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glBindVertexArray(0);
+        return true;
+    }
+
+    void BallImpostors::Destroy() {
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+
+    void BallImpostors::Submit(DrawQueue& queue, GLuint shaderProgram, GLuint texture,
+        const glm::vec3& center, float radius, float depth) const {
+        DrawCommand command;
+        command.program = shaderProgram;
+        command.texture = texture;
+        command.vao = VAO;
+        command.indexCount = 6;
+        command.indexOffset = 0;
+        command.model = glm::scale(glm::translate(glm::mat4(1.0f), center), glm::vec3(radius));
+        command.key = DrawQueue::MakeKey(command.program, command.texture, command.vao, depth);
+        queue.Add(command);
+    }
+
+    const char* BallImpostors::VertexShaderSource() {
+        return impostorVertexShaderSource;
+    }
+
+    const char* BallImpostors::FragmentShaderSource() {
+        return impostorFragmentShaderSource;
+    }
+
+} // namespace P3D
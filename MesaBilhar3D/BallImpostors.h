@@ -0,0 +1,43 @@
+#ifndef BALLIMPOSTORS_H
+#define BALLIMPOSTORS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "DrawQueue.h"
+
+namespace P3D {
+
+    // Bolas como impostores: um quad de 4 vértices por bola, virado para a câmara e com o
+    // tamanho do contorno da esfera. O fragment shader interseta o raio de cada pixel com
+    // a esfera (descarta os que falham), escreve a profundidade do ponto atingido e calcula
+    // as UVs da mesma projeção equiretangular do AppendSphere, por isso o contorno é exato
+    // a qualquer distância e não há LODs.
+    // O draw é um DrawCommand normal (6 índices, model = translação * escala pelo raio),
+    // ordenado na DrawQueue com o resto; o programa tem de usar os shaders de
+    // VertexShaderSource() e FragmentShaderSource().
+    class BallImpostors {
+    public:
+        BallImpostors();
+        ~BallImpostors();
+
+        bool Create();
+        // Liberta o VAO/VBO/EBO (tem de ser chamado com o contexto ainda ativo)
+        void Destroy();
+
+        void Submit(DrawQueue& queue, GLuint shaderProgram, GLuint texture,
+            const glm::vec3& center, float radius, float depth) const;
+
+        static const char* VertexShaderSource();
+        static const char* FragmentShaderSource();
+
+    private:
+        GLuint VAO, VBO, EBO;
+
+        BallImpostors(const BallImpostors&) = delete;
+        BallImpostors& operator=(const BallImpostors&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // BALLIMPOSTORS_H
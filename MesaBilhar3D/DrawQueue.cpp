@@ -0,0 +1,89 @@
+#include "DrawQueue.h"
+#include <glm/gtc/type_ptr.hpp>
+
+namespace P3D {
+
+    uint64_t DrawQueue::MakeKey(GLuint program, GLuint texture, GLuint vao, float depth) {
+        if (depth < 0.0f) depth = 0.0f;
+        if (depth > 1.0f) depth = 1.0f;
+        uint64_t depthBits = static_cast<uint64_t>(depth * 0xFFFFF);
+
+        return (static_cast<uint64_t>(program & 0xFFF) << 52) |
+            (static_cast<uint64_t>(texture & 0xFFFF) << 36) |
+            (static_cast<uint64_t>(vao & 0xFFFF) << 20) |
+            depthBits;
+    }
+
+    void DrawQueue::Sort() {
+        const size_t count = commands.size();
+        order.resize(count);
+        scratch.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i].key = commands[i].key;
+            order[i].index = static_cast<uint32_t>(i);
+        }
+        if (count < 2) return;
+
+        // LSD radix sort, 8 passagens de 8 bits; passagens em que todas as
+        // chaves têm o mesmo dígito são saltadas
+        for (int shift = 0; shift < 64; shift += 8) {
+            size_t histogram[256] = { 0 };
+            for (size_t i = 0; i < count; ++i) {
+                ++histogram[(order[i].key >> shift) & 0xFF];
+            }
+            if (histogram[(order[0].key >> shift) & 0xFF] == count) continue;
+
+            size_t sum = 0;
+            for (int b = 0; b < 256; ++b) {
+                size_t c = histogram[b];
+                histogram[b] = sum;
+                sum += c;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                scratch[histogram[(order[i].key >> shift) & 0xFF]++] = order[i];
+            }
+            order.swap(scratch);
+        }
+    }
+
+    void DrawQueue::Submit(RenderStats& stats) {
+        if (order.size() != commands.size()) Sort();
+
+        GLuint currentProgram = 0, currentTexture = 0, currentVAO = 0;
+        GLint modelLoc = -1;
+        bool first = true;
+
+        glActiveTexture(GL_TEXTURE0);
+        for (const SortEntry& entry : order) {
+            const DrawCommand& cmd = commands[entry.index];
+
+            if (first || cmd.program != currentProgram) {
+                glUseProgram(cmd.program);
+                modelLoc = glGetUniformLocation(cmd.program, "model");
+                currentProgram = cmd.program;
+                ++stats.programBinds;
+            }
+            if (first || cmd.texture != currentTexture) {
+                glBindTexture(GL_TEXTURE_2D, cmd.texture);
+                currentTexture = cmd.texture;
+                ++stats.textureBinds;
+            }
+            if (first || cmd.vao != currentVAO) {
+                glBindVertexArray(cmd.vao);
+                currentVAO = cmd.vao;
+                ++stats.vaoBinds;
+            }
+            first = false;
+
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(cmd.model));
+            if (cmd.quantization) {
+                SetQuantizationUniforms(cmd.program, *cmd.quantization);
+            }
+
+            glDrawElements(GL_TRIANGLES, cmd.indexCount, GL_UNSIGNED_INT, (void*)cmd.indexOffset);
+            ++stats.drawCalls;
+        }
+        glBindVertexArray(0);
+    }
+
+} // namespace P3D
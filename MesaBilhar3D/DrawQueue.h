@@ -0,0 +1,64 @@
+#ifndef DRAWQUEUE_H
+#define DRAWQUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // Um glDrawElements com o estado de que precisa
+    struct DrawCommand {
+        uint64_t key = 0;                 // DrawQueue::MakeKey
+        GLuint program = 0;
+        GLuint texture = 0;               // 0 = sem textura
+        GLuint vao = 0;
+        GLsizei indexCount = 0;
+        size_t indexOffset = 0;           // em bytes dentro do EBO do VAO
+        glm::mat4 model = glm::mat4(1.0f);
+        const QuantizationInfo* quantization = nullptr;  // só para VertexFormat::Quantized
+    };
+
+    // Mudanças de estado GL feitas por DrawQueue::Submit
+    struct RenderStats {
+        unsigned int drawCalls = 0;
+        unsigned int programBinds = 0;
+        unsigned int textureBinds = 0;
+        unsigned int vaoBinds = 0;
+
+        unsigned int StateChanges() const { return programBinds + textureBinds + vaoBinds; }
+        void Reset() { drawCalls = programBinds = textureBinds = vaoBinds = 0; }
+    };
+
+    // Lista de draws de um passo, ordenada por chave de 64 bits (radix sort)
+    // para agrupar shader, depois textura, depois VAO, e por fim frente-para-trás.
+    class DrawQueue {
+    public:
+        // Layout: programa (12 bits) | textura (16) | VAO (16) | profundidade em [0,1] (20)
+        static uint64_t MakeKey(GLuint program, GLuint texture, GLuint vao, float depth);
+
+        void Clear() { commands.clear(); order.clear(); }
+        void Add(const DrawCommand& command) { commands.push_back(command); }
+        size_t Size() const { return commands.size(); }
+
+        void Sort();
+        // view/projection já devem estar definidos em cada programa usado
+        void Submit(RenderStats& stats);
+
+    private:
+        struct SortEntry {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        std::vector<DrawCommand> commands;
+        std::vector<SortEntry> order;
+        std::vector<SortEntry> scratch;
+    };
+
+} // namespace P3D
+
+#endif // DRAWQUEUE_H
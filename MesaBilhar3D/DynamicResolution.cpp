@@ -0,0 +1,188 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace P3D {
+
+    // Peso de cada frame na média dos tempos
+    static const float TIMING_SMOOTHING = 0.25f;
+    // Carga (gpu / alvo) a atingir quando a escala muda, e abaixo da qual a escala sobe
+    static const float TARGET_LOAD = 0.9f;
+    static const float RAISE_BELOW_LOAD = 0.75f;
+    // Variação máxima da escala por frame: desce depressa, sobe devagar
+    static const float MAX_STEP_DOWN = 0.15f;
+    static const float MAX_STEP_UP = 0.05f;
+    // Frames sem nova mudança depois de mudar a escala: os tempos da GPU chegam 1-2 frames
+    // atrasados e a média ainda demora a refletir a escala nova
+    static const int SETTLE_FRAMES = 4;
+
+    ResolutionController::ResolutionController(const DynamicResolutionSettings& initial)
+        : settings(initial), scale(initial.maxScale), filteredGpuMs(-1.0f), filteredCpuMs(-1.0f), settleFrames(0)
+    {
+    }
+
+    void ResolutionController::SetSettings(const DynamicResolutionSettings& newSettings) {
+        settings = newSettings;
+        scale = std::min(std::max(scale, settings.minScale), settings.maxScale);
+    }
+
+    float ResolutionController::Update(float cpuMs, float gpuMs) {
+        filteredCpuMs = filteredCpuMs < 0.0f ? cpuMs : filteredCpuMs + TIMING_SMOOTHING * (cpuMs - filteredCpuMs);
+        // Sem timer de GPU o tempo de CPU (que inclui as esperas pelo driver) faz as vezes
+        float pixelMs = gpuMs >= 0.0f ? gpuMs : cpuMs;
+        filteredGpuMs = filteredGpuMs < 0.0f ? pixelMs : filteredGpuMs + TIMING_SMOOTHING * (pixelMs - filteredGpuMs);
+        if (settings.targetFrameMs <= 0.0f || filteredGpuMs <= 0.0f) return scale;
+        if (settleFrames > 0) {
+            --settleFrames;
+            return scale;
+        }
+
+        float load = filteredGpuMs / settings.targetFrameMs;
+        float desired = scale;
+        if (load > 1.0f) {
+            // Preso no CPU: menos pixels não encurtam o frame
+            bool cpuBound = gpuMs >= 0.0f && filteredCpuMs > filteredGpuMs;
+            if (!cpuBound) desired = scale * std::sqrt(TARGET_LOAD / load);
+        }
+        else if (load < RAISE_BELOW_LOAD) {
+            desired = scale * std::sqrt(TARGET_LOAD / load);
+        }
+
+        desired = std::min(std::max(desired, scale * (1.0f - MAX_STEP_DOWN)), scale * (1.0f + MAX_STEP_UP));
+        desired = std::min(std::max(desired, settings.minScale), settings.maxScale);
+        if (desired != scale) settleFrames = SETTLE_FRAMES;
+        scale = desired;
+        return scale;
+    }
+
+    void ResolutionController::ResetToMaxScale() {
+        if (scale != settings.maxScale) settleFrames = SETTLE_FRAMES;
+        scale = settings.maxScale;
+    }
+
+    GpuFrameTimer::GpuFrameTimer()
+        : next(0), pending(0), active(false)
+    {
+        for (int i = 0; i < QUERIES; ++i) queries[i] = 0;
+    }
+
+    GpuFrameTimer::~GpuFrameTimer() {
+        Destroy();
+    }
+
+    bool GpuFrameTimer::Create() {
+        Destroy();
+        // GL_TIME_ELAPSED é core desde o OpenGL 3.3
+        if (!GLEW_ARB_timer_query && !GLEW_VERSION_3_3) return false;
+        glGenQueries(QUERIES, queries);
+        return true;
+    }
+
+    void GpuFrameTimer::Destroy() {
+        if (active) glEndQuery(GL_TIME_ELAPSED);
+        if (queries[0]) glDeleteQueries(QUERIES, queries);
+        for (int i = 0; i < QUERIES; ++i) queries[i] = 0;
+        next = pending = 0;
+        active = false;
+    }
+
+    void GpuFrameTimer::Begin() {
+        // Todas as queries ainda por ler: este frame fica sem medição
+        if (!queries[0] || active || pending == QUERIES) return;
+        glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+        active = true;
+    }
+
+    void GpuFrameTimer::End() {
+        if (!active) return;
+        glEndQuery(GL_TIME_ELAPSED);
+        active = false;
+        next = (next + 1) % QUERIES;
+        ++pending;
+    }
+
+    bool GpuFrameTimer::Poll(float& milliseconds) {
+        bool found = false;
+        while (pending > 0) {
+            GLuint query = queries[(next - pending + QUERIES) % QUERIES];
+            GLint available = 0;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            --pending;
+            // Há drivers que devolvem lixo na primeira query do contexto: mais de 1 s não é um frame
+            if (nanoseconds > 1000000000ull) continue;
+            milliseconds = static_cast<float>(nanoseconds * 1e-6);
+            found = true;
+        }
+        return found;
+    }
+
+    ScaledRenderTarget::ScaledRenderTarget()
+        : framebuffer(0), color(0), depth(0), width(0), height(0), scaledWidth(0), scaledHeight(0)
+    {
+    }
+
+    ScaledRenderTarget::~ScaledRenderTarget() {
+        Destroy();
+    }
+
+    bool ScaledRenderTarget::Create(int w, int h) {
+        Destroy();
+        width = w;
+        height = h;
+
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        GLint previous = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous));
+
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Erro ao criar o alvo de resolucao dinamica: 0x" << std::hex << status << std::dec << std::endl;
+            Destroy();
+            return false;
+        }
+        return true;
+    }
+
+    void ScaledRenderTarget::Destroy() {
+        if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+        if (color) glDeleteRenderbuffers(1, &color);
+        if (depth) glDeleteRenderbuffers(1, &depth);
+        framebuffer = color = depth = 0;
+        width = height = scaledWidth = scaledHeight = 0;
+    }
+
+    void ScaledRenderTarget::Bind(float scale, int& outWidth, int& outHeight) {
+        scaledWidth = std::min(width, std::max(1, static_cast<int>(width * scale + 0.5f)));
+        scaledHeight = std::min(height, std::max(1, static_cast<int>(height * scale + 0.5f)));
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        outWidth = scaledWidth;
+        outHeight = scaledHeight;
+    }
+
+    void ScaledRenderTarget::Resolve(GLuint targetFramebuffer, int x, int y, int w, int h) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, targetFramebuffer);
+        GLenum filter = (scaledWidth == w && scaledHeight == h) ? GL_NEAREST : GL_LINEAR;
+        glBlitFramebuffer(0, 0, scaledWidth, scaledHeight, x, y, x + w, y + h, GL_COLOR_BUFFER_BIT, filter);
+        glBindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer);
+    }
+
+} // namespace P3D
@@ -0,0 +1,101 @@
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+#include <GL/glew.h>
+
+namespace P3D {
+
+    struct DynamicResolutionSettings {
+        float targetFrameMs = 16.7f;    // tempo de frame a manter
+        float minScale = 0.5f;          // por eixo: 0.5 = 1/4 dos pixels
+        float maxScale = 1.0f;
+    };
+
+    // Escolhe a escala de render (por eixo) a partir dos tempos medidos de cada frame.
+    // O custo que a escala controla é o da GPU (proporcional aos pixels, logo a escala²):
+    // a carga filtrada gpu/alvo define a nova escala com sqrt, com passos limitados, uma
+    // banda morta e alguns frames de espera depois de cada mudança para não oscilar. Se o
+    // frame está preso no CPU, baixar a resolução não ajuda e a escala não desce.
+    class ResolutionController {
+    public:
+        explicit ResolutionController(const DynamicResolutionSettings& settings = DynamicResolutionSettings());
+
+        void SetSettings(const DynamicResolutionSettings& settings);
+        const DynamicResolutionSettings& GetSettings() const { return settings; }
+
+        // gpuMs < 0 = sem medição da GPU (usa o tempo de CPU); devolve a nova escala
+        float Update(float cpuMs, float gpuMs);
+        float GetScale() const { return scale; }
+        // Volta à escala máxima (ex.: antes de um frame que vai ficar parado no ecrã), com os
+        // frames de espera de uma mudança normal
+        void ResetToMaxScale();
+        float GetFilteredGpuMs() const { return filteredGpuMs; }
+        float GetFilteredCpuMs() const { return filteredCpuMs; }
+
+    private:
+        DynamicResolutionSettings settings;
+        float scale;
+        float filteredGpuMs;
+        float filteredCpuMs;
+        int settleFrames;
+    };
+
+    // Tempo de GPU de cada frame com GL_TIME_ELAPSED, sem bloquear: as queries ficam num anel
+    // e o resultado é lido só quando está disponível (normalmente 1-2 frames depois).
+    class GpuFrameTimer {
+    public:
+        static const int QUERIES = 4;
+
+        GpuFrameTimer();
+        ~GpuFrameTimer();
+
+        bool Create();
+        void Destroy();
+
+        void Begin();
+        void End();
+        // Tempo (ms) do frame terminado mais recente que ainda não foi lido; falso se nenhum
+        bool Poll(float& milliseconds);
+
+    private:
+        GLuint queries[QUERIES];
+        int next;        // próxima query a usar
+        int pending;     // queries terminadas por ler (as mais antigas são next - pending)
+        bool active;
+
+        GpuFrameTimer(const GpuFrameTimer&) = delete;
+        GpuFrameTimer& operator=(const GpuFrameTimer&) = delete;
+    };
+
+    // Alvo de cor+profundidade do tamanho máximo onde a vista principal é desenhada num
+    // canto reduzido (sem realocar quando a escala muda) e depois ampliado com filtro linear.
+    class ScaledRenderTarget {
+    public:
+        ScaledRenderTarget();
+        ~ScaledRenderTarget();
+
+        bool Create(int width, int height);
+        void Destroy();
+        bool IsValid() const { return framebuffer != 0; }
+
+        // Liga o alvo e devolve o tamanho do retângulo a usar para a escala dada
+        void Bind(float scale, int& scaledWidth, int& scaledHeight);
+        // Copia o retângulo scaledWidth x scaledHeight para o destino, ampliado
+        void Resolve(GLuint targetFramebuffer, int x, int y, int width, int height);
+
+    private:
+        GLuint framebuffer;
+        GLuint color;
+        GLuint depth;
+        int width;
+        int height;
+        int scaledWidth;
+        int scaledHeight;
+
+        ScaledRenderTarget(const ScaledRenderTarget&) = delete;
+        ScaledRenderTarget& operator=(const ScaledRenderTarget&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // DYNAMICRESOLUTION_H
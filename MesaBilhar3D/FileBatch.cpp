@@ -0,0 +1,404 @@
+#include "FileBatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+
+#include "StartupTrace.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define P3D_IO_URING 1
+#endif
+#endif
+
+#ifdef P3D_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace P3D {
+
+    static std::atomic<bool> useIoUring{ true };
+
+    static bool IoUringAvailable();
+
+    static const unsigned int MaxReadThreads = 8;
+
+    static bool ReadWholeFile(const std::string& filePath, std::vector<unsigned char>& data) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        std::streamoff size = file.tellg();
+        if (size < 0) return false;
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return size == 0 || static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+    }
+
+#ifdef P3D_IO_URING
+    // Anel io_uring mínimo sobre as chamadas ao sistema (sem liburing): só leituras, uma
+    // thread a submeter e a recolher
+    class IoUring {
+    public:
+        IoUring() = default;
+        ~IoUring() {
+            if (sqes) munmap(sqes, sqesSize);
+            if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingSize);
+            if (sqRing) munmap(sqRing, sqRingSize);
+            if (ring >= 0) close(ring);
+        }
+
+        bool Init(unsigned int entries) {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (ring < 0) return false;
+
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap) sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+            sqRing = Map(sqRingSize, IORING_OFF_SQ_RING);
+            if (!sqRing) return false;
+            cqRing = singleMap ? sqRing : Map(cqRingSize, IORING_OFF_CQ_RING);
+            if (!cqRing) return false;
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(Map(sqesSize, IORING_OFF_SQES));
+            if (!sqes) return false;
+
+            unsigned char* sq = static_cast<unsigned char*>(sqRing);
+            sqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+            sqEntries = params.sq_entries;
+
+            unsigned char* cq = static_cast<unsigned char*>(cqRing);
+            cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        // Falso com a fila de submissão cheia; o iovec tem de viver até à conclusão
+        bool PushRead(int fd, iovec* buffer, uint64_t offset, uint64_t userData) {
+            const unsigned int tail = *sqTail;
+            if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) return false;
+            const unsigned int index = tail & sqMask;
+            io_uring_sqe& sqe = sqes[index];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer);
+            sqe.len = 1;
+            sqe.off = offset;
+            sqe.user_data = userData;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            ++unsubmitted;
+            return true;
+        }
+
+        // Submete o que está na fila e espera por pelo menos minComplete conclusões
+        int Enter(unsigned int minComplete) {
+            for (;;) {
+                long result = syscall(__NR_io_uring_enter, ring, unsubmitted, minComplete,
+                    minComplete ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+                if (result >= 0) {
+                    unsubmitted -= static_cast<unsigned int>(result);
+                    return static_cast<int>(result);
+                }
+                if (errno != EINTR) return -errno;
+            }
+        }
+
+        bool PopCompletion(uint64_t& userData, int& result) {
+            const unsigned int head = *cqHead;
+            if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) return false;
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            userData = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+    private:
+        int ring = -1;
+        void* sqRing = nullptr;
+        void* cqRing = nullptr;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqRingSize = 0;
+        size_t cqRingSize = 0;
+        size_t sqesSize = 0;
+
+        unsigned int* sqHead = nullptr;
+        unsigned int* sqTail = nullptr;
+        unsigned int* sqArray = nullptr;
+        unsigned int sqMask = 0;
+        unsigned int sqEntries = 0;
+        unsigned int* cqHead = nullptr;
+        unsigned int* cqTail = nullptr;
+        io_uring_cqe* cqes = nullptr;
+        unsigned int cqMask = 0;
+        unsigned int unsubmitted = 0;
+
+        void* Map(size_t size, off_t offset) {
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, offset);
+            return memory == MAP_FAILED ? nullptr : memory;
+        }
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+    };
+#endif
+
+    void FileBatch::SetUseIoUring(bool enabled) {
+        useIoUring.store(enabled);
+    }
+
+    // Kernel antigo ou io_uring bloqueado (seccomp, contentores): pool de threads
+    FileBatch::FileBatch()
+        : backend(useIoUring.load() && IoUringAvailable() ? FileBatchBackend::IoUring : FileBatchBackend::Threads) {
+    }
+
+    FileBatch::~FileBatch() {
+        for (std::thread& thread : threads) thread.join();
+    }
+
+    const char* FileBatch::GetBackendName() const {
+        return backend == FileBatchBackend::IoUring ? "io_uring" : "threads";
+    }
+
+    void FileBatch::Add(const std::string& filePath) {
+        if (submitted) {
+            std::cerr << "Erro ao acrescentar ficheiro depois do Submit: " << filePath << std::endl;
+            return;
+        }
+        if (filePath.empty() || indices.count(filePath)) return;
+        indices.emplace(filePath, files.size());
+        File file;
+        file.path = filePath;
+        files.push_back(std::move(file));
+    }
+
+    void FileBatch::Submit() {
+        if (submitted) return;
+        submitted = true;
+        submitTime = std::chrono::steady_clock::now();
+        pending = files.size();
+        if (files.empty()) return;
+
+        if (backend == FileBatchBackend::IoUring) {
+            // Abrir e submeter tudo fica numa thread própria: o Submit volta logo e a
+            // thread que o chamou segue para as tarefas que não precisam dos ficheiros
+            threads.emplace_back([this]() {
+                StartupTrace::Instance().SetThreadName("io_uring");
+                RunIoUring();
+            });
+            return;
+        }
+
+        const unsigned int count = static_cast<unsigned int>(std::min<size_t>(files.size(), MaxReadThreads));
+        for (unsigned int i = 0; i < count; ++i) {
+            threads.emplace_back([this, i]() {
+                StartupTrace::Instance().SetThreadName("leitor " + std::to_string(i + 1));
+                ThreadWorker();
+            });
+        }
+    }
+
+    void FileBatch::Finish(size_t index, bool success) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            File& file = files[index];
+            file.state = success ? FileState::Done : FileState::Failed;
+            if (--pending == 0) {
+                milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitTime).count();
+            }
+        }
+        fileDone.notify_all();
+    }
+
+    void FileBatch::ThreadWorker() {
+        for (;;) {
+            size_t index = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (nextFile >= files.size()) return;
+                index = nextFile++;
+            }
+            // Só esta thread mexe no ficheiro até ao Finish
+            File& file = files[index];
+            TraceScope readScope("io.ler", file.path);
+            const bool success = ReadWholeFile(file.path, file.data);
+            if (success) readScope.AddBytes(file.data.size());
+            readScope.End();
+            Finish(index, success);
+        }
+    }
+
+#ifdef P3D_IO_URING
+    static bool IoUringAvailable() {
+        static const bool available = []() {
+            IoUring probe;
+            return probe.Init(1);
+        }();
+        return available;
+    }
+
+    bool FileBatch::RunIoUring() {
+        TraceScope batchScope("io.lote", GetBackendName());
+        IoUring ring;
+        const unsigned int entries = static_cast<unsigned int>(std::min<size_t>(std::max<size_t>(files.size(), 1), 64));
+        if (!ring.Init(entries)) {
+            batchScope.End();
+            ThreadWorker();
+            return false;
+        }
+
+        struct Read {
+            int fd = -1;
+            iovec buffer;
+            size_t offset = 0;
+        };
+        std::vector<Read> reads(files.size());
+        std::deque<size_t> queue;
+        size_t inFlight = 0;
+
+        // Com falha o buffer fica até ao fim do lote: o kernel pode ainda estar a escrever nele
+        auto complete = [&](size_t index, bool success) {
+            if (reads[index].fd >= 0) ::close(reads[index].fd);
+            reads[index].fd = -1;
+            if (success) batchScope.AddBytes(files[index].data.size());
+            Finish(index, success);
+        };
+
+        // Open e fstat continuam síncronos (IORING_OP_OPENAT só existe desde o 5.6); o
+        // que fica em voo em paralelo são as leituras
+        for (size_t i = 0; i < files.size(); ++i) {
+            int fd = open(files[i].path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat info;
+            if (fd < 0 || fstat(fd, &info) != 0) {
+                if (fd >= 0) ::close(fd);
+                Finish(i, false);
+                continue;
+            }
+            reads[i].fd = fd;
+            files[i].data.resize(static_cast<size_t>(info.st_size));
+            if (files[i].data.empty()) {
+                complete(i, true);
+                continue;
+            }
+            queue.push_back(i);
+        }
+
+        while (!queue.empty() || inFlight > 0) {
+            while (!queue.empty() && inFlight < entries) {
+                const size_t index = queue.front();
+                Read& read = reads[index];
+                std::vector<unsigned char>& data = files[index].data;
+                read.buffer.iov_base = data.data() + read.offset;
+                read.buffer.iov_len = data.size() - read.offset;
+                if (!ring.PushRead(read.fd, &read.buffer, read.offset, index)) break;
+                queue.pop_front();
+                ++inFlight;
+            }
+
+            int result = ring.Enter(1);
+            if (result < 0) {
+                std::cerr << "Erro ao submeter leituras ao io_uring: " << strerror(-result) << std::endl;
+                // Os que faltam são lidos de forma síncrona por quem os pede
+                for (size_t index : queue) complete(index, false);
+                queue.clear();
+                if (inFlight > 0) {
+                    for (size_t i = 0; i < reads.size(); ++i) {
+                        if (reads[i].fd >= 0) complete(i, false);
+                    }
+                }
+                break;
+            }
+
+            uint64_t userData = 0;
+            int bytes = 0;
+            while (ring.PopCompletion(userData, bytes)) {
+                --inFlight;
+                const size_t index = static_cast<size_t>(userData);
+                Read& read = reads[index];
+                if (bytes == -EAGAIN || bytes == -EINTR) {
+                    queue.push_back(index);
+                }
+                else if (bytes < 0) {
+                    complete(index, false);
+                }
+                else if (bytes == 0) {
+                    // O ficheiro encolheu depois do fstat
+                    files[index].data.resize(read.offset);
+                    complete(index, true);
+                }
+                else {
+                    read.offset += static_cast<size_t>(bytes);
+                    // Leitura curta: pede o resto
+                    if (read.offset < files[index].data.size()) queue.push_back(index);
+                    else complete(index, true);
+                }
+            }
+        }
+        return true;
+    }
+#else
+    static bool IoUringAvailable() {
+        return false;
+    }
+
+    bool FileBatch::RunIoUring() {
+        ThreadWorker();
+        return false;
+    }
+#endif
+
+    const std::vector<unsigned char>* FileBatch::Wait(const std::string& filePath) {
+        auto found = indices.find(filePath);
+        if (found == indices.end() || !submitted) return nullptr;
+        const File& file = files[found->second];
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (file.state == FileState::Pending) {
+            lock.unlock();
+            TraceScope waitScope("io.esperar", filePath);
+            lock.lock();
+            fileDone.wait(lock, [&file]() { return file.state != FileState::Pending; });
+        }
+        return file.state == FileState::Done ? &file.data : nullptr;
+    }
+
+    void FileBatch::WaitAll() {
+        if (!submitted) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        fileDone.wait(lock, [this]() { return pending == 0; });
+    }
+
+    FileBatchStats FileBatch::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        FileBatchStats stats;
+        stats.backend = GetBackendName();
+        stats.files = static_cast<unsigned int>(files.size());
+        for (const File& file : files) {
+            if (file.state == FileState::Failed) ++stats.failed;
+            if (file.state == FileState::Done) stats.bytes += file.data.size();
+        }
+        stats.milliseconds = milliseconds;
+        return stats;
+    }
+
+} // namespace P3D
@@ -0,0 +1,93 @@
+#ifndef FILEBATCH_H
+#define FILEBATCH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace P3D {
+
+    enum class FileBatchBackend {
+        IoUring,    // Linux: todas as leituras submetidas de uma vez ao kernel
+        Threads     // um pool de threads com leituras bloqueantes (Windows, kernels sem io_uring)
+    };
+
+    struct FileBatchStats {
+        const char* backend = "";
+        unsigned int files = 0;
+        unsigned int failed = 0;
+        uint64_t bytes = 0;
+        double milliseconds = 0.0;      // do Submit até ao último ficheiro lido
+    };
+
+    // Leitura em lote dos ficheiros de um carregamento: Submit pede-os todos de uma vez e
+    // cada Wait devolve o conteúdo de um assim que chegar, para o parser ou o descodificador
+    // o usarem sem o voltarem a ler. Com io_uring as leituras ficam todas em voo no kernel
+    // (útil em discos de rede ou com a cache fria, onde o custo é a latência e não o
+    // débito); sem io_uring, ou se o kernel o recusar (seccomp, contentores), um pool de
+    // threads faz o mesmo com leituras bloqueantes.
+    // Add e Submit na mesma thread; Wait pode ser chamado de qualquer thread.
+    class FileBatch {
+    public:
+        // Para comparar os dois caminhos (--no-io-uring); ligado por omissão
+        static void SetUseIoUring(bool enabled);
+
+        FileBatch();
+        ~FileBatch();
+
+        // Antes do Submit; caminhos repetidos são lidos uma só vez
+        void Add(const std::string& filePath);
+        void Submit();
+
+        // Espera pelo ficheiro; nullptr se não foi pedido ou se a leitura falhou (quem
+        // chama lê-o pelo caminho normal, que também dá a mensagem de erro)
+        const std::vector<unsigned char>* Wait(const std::string& filePath);
+        void WaitAll();
+
+        FileBatchBackend GetBackend() const { return backend; }
+        const char* GetBackendName() const;
+        // Completo depois do WaitAll
+        FileBatchStats GetStats() const;
+
+    private:
+        enum class FileState {
+            Pending,
+            Done,
+            Failed
+        };
+
+        struct File {
+            std::string path;
+            std::vector<unsigned char> data;
+            FileState state = FileState::Pending;
+        };
+
+        FileBatchBackend backend;
+        std::vector<File> files;
+        std::unordered_map<std::string, size_t> indices;
+        std::vector<std::thread> threads;
+        bool submitted = false;
+
+        mutable std::mutex mutex;
+        std::condition_variable fileDone;
+        size_t pending = 0;
+        size_t nextFile = 0;            // pool de threads: próximo ficheiro por ler
+        std::chrono::steady_clock::time_point submitTime;
+        double milliseconds = 0.0;
+
+        void Finish(size_t index, bool success);
+        void ThreadWorker();
+        bool RunIoUring();
+
+        FileBatch(const FileBatch&) = delete;
+        FileBatch& operator=(const FileBatch&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // FILEBATCH_H
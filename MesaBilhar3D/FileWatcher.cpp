@@ -0,0 +1,290 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include "FileWatcher.h"
+
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace P3D {
+
+    // Tempo sem eventos até um ficheiro ser dado como alterado
+    static const int QUIET_MILLISECONDS = 50;
+
+    static void SplitPath(const std::string& filePath, std::string& directory, std::string& name) {
+        size_t slash = filePath.find_last_of("/\\");
+        if (slash == std::string::npos) {
+            directory = ".";
+            name = filePath;
+        }
+        else {
+            directory = slash == 0 ? filePath.substr(0, 1) : filePath.substr(0, slash);
+            name = filePath.substr(slash + 1);
+        }
+    }
+
+#ifdef _WIN32
+    static std::pair<uint64_t, int64_t> FileStamp(const std::string& path) {
+        struct _stat64 info;
+        if (_stat64(path.c_str(), &info) != 0) return std::make_pair(uint64_t(0), int64_t(-1));
+        return std::make_pair(static_cast<uint64_t>(info.st_size), static_cast<int64_t>(info.st_mtime));
+    }
+#endif
+
+    FileWatcher::FileWatcher()
+        : notifyHandle(-1), wakeHandle(-1), wakeEvent(nullptr) {
+    }
+
+    FileWatcher::~FileWatcher() {
+        Stop();
+    }
+
+    bool FileWatcher::Watch(const std::string& filePath) {
+        std::string directoryPath, name;
+        SplitPath(filePath, directoryPath, name);
+        if (name.empty()) return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+#ifdef _WIN32
+        // Referência para saber, quando a pasta mudar, se foi este ficheiro
+        stamps[filePath] = FileStamp(filePath);
+#endif
+        for (Directory& directory : directories) {
+            if (directory.path == directoryPath) {
+                directory.files[name] = filePath;
+                return !directory.failed;
+            }
+        }
+        Directory directory;
+        directory.path = directoryPath;
+        directory.files[name] = filePath;
+        directories.push_back(directory);
+        if (running.load()) return AddDirectory(directories.back());
+        return true;
+    }
+
+    std::vector<std::string> FileWatcher::TakeChanges() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::string> changes;
+        changes.swap(ready);
+        readySet.clear();
+        return changes;
+    }
+
+    // Só a thread do watcher mexe em pending
+    void FileWatcher::Publish() {
+        if (pending.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const std::string& filePath : pending) {
+                if (readySet.insert(filePath).second) ready.push_back(filePath);
+            }
+        }
+        pending.clear();
+        if (callback) callback();
+    }
+
+#if defined(_WIN32)
+
+    bool FileWatcher::Start(const Callback& changed) {
+        if (running.load()) return true;
+        wakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        if (!wakeEvent) {
+            std::cerr << "Erro ao vigiar ficheiros: CreateEvent falhou (" << GetLastError() << ")" << std::endl;
+            return false;
+        }
+        callback = changed;
+        running.store(true);
+        thread = std::thread(&FileWatcher::Run, this);
+        return true;
+    }
+
+    // As notificações são criadas na thread do watcher (ver Run): aqui só se acorda
+    bool FileWatcher::AddDirectory(Directory&) {
+        SetEvent(static_cast<HANDLE>(wakeEvent));
+        return true;
+    }
+
+    void FileWatcher::Run() {
+        for (;;) {
+            // Recria a lista a cada volta: o Watch pode ter acrescentado pastas
+            std::vector<HANDLE> handles(1, static_cast<HANDLE>(wakeEvent));
+            std::vector<size_t> owners(1, 0);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = 0; i < directories.size(); ++i) {
+                    Directory& directory = directories[i];
+                    if (!directory.change && !directory.failed) {
+                        HANDLE change = FindFirstChangeNotificationA(directory.path.c_str(), FALSE,
+                            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+                        if (change == INVALID_HANDLE_VALUE) {
+                            std::cerr << "Erro ao vigiar a pasta " << directory.path << " (" << GetLastError() << ")" << std::endl;
+                            directory.failed = true;
+                            continue;
+                        }
+                        directory.change = change;
+                    }
+                    if (directory.change && handles.size() < MAXIMUM_WAIT_OBJECTS) {
+                        handles.push_back(static_cast<HANDLE>(directory.change));
+                        owners.push_back(i);
+                    }
+                }
+            }
+
+            DWORD timeout = pending.empty() ? INFINITE : QUIET_MILLISECONDS;
+            DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, timeout);
+            if (!running.load()) return;
+            if (result == WAIT_TIMEOUT) {
+                Publish();
+                continue;
+            }
+            if (result == WAIT_FAILED) {
+                std::cerr << "Erro ao esperar por alterações de ficheiros (" << GetLastError() << ")" << std::endl;
+                return;
+            }
+            size_t index = result - WAIT_OBJECT_0;
+            if (index == 0 || index >= handles.size()) continue;
+            FindNextChangeNotification(handles[index]);
+
+            // A notificação só diz que a pasta mudou: compara o tamanho/data dos vigiados
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& file : directories[owners[index]].files) {
+                std::pair<uint64_t, int64_t> stamp = FileStamp(file.second);
+                std::pair<uint64_t, int64_t>& known = stamps[file.second];
+                if (stamp != known) {
+                    known = stamp;
+                    if (stamp.second >= 0) pending.push_back(file.second);
+                }
+            }
+        }
+    }
+
+    void FileWatcher::Stop() {
+        if (!running.exchange(false)) return;
+        SetEvent(static_cast<HANDLE>(wakeEvent));
+        thread.join();
+        for (Directory& directory : directories) {
+            if (directory.change) FindCloseChangeNotification(static_cast<HANDLE>(directory.change));
+            directory.change = nullptr;
+        }
+        CloseHandle(static_cast<HANDLE>(wakeEvent));
+        wakeEvent = nullptr;
+    }
+
+#elif defined(__linux__)
+
+    bool FileWatcher::Start(const Callback& changed) {
+        if (running.load()) return true;
+        notifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wakeHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (notifyHandle < 0 || wakeHandle < 0) {
+            std::cerr << "Erro ao vigiar ficheiros: " << std::strerror(errno) << std::endl;
+            if (notifyHandle >= 0) close(notifyHandle);
+            if (wakeHandle >= 0) close(wakeHandle);
+            notifyHandle = wakeHandle = -1;
+            return false;
+        }
+        callback = changed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Directory& directory : directories) AddDirectory(directory);
+        }
+        running.store(true);
+        thread = std::thread(&FileWatcher::Run, this);
+        return true;
+    }
+
+    // Com o mutex
+    bool FileWatcher::AddDirectory(Directory& directory) {
+        // Escrita terminada ou ficheiro gravado por cima com rename (a maioria dos editores)
+        directory.watch = inotify_add_watch(notifyHandle, directory.path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (directory.watch < 0) {
+            std::cerr << "Erro ao vigiar a pasta " << directory.path << ": " << std::strerror(errno) << std::endl;
+            directory.failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    void FileWatcher::Run() {
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            pollfd handles[2] = { { notifyHandle, POLLIN, 0 }, { wakeHandle, POLLIN, 0 } };
+            int result = poll(handles, 2, pending.empty() ? -1 : QUIET_MILLISECONDS);
+            if (!running.load()) return;
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Erro ao esperar por alterações de ficheiros: " << std::strerror(errno) << std::endl;
+                return;
+            }
+            if (result == 0) {
+                Publish();
+                continue;
+            }
+            if (!(handles[0].revents & POLLIN)) continue;
+
+            for (;;) {
+                ssize_t length = read(notifyHandle, buffer, sizeof(buffer));
+                if (length <= 0) break;
+                std::lock_guard<std::mutex> lock(mutex);
+                for (ssize_t offset = 0; offset < length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+                    if (event->len == 0) continue;
+                    for (const Directory& directory : directories) {
+                        if (directory.watch != event->wd) continue;
+                        auto file = directory.files.find(event->name);
+                        if (file != directory.files.end()) pending.push_back(file->second);
+                    }
+                }
+            }
+        }
+    }
+
+    void FileWatcher::Stop() {
+        if (!running.exchange(false)) return;
+        uint64_t one = 1;
+        if (write(wakeHandle, &one, sizeof(one)) < 0) {
+            // O eventfd não enche com um só valor; sem ele o poll não acordava
+            std::cerr << "Erro ao parar a vigia de ficheiros: " << std::strerror(errno) << std::endl;
+        }
+        thread.join();
+        close(notifyHandle);
+        close(wakeHandle);
+        notifyHandle = wakeHandle = -1;
+        for (Directory& directory : directories) directory.watch = -1;
+    }
+
+#else
+
+    bool FileWatcher::Start(const Callback&) {
+        std::cerr << "Erro ao vigiar ficheiros: nao suportado neste sistema" << std::endl;
+        return false;
+    }
+
+    bool FileWatcher::AddDirectory(Directory&) {
+        return false;
+    }
+
+    void FileWatcher::Run() {
+    }
+
+    void FileWatcher::Stop() {
+    }
+
+#endif
+
+} // namespace P3D
@@ -0,0 +1,73 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace P3D {
+
+    // Vigia ficheiros numa thread própria: inotify no Linux (IN_CLOSE_WRITE/IN_MOVED_TO,
+    // ou seja, escritas terminadas e gravações por rename), FindFirstChangeNotification no
+    // Windows (com o tamanho/data de cada ficheiro para saber qual mudou). Na prática vigia
+    // as pastas e filtra pelos nomes pedidos. As alterações seguidas de um mesmo ficheiro
+    // (editores que gravam em vários passos) são juntadas numa só.
+    class FileWatcher {
+    public:
+        typedef std::function<void()> Callback;
+
+        FileWatcher();
+        ~FileWatcher();
+
+        // Pode ser chamado antes ou depois do Start, de qualquer thread
+        bool Watch(const std::string& filePath);
+        // changed corre na thread do watcher quando há alterações por recolher (ex.:
+        // glfwPostEmptyEvent para acordar o loop principal)
+        bool Start(const Callback& changed);
+        void Stop();
+
+        // Ficheiros alterados desde a última chamada, com o caminho dado ao Watch e sem repetidos
+        std::vector<std::string> TakeChanges();
+
+    private:
+        struct Directory {
+            std::string path;
+            int watch = -1;                 // inotify: descritor da vigia
+            void* change = nullptr;         // Windows: FindFirstChangeNotification
+            bool failed = false;
+            std::unordered_map<std::string, std::string> files;    // nome -> caminho do Watch
+        };
+
+        std::mutex mutex;
+        std::vector<Directory> directories;
+        std::vector<std::string> pending;   // à espera que o ficheiro acalme
+        std::vector<std::string> ready;
+        std::unordered_set<std::string> readySet;
+        Callback callback;
+        std::thread thread;
+        std::atomic<bool> running{ false };
+
+        // Linux: o inotify e um eventfd para acordar a thread no Stop
+        int notifyHandle;
+        int wakeHandle;
+        // Windows: evento para o Stop e para as pastas novas, e o tamanho/data de cada ficheiro
+        void* wakeEvent;
+        std::unordered_map<std::string, std::pair<uint64_t, int64_t>> stamps;
+
+        void Run();
+        bool AddDirectory(Directory& directory);
+        void Publish();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // FILEWATCHER_H
@@ -0,0 +1,111 @@
+#include "FrameCompare.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace P3D {
+
+    bool ReadPPM(const std::string& filePath, Image& image) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        std::string magic;
+        int width = 0, height = 0, maxValue = 0;
+        file >> magic >> width >> height >> maxValue;
+        file.get();     // um espaço em branco antes dos dados
+        if (!file || magic != "P6" || maxValue != 255 || width <= 0 || height <= 0) {
+            std::cerr << "Formato PPM invalido: " << filePath << std::endl;
+            return false;
+        }
+
+        std::vector<char> rgb(static_cast<size_t>(width) * height * 3);
+        if (!file.read(rgb.data(), rgb.size())) return false;
+
+        image.width = width;
+        image.height = height;
+        image.rgba.resize(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0, count = static_cast<size_t>(width) * height; i < count; ++i) {
+            image.rgba[i * 4 + 0] = static_cast<unsigned char>(rgb[i * 3 + 0]);
+            image.rgba[i * 4 + 1] = static_cast<unsigned char>(rgb[i * 3 + 1]);
+            image.rgba[i * 4 + 2] = static_cast<unsigned char>(rgb[i * 3 + 2]);
+            image.rgba[i * 4 + 3] = 255;
+        }
+        return true;
+    }
+
+    // sRGB 8 bits -> CIE L*a*b* (iluminante D65)
+    struct Lab {
+        float L, a, b;
+    };
+
+    static float SRGBToLinear(unsigned char c) {
+        float v = c / 255.0f;
+        return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float LabF(float t) {
+        return t > 0.008856f ? std::cbrt(t) : 7.787f * t + 16.0f / 116.0f;
+    }
+
+    static Lab ToLab(const unsigned char* rgb, const float* linear) {
+        float r = linear[rgb[0]], g = linear[rgb[1]], b = linear[rgb[2]];
+        float x = (0.4124f * r + 0.3576f * g + 0.1805f * b) / 0.95047f;
+        float y = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+        float z = (0.0193f * r + 0.1192f * g + 0.9505f * b) / 1.08883f;
+        float fx = LabF(x), fy = LabF(y), fz = LabF(z);
+        Lab lab;
+        lab.L = 116.0f * fy - 16.0f;
+        lab.a = 500.0f * (fx - fy);
+        lab.b = 200.0f * (fy - fz);
+        return lab;
+    }
+
+    CompareResult CompareImages(const Image& reference, const Image& candidate,
+        const CompareTolerance& tolerance, Image* diff) {
+        CompareResult result;
+        result.sizeMatches = reference.width == candidate.width && reference.height == candidate.height &&
+            !reference.rgba.empty() && reference.rgba.size() == candidate.rgba.size();
+        if (!result.sizeMatches) return result;
+
+        float linear[256];
+        for (int i = 0; i < 256; ++i) linear[i] = SRGBToLinear(static_cast<unsigned char>(i));
+
+        const size_t count = static_cast<size_t>(reference.width) * reference.height;
+        if (diff) {
+            diff->width = reference.width;
+            diff->height = reference.height;
+            diff->rgba.resize(count * 4);
+        }
+
+        double sum = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            const unsigned char* p = &reference.rgba[i * 4];
+            const unsigned char* q = &candidate.rgba[i * 4];
+            float deltaE = 0.0f;
+            if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2]) {
+                Lab a = ToLab(p, linear), b = ToLab(q, linear);
+                float dL = a.L - b.L, da = a.a - b.a, db = a.b - b.b;
+                deltaE = std::sqrt(dL * dL + da * da + db * db);
+            }
+            sum += deltaE;
+            if (deltaE > result.maxDeltaE) result.maxDeltaE = deltaE;
+
+            bool different = deltaE > tolerance.pixelDeltaE;
+            if (different) result.differentPixels++;
+
+            if (diff) {
+                unsigned char gray = static_cast<unsigned char>((p[0] * 54 + p[1] * 183 + p[2] * 19) >> 8);
+                unsigned char* out = &diff->rgba[i * 4];
+                out[0] = different ? 255 : gray;
+                out[1] = different ? 0 : gray;
+                out[2] = different ? 0 : gray;
+                out[3] = 255;
+            }
+        }
+        result.differentFraction = static_cast<float>(result.differentPixels) / count;
+        result.meanDeltaE = static_cast<float>(sum / count);
+        return result;
+    }
+
+} // namespace P3D
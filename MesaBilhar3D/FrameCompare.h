@@ -0,0 +1,46 @@
+#ifndef FRAMECOMPARE_H
+#define FRAMECOMPARE_H
+
+#include <string>
+#include <vector>
+
+namespace P3D {
+
+    // Imagem RGBA8, primeira linha = topo (como RenderBackend::ReadPixels)
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> rgba;
+    };
+
+    // Lê um PPM binário (P6, 8 bits) gravado por WritePPM
+    bool ReadPPM(const std::string& filePath, Image& image);
+
+    // Limites da comparação perceptual: diferença de cor CIE76 (delta E em L*a*b*)
+    struct CompareTolerance {
+        float pixelDeltaE = 5.0f;           // acima disto o pixel conta como diferente (~2 JND)
+        float maxDifferentFraction = 0.001f; // fração de pixels diferentes aceite
+        float maxMeanDeltaE = 0.5f;          // média de delta E na imagem inteira
+    };
+
+    struct CompareResult {
+        bool sizeMatches = false;
+        unsigned int differentPixels = 0;
+        float differentFraction = 0.0f;
+        float meanDeltaE = 0.0f;
+        float maxDeltaE = 0.0f;
+
+        bool Passed(const CompareTolerance& tolerance) const {
+            return sizeMatches && differentFraction <= tolerance.maxDifferentFraction &&
+                meanDeltaE <= tolerance.maxMeanDeltaE;
+        }
+    };
+
+    // Compara em L*a*b* (sRGB D65). Se diff não for nullptr, recebe um mapa de diferenças:
+    // a imagem de referência em cinzento com os pixels acima do limite a vermelho.
+    CompareResult CompareImages(const Image& reference, const Image& candidate,
+        const CompareTolerance& tolerance, Image* diff = nullptr);
+
+} // namespace P3D
+
+#endif // FRAMECOMPARE_H
@@ -0,0 +1,96 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include "FrameScheduler.h"
+
+#include <GLFW/glfw3.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace P3D {
+
+    double ProcessCpuSeconds() {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+        // Unidades de 100 ns
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        return static_cast<double>(k.QuadPart + u.QuadPart) * 1e-7;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+            (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+    }
+
+    FrameScheduler::FrameScheduler(bool enabled)
+        : onDemand(enabled), dirty(true), animationEnd(0.0),
+        frames(0), wakeups(0), sampleTime(-1.0), sampleCpuSeconds(0.0)
+    {
+    }
+
+    void FrameScheduler::SetOnDemand(bool enabled) {
+        onDemand = enabled;
+        dirty = true;
+    }
+
+    void FrameScheduler::RequestAnimation(double now, double seconds) {
+        if (now + seconds > animationEnd) animationEnd = now + seconds;
+    }
+
+    bool FrameScheduler::NeedsFrame(double now) const {
+        return !onDemand || dirty || now < animationEnd;
+    }
+
+    void FrameScheduler::FrameRendered() {
+        dirty = false;
+        ++frames;
+    }
+
+    void FrameScheduler::ProcessEvents(double wakeTime) {
+        ++wakeups;
+        double now = glfwGetTime();
+        if (NeedsFrame(now)) {
+            glfwPollEvents();
+            return;
+        }
+        // Acorda com o primeiro evento ou em wakeTime, o que vier antes
+        double timeout = wakeTime - now;
+        if (timeout > 0.0) glfwWaitEventsTimeout(timeout);
+        else glfwPollEvents();
+    }
+
+    bool FrameScheduler::SampleStats(double now, double interval, SchedulerStats& stats) {
+        if (sampleTime < 0.0) {
+            sampleTime = now;
+            sampleCpuSeconds = ProcessCpuSeconds();
+            return false;
+        }
+        if (now - sampleTime < interval) return false;
+
+        double cpuSeconds = ProcessCpuSeconds();
+
+        stats.seconds = now - sampleTime;
+        stats.frames = frames;
+        stats.wakeups = wakeups;
+        stats.cpuPercent = 100.0 * (cpuSeconds - sampleCpuSeconds) / stats.seconds;
+        stats.idle = !NeedsFrame(now);
+
+        frames = wakeups = 0;
+        sampleTime = now;
+        sampleCpuSeconds = cpuSeconds;
+        return true;
+    }
+
+} // namespace P3D
@@ -0,0 +1,62 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+namespace P3D {
+
+    // Atividade do loop principal num intervalo (ver FrameScheduler::SampleStats)
+    struct SchedulerStats {
+        double seconds = 0.0;
+        unsigned int frames = 0;
+        unsigned int wakeups = 0;       // vezes que o loop acordou (eventos, timeout ou frame)
+        double cpuPercent = 0.0;        // tempo de CPU do processo / tempo real, em %
+        bool idle = false;              // nenhum frame pendente no fim do intervalo
+
+        double FramesPerSecond() const { return seconds > 0.0 ? frames / seconds : 0.0; }
+        double WakeupsPerSecond() const { return seconds > 0.0 ? wakeups / seconds : 0.0; }
+    };
+
+    // Decide quando o loop principal desenha. Em modo on-demand só há frame depois de
+    // Invalidate (input, janela exposta/redimensionada, mudança na cena) ou enquanto houver
+    // uma animação/simulação pedida com RequestAnimation; sem nada pendente o loop dorme em
+    // glfwWaitEventsTimeout em vez de desenhar as duas vistas sem parar. Em modo contínuo
+    // desenha sempre, como antes. Os tempos são os do glfwGetTime.
+    class FrameScheduler {
+    public:
+        explicit FrameScheduler(bool onDemand = true);
+
+        void SetOnDemand(bool enabled);
+        bool IsOnDemand() const { return onDemand; }
+
+        // Algo visível mudou: desenha no próximo ciclo
+        void Invalidate() { dirty = true; }
+        // Desenha à cadência máxima até now + seconds (ex.: bolas em movimento)
+        void RequestAnimation(double now, double seconds);
+
+        bool NeedsFrame(double now) const;
+        // Depois do glfwSwapBuffers
+        void FrameRendered();
+
+        // Processa os eventos da janela: glfwPollEvents se há um frame pendente, senão
+        // espera por eventos até wakeTime (ex.: a próxima atualização do título)
+        void ProcessEvents(double wakeTime);
+
+        // Estatísticas desde a última amostra; falso (e nada muda) antes de passar interval
+        bool SampleStats(double now, double interval, SchedulerStats& stats);
+
+    private:
+        bool onDemand;
+        bool dirty;
+        double animationEnd;
+
+        unsigned int frames;
+        unsigned int wakeups;
+        double sampleTime;
+        double sampleCpuSeconds;
+    };
+
+    // Tempo de CPU (utilizador + sistema) gasto pelo processo até agora, em segundos
+    double ProcessCpuSeconds();
+
+} // namespace P3D
+
+#endif // FRAMESCHEDULER_H
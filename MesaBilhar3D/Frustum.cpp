@@ -0,0 +1,151 @@
+#include "Frustum.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define P3D_FRUSTUM_SSE 1
+#endif
+
+namespace P3D {
+
+    Bounds ComputeBounds(const void* positions, size_t count, size_t stride) {
+        Bounds bounds;
+        if (count == 0) return bounds;
+
+        const unsigned char* base = static_cast<const unsigned char*>(positions);
+        const glm::vec3& first = *reinterpret_cast<const glm::vec3*>(base);
+        bounds.box.min = first;
+        bounds.box.max = first;
+        for (size_t i = 1; i < count; ++i) {
+            const glm::vec3& p = *reinterpret_cast<const glm::vec3*>(base + i * stride);
+            bounds.box.min = glm::min(bounds.box.min, p);
+            bounds.box.max = glm::max(bounds.box.max, p);
+        }
+
+        // Centro da AABB e maior distância a esse centro
+        bounds.sphere.center = (bounds.box.min + bounds.box.max) * 0.5f;
+        float maxDist2 = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 d = *reinterpret_cast<const glm::vec3*>(base + i * stride) - bounds.sphere.center;
+            float dist2 = glm::dot(d, d);
+            if (dist2 > maxDist2) maxDist2 = dist2;
+        }
+        bounds.sphere.radius = std::sqrt(maxDist2);
+        return bounds;
+    }
+
+    BoundingSphere TransformSphere(const BoundingSphere& sphere, const glm::mat4& model) {
+        BoundingSphere result;
+        result.center = glm::vec3(model * glm::vec4(sphere.center, 1.0f));
+
+        float sx = glm::length(glm::vec3(model[0]));
+        float sy = glm::length(glm::vec3(model[1]));
+        float sz = glm::length(glm::vec3(model[2]));
+        float scale = sx > sy ? (sx > sz ? sx : sz) : (sy > sz ? sy : sz);
+        result.radius = sphere.radius * scale;
+        return result;
+    }
+
+    AABB TransformAABB(const AABB& box, const glm::mat4& model) {
+        AABB result;
+        for (int i = 0; i < 8; ++i) {
+            glm::vec3 corner((i & 1) ? box.max.x : box.min.x,
+                (i & 2) ? box.max.y : box.min.y,
+                (i & 4) ? box.max.z : box.min.z);
+            glm::vec3 p = glm::vec3(model * glm::vec4(corner, 1.0f));
+            result.min = (i == 0) ? p : glm::min(result.min, p);
+            result.max = (i == 0) ? p : glm::max(result.max, p);
+        }
+        return result;
+    }
+
+    void Frustum::Extract(const glm::mat4& m) {
+        // Linhas da matriz (glm guarda por colunas)
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        planes[0] = row3 + row0; // esquerda
+        planes[1] = row3 - row0; // direita
+        planes[2] = row3 + row1; // baixo
+        planes[3] = row3 - row1; // cima
+        planes[4] = row3 + row2; // perto
+        planes[5] = row3 - row2; // longe
+
+        for (int i = 0; i < 6; ++i) {
+            float len = glm::length(glm::vec3(planes[i]));
+            if (len > 0.0f) planes[i] /= len;
+
+            planeX[i] = planes[i].x;
+            planeY[i] = planes[i].y;
+            planeZ[i] = planes[i].z;
+            planeW[i] = planes[i].w;
+        }
+        for (int i = 6; i < 8; ++i) {
+            planeX[i] = planeY[i] = planeZ[i] = 0.0f;
+            planeW[i] = 1.0f;
+        }
+    }
+
+    bool Frustum::TestSphere(const BoundingSphere& sphere) const {
+        for (int i = 0; i < 6; ++i) {
+            float d = glm::dot(glm::vec3(planes[i]), sphere.center) + planes[i].w;
+            if (d < -sphere.radius) return false;
+        }
+        return true;
+    }
+
+    bool Frustum::TestAABB(const AABB& box) const {
+        for (int i = 0; i < 6; ++i) {
+            // Vértice da caixa mais avançado na direção da normal do plano
+            glm::vec3 p(planes[i].x >= 0.0f ? box.max.x : box.min.x,
+                planes[i].y >= 0.0f ? box.max.y : box.min.y,
+                planes[i].z >= 0.0f ? box.max.z : box.min.z);
+            if (glm::dot(glm::vec3(planes[i]), p) + planes[i].w < 0.0f) return false;
+        }
+        return true;
+    }
+
+    size_t Frustum::CullSpheres(const BoundingSphere* spheres, size_t count, unsigned char* visible,
+        CullStats* stats) const {
+        size_t visibleCount = 0;
+
+#ifdef P3D_FRUSTUM_SSE
+        const __m128 px0 = _mm_load_ps(planeX), px1 = _mm_load_ps(planeX + 4);
+        const __m128 py0 = _mm_load_ps(planeY), py1 = _mm_load_ps(planeY + 4);
+        const __m128 pz0 = _mm_load_ps(planeZ), pz1 = _mm_load_ps(planeZ + 4);
+        const __m128 pw0 = _mm_load_ps(planeW), pw1 = _mm_load_ps(planeW + 4);
+
+        for (size_t i = 0; i < count; ++i) {
+            const BoundingSphere& s = spheres[i];
+            const __m128 cx = _mm_set1_ps(s.center.x);
+            const __m128 cy = _mm_set1_ps(s.center.y);
+            const __m128 cz = _mm_set1_ps(s.center.z);
+            const __m128 negR = _mm_set1_ps(-s.radius);
+
+            // Distância do centro a 4 planos de cada vez
+            __m128 d0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px0, cx), _mm_mul_ps(py0, cy)),
+                _mm_add_ps(_mm_mul_ps(pz0, cz), pw0));
+            __m128 d1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px1, cx), _mm_mul_ps(py1, cy)),
+                _mm_add_ps(_mm_mul_ps(pz1, cz), pw1));
+
+            int outside = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(d0, negR), _mm_cmplt_ps(d1, negR)));
+            visible[i] = outside ? 0 : 1;
+            visibleCount += visible[i];
+        }
+#else
+        for (size_t i = 0; i < count; ++i) {
+            visible[i] = TestSphere(spheres[i]) ? 1 : 0;
+            visibleCount += visible[i];
+        }
+#endif
+
+        if (stats) {
+            stats->tested += static_cast<unsigned int>(count);
+            stats->visible += static_cast<unsigned int>(visibleCount);
+        }
+        return visibleCount;
+    }
+
+} // namespace P3D
@@ -0,0 +1,67 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace P3D {
+
+    struct AABB {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+    };
+
+    struct BoundingSphere {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+    };
+
+    // Volumes envolventes calculados no carregamento de cada malha
+    struct Bounds {
+        AABB box;
+        BoundingSphere sphere;
+    };
+
+    // positions aponta para o primeiro vec3; stride em bytes entre vértices consecutivos
+    Bounds ComputeBounds(const void* positions, size_t count, size_t stride);
+
+    // Esfera em coordenadas de mundo (o raio acompanha a maior escala da matriz)
+    BoundingSphere TransformSphere(const BoundingSphere& sphere, const glm::mat4& model);
+    // AABB em coordenadas de mundo que contém os 8 cantos transformados
+    AABB TransformAABB(const AABB& box, const glm::mat4& model);
+
+    // Estatísticas de culling de um passo de render (vista principal, minimapa, ...)
+    struct CullStats {
+        unsigned int tested = 0;
+        unsigned int visible = 0;
+
+        unsigned int Culled() const { return tested - visible; }
+        void Reset() { tested = visible = 0; }
+    };
+
+    class Frustum {
+    public:
+        // Planos de Gribb/Hartmann a partir de projection * view
+        void Extract(const glm::mat4& viewProjection);
+
+        bool TestSphere(const BoundingSphere& sphere) const;
+        bool TestAABB(const AABB& box) const;
+
+        // Testa count esferas (SSE: 4 planos por instrução); visible[i] = 1 se visível.
+        // Devolve o número de esferas visíveis e acumula em stats se dado.
+        size_t CullSpheres(const BoundingSphere* spheres, size_t count, unsigned char* visible,
+            CullStats* stats = nullptr) const;
+
+    private:
+        glm::vec4 planes[6];
+
+        // Mesmos planos em SoA, com 2 planos neutros (0,0,0,1) para completar 8
+        alignas(16) float planeX[8];
+        alignas(16) float planeY[8];
+        alignas(16) float planeZ[8];
+        alignas(16) float planeW[8];
+    };
+
+} // namespace P3D
+
+#endif // FRUSTUM_H
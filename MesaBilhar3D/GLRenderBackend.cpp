@@ -0,0 +1,452 @@
+#include "GLRenderBackend.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "ShaderCache.h"
+#include "StartupTrace.h"
+#include "TextureCache.h"
+
+namespace P3D {
+
+    // Shader da geometria estática - o cabeçalho (#version + DRAW_ID) vem de StaticBatch::ShaderHeader
+    static const char* staticVertexShaderBody = R"(
+layout(location=0) in vec3 position;
+layout(location=1) in vec2 texcoord;
+layout(location=2) in vec3 normal;
+
+struct DrawData {
+    mat4 model;
+    vec4 color;
+};
+
+layout(std140) uniform StaticDraws {
+    DrawData draws[128];
+};
+
+out vec3 vNormal;
+out vec4 vColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main(){
+    mat4 model = draws[DRAW_ID].model;
+    gl_Position = projection * view * model * vec4(position,1.0);
+    vNormal = mat3(model) * normal;
+    vColor = draws[DRAW_ID].color;
+}
+)";
+
+    static const char* staticFragmentShaderSource = R"(
+#version 330 core
+in vec3 vNormal;
+in vec4 vColor;
+out vec4 FragColor;
+
+void main(){
+    float diffuse = max(dot(normalize(vNormal), normalize(vec3(0.3,1.0,0.5))), 0.0);
+    FragColor = vec4(vColor.rgb * (0.3 + 0.7 * diffuse), vColor.a);
+}
+)";
+
+    // Shader das bolas (textura + iluminação difusa simples)
+    static const char* ballVertexShaderSource = R"(
+#version 330 core
+layout(location=0) in vec3 position;
+layout(location=1) in vec2 texcoord;
+layout(location=2) in vec3 normal;
+
+out vec2 vTexCoord;
+out vec3 vNormal;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main(){
+    gl_Position = projection * view * model * vec4(position,1.0);
+    vTexCoord = texcoord;
+    vNormal = mat3(model) * normal;
+}
+)";
+
+    static const char* ballFragmentShaderSource = R"(
+#version 330 core
+in vec2 vTexCoord;
+in vec3 vNormal;
+out vec4 FragColor;
+
+uniform sampler2D diffuseMap;
+
+void main(){
+    float diffuse = max(dot(normalize(vNormal), normalize(vec3(0.3,1.0,0.5))), 0.0);
+    FragColor = vec4(texture(diffuseMap, vTexCoord).rgb * (0.3 + 0.7 * diffuse), 1.0);
+}
+)";
+
+    // Profundidade normalizada (0 = câmara, 1 = plano far) para a chave de ordenação
+    static float SortDepth(const glm::mat4& view, const glm::vec3& position, float farPlane) {
+        return -(view * glm::vec4(position, 1.0f)).z / farPlane;
+    }
+
+    static void SetCameraUniforms(GLuint program, const Camera& camera) {
+        glUseProgram(program);
+        glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, &camera.view[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, &camera.projection[0][0]);
+    }
+
+    GLRenderBackend::GLRenderBackend(BallRenderMode mode)
+        : ballMode(mode), staticProgram(0), ballProgram(0), impostorProgram(0),
+        staticRequest(-1), ballRequest(-1), impostorRequest(-1),
+        dynamicResolution(false), outputFramebuffer(0), clearColor(0.0f), lastGpuMs(-1.0f), width(0), height(0)
+    {
+    }
+
+    GLRenderBackend::~GLRenderBackend() {
+    }
+
+    void GLRenderBackend::EnableDynamicResolution(const DynamicResolutionSettings& settings) {
+        dynamicResolution = true;
+        resolution.SetSettings(settings);
+    }
+
+    bool GLRenderBackend::SettleResolution() {
+        if (!UsesDynamicResolution() || resolution.GetScale() >= resolution.GetSettings().maxScale) return false;
+        resolution.ResetToMaxScale();
+        return true;
+    }
+
+    bool GLRenderBackend::Init(const Scene& scene, int w, int h) {
+        width = w;
+        height = h;
+
+        GLint framebuffer = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+        outputFramebuffer = static_cast<GLuint>(framebuffer);
+        if (dynamicResolution) {
+            // Sem alvo fica a resolução fixa; sem timer a escala segue o tempo de CPU
+            if (sceneTarget.Create(width, height)) gpuTimer.Create();
+        }
+
+        // Os ficheiros das bolas são todos pedidos já: ficam a ser lidos enquanto se monta
+        // o lote estático e se submetem os shaders, e o grafo usa-os à medida que chegam
+        FileBatch files;
+        TextureCache& textureCache = TextureCache::Instance();
+        for (const BallObject& ball : scene.balls) {
+            if (ballMode == BallRenderMode::Mesh) files.Add(ball.mtlFilePath);
+            textureCache.AddReads(ball.textureFilePath, files);
+        }
+        files.Submit();
+
+        // Geometria estática num único buffer, desenhada com um glMultiDrawElementsIndirect
+        TraceScope batchScope("lote-estatico");
+        std::vector<int> meshIDs;
+        for (const SceneMesh& mesh : scene.meshes) {
+            meshIDs.push_back(staticBatch.AddMesh(mesh.vertices, mesh.indices));
+            batchScope.AddBytes(mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int));
+        }
+        for (const StaticObject& object : scene.statics) {
+            staticBatch.AddDraw(meshIDs[object.mesh], object.model, object.color);
+        }
+        staticBatch.Build();
+        batchScope.End();
+
+        // Os programas são todos submetidos antes de carregar as bolas: com
+        // KHR_parallel_shader_compile o driver compila-os enquanto as texturas são lidas
+        ShaderCache& shaders = ShaderCache::Instance();
+        std::string staticVertexShaderSource = std::string(staticBatch.ShaderHeader()) + staticVertexShaderBody;
+        staticRequest = shaders.Request("estatica", staticVertexShaderSource.c_str(), staticFragmentShaderSource);
+        if (ballMode == BallRenderMode::Impostor) {
+            impostorRequest = shaders.Request("bola-impostor", BallImpostors::VertexShaderSource(), BallImpostors::FragmentShaderSource());
+        }
+        else {
+            ballRequest = shaders.Request("bola", ballVertexShaderSource, ballFragmentShaderSource);
+        }
+
+        // Bolas carregadas num grafo de tarefas: .mtl e descodificação das texturas no pool,
+        // envios para a GPU aqui, à medida que cada bola fica pronta
+        TaskGraph graph;
+        std::vector<int> loaded(scene.balls.size(), -1);
+        std::vector<std::unique_ptr<Model>> loading(scene.balls.size());
+        std::vector<GLuint> textures(scene.balls.size(), 0);
+        if (ballMode == BallRenderMode::Impostor) {
+            impostors.Create();
+
+            // Só a textura de cada bola
+            for (size_t i = 0; i < scene.balls.size(); ++i) {
+                std::shared_ptr<PreparedTexture> prepared = std::make_shared<PreparedTexture>();
+                const std::string filePath = scene.balls[i].textureFilePath;
+                FileBatch* batch = &files;
+                int decode = graph.Add("bola.textura", TaskQueue::Worker, [prepared, filePath, batch]() {
+                    TextureCache::Instance().Prepare(filePath, *prepared, batch);
+                    return true;
+                });
+                GLuint* texture = &textures[i];
+                loaded[i] = graph.Add("bola.enviar-textura", TaskQueue::GLThread, [prepared, texture]() {
+                    *texture = TextureCache::Instance().Acquire(*prepared);
+                    return *texture != 0;
+                }, { decode });
+            }
+        }
+        else {
+            // Esfera paramétrica + material de cada bola. As colisões entre bolas são
+            // analíticas (centro e raio): depois do envio não é preciso guardar a malha.
+            for (size_t i = 0; i < scene.balls.size(); ++i) {
+                loading[i].reset(new Model());
+                loading[i]->SetResidency(MeshResidency::BoundsOnly);
+                loaded[i] = loading[i]->AddSphereTasks(graph, scene.balls[i].mtlFilePath, scene.balls[i].radius, &files);
+            }
+        }
+        graph.Run([this]() {
+            if (HasPendingPrograms()) ResolvePrograms(false);
+        });
+        loadStats = graph.GetStats();
+        files.WaitAll();
+        loadFileStats = files.GetStats();
+
+        // Pela ordem da cena; as que falharam são ignoradas
+        for (size_t i = 0; i < scene.balls.size(); ++i) {
+            if (!graph.Succeeded(loaded[i])) continue;
+            ballSources.push_back(scene.balls[i]);
+            if (ballMode == BallRenderMode::Impostor) {
+                impostorBalls.push_back(scene.balls[i]);
+                impostorTextures.push_back(textures[i]);
+            }
+            else {
+                balls.push_back(std::move(loading[i]));
+                ballPositions.push_back(scene.balls[i].position);
+            }
+        }
+
+        // Os que ainda não estiverem prontos entram nos próximos RenderPass
+        ResolvePrograms(false);
+
+        glEnable(GL_DEPTH_TEST);
+        return true;
+    }
+
+    void GLRenderBackend::GetMemoryReport(std::vector<AssetMemory>& report) const {
+        report.push_back(staticBatch.GetMemory("lote-estatico"));
+        for (size_t i = 0; i < balls.size(); ++i) {
+            const std::string& mtlFilePath = ballSources[i].mtlFilePath;
+            report.push_back(balls[i]->GetMemory(mtlFilePath.substr(mtlFilePath.find_last_of("/\\") + 1)));
+        }
+        TextureCache::Instance().AppendMemory(report);
+    }
+
+    // Recolhe os programas que o driver já terminou (todos, se wait) e configura-os
+    bool GLRenderBackend::ResolvePrograms(bool wait) {
+        ShaderCache& shaders = ShaderCache::Instance();
+        if (staticRequest >= 0 && (wait || shaders.Poll(staticRequest))) {
+            staticProgram = shaders.Finish(staticRequest);
+            if (staticProgram) staticBatch.SetupProgram(staticProgram);
+            staticRequest = -1;
+        }
+        int* ballRequests[2] = { &ballRequest, &impostorRequest };
+        GLuint* ballPrograms[2] = { &ballProgram, &impostorProgram };
+        for (int i = 0; i < 2; ++i) {
+            int& request = *ballRequests[i];
+            GLuint& program = *ballPrograms[i];
+            if (request < 0 || !(wait || shaders.Poll(request))) continue;
+            program = shaders.Finish(request);
+            if (program) {
+                glUseProgram(program);
+                glUniform1i(glGetUniformLocation(program, "diffuseMap"), 0);
+            }
+            request = -1;
+        }
+        return !HasPendingPrograms();
+    }
+
+    void GLRenderBackend::WaitForPrograms() {
+        ResolvePrograms(true);
+    }
+
+    bool GLRenderBackend::EnableHotReload(const std::function<void()>& wake) {
+        return reloader.Start(ballSources, wake);
+    }
+
+    bool GLRenderBackend::ApplyReloads() {
+        bool changed = false;
+        for (MaterialReload& reload : reloader.Poll()) {
+            if (reload.failed) continue;
+            GLuint texture = TextureCache::Instance().Acquire(reload.texture);
+            if (!texture) continue;
+            // A bola só passa a usar o material novo aqui, com o frame anterior terminado
+            if (ballMode == BallRenderMode::Impostor) {
+                TextureCache::Instance().Release(impostorTextures[reload.ball]);
+                impostorTextures[reload.ball] = texture;
+            }
+            else {
+                balls[reload.ball]->ApplyMaterial(reload.mtlChanged ? &reload.material : nullptr, texture);
+            }
+            reloader.Commit(reload);
+            ballSources[reload.ball].textureFilePath = reload.textureFilePath;
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - reload.detected).count();
+            std::printf("Recarregado: %s (bola %u, %.1f ms)\n", reload.mtlChanged ? ballSources[reload.ball].mtlFilePath.c_str() :
+                reload.textureFilePath.c_str(), static_cast<unsigned int>(reload.ball + 1), milliseconds);
+            changed = true;
+        }
+        return changed;
+    }
+
+    void GLRenderBackend::Shutdown() {
+        reloader.Stop();
+        // Pedidos ainda por recolher: o ShaderCache só apaga os shaders no Finish
+        WaitForPrograms();
+        staticBatch.Destroy();
+        balls.clear();
+        ballPositions.clear();
+        impostors.Destroy();
+        sceneTarget.Destroy();
+        gpuTimer.Destroy();
+        for (GLuint texture : impostorTextures) TextureCache::Instance().Release(texture);
+        impostorTextures.clear();
+        impostorBalls.clear();
+        ballSources.clear();
+        if (staticProgram) glDeleteProgram(staticProgram);
+        if (ballProgram) glDeleteProgram(ballProgram);
+        if (impostorProgram) glDeleteProgram(impostorProgram);
+        staticProgram = ballProgram = impostorProgram = 0;
+        // As texturas sem referências continuam residentes na cache: têm de sair enquanto o
+        // contexto existe (o singleton só é destruído depois da janela)
+        TextureCache::Instance().Clear();
+    }
+
+    void GLRenderBackend::BeginFrame(const glm::vec4& color) {
+        frameStart = std::chrono::steady_clock::now();
+        gpuTimer.Begin();
+        staticBatch.BeginFrame();
+
+        clearColor = color;
+        glViewport(0, 0, width, height);
+        glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    // Acrescenta à fila as bolas visíveis no frustum; lowestLOD força o nível mais simples (minimapa)
+    void GLRenderBackend::QueueBalls(const Camera& camera, int viewportHeight, bool lowestLOD,
+        const Frustum& frustum, CullStats& stats) {
+        std::vector<BoundingSphere> spheres(balls.size());
+        std::vector<unsigned char> visible(balls.size());
+        for (size_t i = 0; i < balls.size(); ++i) {
+            spheres[i] = balls[i]->GetBounds().sphere;
+            spheres[i].center += ballPositions[i];
+        }
+        if (frustum.CullSpheres(spheres.data(), spheres.size(), visible.data(), &stats) == 0) return;
+
+        for (size_t i = 0; i < balls.size(); ++i) {
+            if (!visible[i]) continue;
+            Model& ball = *balls[i];
+            int lod = ball.GetLowestLOD();
+            if (!lowestLOD) {
+                float radius = ProjectedRadius(camera.view, camera.projection, ballPositions[i],
+                    ball.GetBoundingRadius(), viewportHeight);
+                lod = ball.SelectLOD(radius);
+            }
+            ball.Submit(queue, ballProgram, ballPositions[i], glm::vec3(0.0f), lod,
+                SortDepth(camera.view, ballPositions[i], camera.farPlane));
+        }
+    }
+
+    // Como QueueBalls, mas um quad por bola: o contorno é exato a qualquer tamanho, sem LODs
+    void GLRenderBackend::QueueImpostors(const Camera& camera, const Frustum& frustum, CullStats& stats) {
+        std::vector<BoundingSphere> spheres(impostorBalls.size());
+        std::vector<unsigned char> visible(impostorBalls.size());
+        for (size_t i = 0; i < impostorBalls.size(); ++i) {
+            spheres[i].center = impostorBalls[i].position;
+            spheres[i].radius = impostorBalls[i].radius;
+        }
+        if (frustum.CullSpheres(spheres.data(), spheres.size(), visible.data(), &stats) == 0) return;
+
+        for (size_t i = 0; i < impostorBalls.size(); ++i) {
+            if (!visible[i]) continue;
+            const BallObject& ball = impostorBalls[i];
+            impostors.Submit(queue, impostorProgram, impostorTextures[i], ball.position, ball.radius,
+                SortDepth(camera.view, ball.position, camera.farPlane));
+        }
+    }
+
+    void GLRenderBackend::DrawScene(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats& passStats) {
+        Frustum frustum;
+        frustum.Extract(camera.projection * camera.view);
+
+        // Bolas (LOD escolhido pelo tamanho projetado), ordenadas por estado. Um programa ainda
+        // a compilar (0) deixa essa parte da cena de fora até estar pronto.
+        queue.Clear();
+        if (ballMode == BallRenderMode::Impostor) {
+            if (impostorProgram) {
+                QueueImpostors(camera, frustum, passStats.cull);
+                SetCameraUniforms(impostorProgram, camera);
+            }
+        }
+        else if (ballProgram) {
+            QueueBalls(camera, viewport.height, lowestLOD, frustum, passStats.cull);
+            SetCameraUniforms(ballProgram, camera);
+        }
+
+        if (staticProgram) {
+            SetCameraUniforms(staticProgram, camera);
+            staticBatch.Draw(staticProgram, &frustum, &passStats.cull, &passStats.render);
+        }
+        queue.Sort();
+        queue.Submit(passStats.render);
+    }
+
+    void GLRenderBackend::RenderPass(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats* stats) {
+        PassStats local;
+        PassStats& passStats = stats ? *stats : local;
+        if (HasPendingPrograms()) ResolvePrograms(false);
+
+        // Vista principal com resolução dinâmica: desenhada no canto do alvo reduzido e ampliada
+        const bool fullFramebuffer = viewport.x == 0 && viewport.y == 0 && viewport.width == width && viewport.height == height;
+        if (sceneTarget.IsValid() && fullFramebuffer) {
+            Viewport scaled = { 0, 0, 0, 0 };
+            sceneTarget.Bind(resolution.GetScale(), scaled.width, scaled.height);
+            glViewport(0, 0, scaled.width, scaled.height);
+            glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            DrawScene(camera, scaled, lowestLOD, passStats);
+            sceneTarget.Resolve(outputFramebuffer, viewport.x, viewport.y, viewport.width, viewport.height);
+            return;
+        }
+
+        glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        DrawScene(camera, viewport, lowestLOD, passStats);
+    }
+
+    void GLRenderBackend::EndFrame() {
+        // Voltar viewport normal
+        glViewport(0, 0, width, height);
+        staticBatch.EndFrame();
+
+        if (!sceneTarget.IsValid()) return;
+        gpuTimer.End();
+        float cpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        // O resultado da GPU chega 1-2 frames depois; até lá conta a última medição
+        float gpuMs;
+        if (gpuTimer.Poll(gpuMs)) lastGpuMs = gpuMs;
+        resolution.Update(cpuMs, lastGpuMs);
+    }
+
+    bool GLRenderBackend::ReadPixels(std::vector<unsigned char>& rgba) {
+        const size_t rowBytes = static_cast<size_t>(width) * 4;
+        std::vector<unsigned char> pixels(rowBytes * height);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        // glReadPixels devolve a linha de baixo primeiro
+        rgba.resize(pixels.size());
+        for (int y = 0; y < height; ++y) {
+            std::copy(pixels.begin() + (height - 1 - y) * rowBytes, pixels.begin() + (height - y) * rowBytes,
+                rgba.begin() + y * rowBytes);
+        }
+        return true;
+    }
+
+} // namespace P3D
@@ -0,0 +1,130 @@
+#ifndef GLRENDERBACKEND_H
+#define GLRENDERBACKEND_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <GL/glew.h>
+
+#include "BallImpostors.h"
+#include "DynamicResolution.h"
+#include "FileBatch.h"
+#include "MaterialReloader.h"
+#include "P3D.h"
+#include "RenderBackend.h"
+#include "StaticBatch.h"
+#include "TaskGraph.h"
+
+namespace P3D {
+
+    // Como as bolas são desenhadas: malhas de esfera com LODs ou impostores (BallImpostors)
+    enum class BallRenderMode {
+        Mesh,
+        Impostor
+    };
+
+    // Renderer OpenGL: mesa num StaticBatch (multi-draw indirect) e bolas pela DrawQueue.
+    // Requer um contexto GL ativo com GLEW inicializado (a janela fica no main).
+    class GLRenderBackend : public RenderBackend {
+    public:
+        explicit GLRenderBackend(BallRenderMode ballMode = BallRenderMode::Mesh);
+        ~GLRenderBackend() override;
+
+        bool Init(const Scene& scene, int width, int height) override;
+        void Shutdown() override;
+
+        void BeginFrame(const glm::vec4& clearColor) override;
+        void RenderPass(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats* stats) override;
+        void EndFrame() override;
+
+        bool ReadPixels(std::vector<unsigned char>& rgba) override;
+
+        int GetWidth() const override { return width; }
+        int GetHeight() const override { return height; }
+        const char* GetName() const override { return "OpenGL"; }
+        BallRenderMode GetBallRenderMode() const { return ballMode; }
+
+        // Os shaders compilam em paralelo (ShaderCache): até estarem prontos, Init e RenderPass
+        // não esperam e a parte da cena que depende deles não é desenhada
+        bool HasPendingPrograms() const { return staticRequest >= 0 || ballRequest >= 0 || impostorRequest >= 0; }
+        // Espera pelo driver e recolhe todos os programas (para frames completos, ex.: capturas)
+        void WaitForPrograms();
+
+        // Antes de Init: a vista principal (o passo que ocupa o framebuffer todo) passa a ser
+        // desenhada num alvo próprio a uma escala ajustada em cada frame pelos tempos de CPU
+        // (BeginFrame..EndFrame) e de GPU (GL_TIME_ELAPSED), e ampliada para a janela
+        void EnableDynamicResolution(const DynamicResolutionSettings& settings);
+        bool UsesDynamicResolution() const { return sceneTarget.IsValid(); }
+        float GetResolutionScale() const { return UsesDynamicResolution() ? resolution.GetScale() : 1.0f; }
+        const ResolutionController& GetResolutionController() const { return resolution; }
+        // O loop vai ficar parado com o último frame no ecrã: se foi desenhado a escala
+        // reduzida, volta à máxima e devolve true para pedir mais um frame nítido
+        bool SettleResolution();
+
+        // Tempos do grafo que carregou as bolas no Init (.mtl e texturas em paralelo)
+        const TaskGraphStats& GetLoadStats() const { return loadStats; }
+        // Leitura em lote dos .mtl e texturas das bolas (io_uring ou threads)
+        const FileBatchStats& GetLoadFileStats() const { return loadFileStats; }
+
+        // Memória residente por asset depois do Init: lote estático, malha de cada bola e
+        // texturas (CPU = o que ficou depois dos envios, GPU = buffers e texturas)
+        void GetMemoryReport(std::vector<AssetMemory>& report) const;
+
+        // Depois do Init: vigia os .mtl e texturas das bolas e relê os que mudarem em
+        // segundo plano. wake corre noutras threads quando há algo para o ApplyReloads.
+        bool EnableHotReload(const std::function<void()>& wake);
+        // Entre frames: envia e troca os materiais já relidos. Verdadeiro se algo mudou.
+        bool ApplyReloads();
+
+    private:
+        StaticBatch staticBatch;
+        std::vector<std::unique_ptr<Model>> balls;
+        std::vector<glm::vec3> ballPositions;
+
+        // Modo Impostor: sem malhas, só a textura de cada bola (referência na TextureCache)
+        BallRenderMode ballMode;
+        BallImpostors impostors;
+        std::vector<BallObject> impostorBalls;
+        std::vector<GLuint> impostorTextures;
+
+        // .mtl e textura de cada bola carregada (nos dois modos), para o recarregamento a quente
+        std::vector<BallObject> ballSources;
+        MaterialReloader reloader;
+
+        GLuint staticProgram;
+        GLuint ballProgram;
+        GLuint impostorProgram;
+        // Pedidos ao ShaderCache ainda a compilar (-1 = nenhum)
+        int staticRequest;
+        int ballRequest;
+        int impostorRequest;
+
+        // Fila de draws reutilizada entre passos e frames
+        DrawQueue queue;
+
+        // Resolução dinâmica; outputFramebuffer é o que estava ligado no Init (a janela)
+        bool dynamicResolution;
+        ResolutionController resolution;
+        GpuFrameTimer gpuTimer;
+        ScaledRenderTarget sceneTarget;
+        GLuint outputFramebuffer;
+        glm::vec4 clearColor;
+        std::chrono::steady_clock::time_point frameStart;
+        float lastGpuMs;
+
+        TaskGraphStats loadStats;
+        FileBatchStats loadFileStats;
+
+        int width;
+        int height;
+
+        void QueueBalls(const Camera& camera, int viewportHeight, bool lowestLOD, const Frustum& frustum, CullStats& stats);
+        void QueueImpostors(const Camera& camera, const Frustum& frustum, CullStats& stats);
+        bool ResolvePrograms(bool wait);
+        void DrawScene(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats& stats);
+    };
+
+} // namespace P3D
+
+#endif // GLRENDERBACKEND_H
@@ -0,0 +1,1136 @@
+#include "ImageDecode.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define P3D_DECODE_SSE2 1
+#endif
+
+#include "stb_image.h"
+
+namespace P3D {
+
+    // Posição natural (linha * 8 + coluna) do k-ésimo coeficiente em ordem zigzag
+    static const uint8_t ZIGZAG[64] = {
+        0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+    };
+
+    static const int HUFFMAN_FAST_BITS = 9;
+
+    struct HuffmanTable {
+        uint8_t fastLength[1 << HUFFMAN_FAST_BITS];     // 0 = código com mais de FAST_BITS bits
+        uint8_t fastSymbol[1 << HUFFMAN_FAST_BITS];
+        int32_t maxCode[17];                            // maior código de cada comprimento, -1 se nenhum
+        int32_t valueOffset[17];                        // values[código + valueOffset[comprimento]]
+        uint8_t values[256];
+        bool defined = false;
+    };
+
+    struct JpegComponent {
+        int id;
+        int h, v;
+        int quantTable;
+        int dcTable, acTable;
+        int blocksX, blocksY;           // blocos guardados (múltiplo do MCU)
+        int usedBlocksX, usedBlocksY;   // blocos com pixels da imagem
+        int dcPrediction;
+        std::vector<int16_t> coefficients;  // 64 por bloco, em ordem zigzag
+        std::vector<uint8_t> plane;         // amostras já a 1/scale
+        int planeWidth, planeHeight;
+    };
+
+    // Leitor de bits do segmento entrópico: tira os 0x00 depois de 0xFF e pára nos
+    // marcadores (a partir daí devolve zeros, como pede a norma)
+    struct BitReader {
+        const uint8_t* p;
+        const uint8_t* end;
+        uint64_t buffer;
+        int bits;
+        bool markerHit;
+
+        void Reset(const uint8_t* start) {
+            p = start;
+            buffer = 0;
+            bits = 0;
+            markerHit = false;
+        }
+
+        // Garante pelo menos 57 bits no buffer
+        void Fill() {
+            while (bits <= 56) {
+                uint32_t byte = 0;
+                if (!markerHit && p < end) {
+                    byte = *p;
+                    if (byte == 0xFF) {
+                        if (p + 1 < end && p[1] == 0x00) p += 2;
+                        else { markerHit = true; byte = 0; }
+                    }
+                    else {
+                        ++p;
+                    }
+                }
+                buffer |= static_cast<uint64_t>(byte) << (56 - bits);
+                bits += 8;
+            }
+        }
+
+        uint32_t Peek(int n) const { return static_cast<uint32_t>(buffer >> (64 - n)); }
+        void Consume(int n) { buffer <<= n; bits -= n; }
+
+        int GetBits(int n) {
+            if (n == 0) return 0;
+            Fill();
+            int value = static_cast<int>(Peek(n));
+            Consume(n);
+            return value;
+        }
+
+        int GetBit() { return GetBits(1); }
+    };
+
+    // Valor com sinal de uma categoria de n bits (tabela F.12 da norma)
+    static inline int Extend(int value, int n) {
+        return value < (1 << (n - 1)) ? value - (1 << n) + 1 : value;
+    }
+
+    // ---------------------------------------------------------------- IDCT
+    // IDCT de 8x8 em float pelo algoritmo AAN (o jidctflt do libjpeg): 5 multiplicações por
+    // transformada 1D, com os fatores de escala do AAN já incluídos na tabela de dequantização.
+    // A mesma função 1D serve para floats (versão escalar) e para __m128 (4 colunas de cada vez).
+
+    static inline float Add(float a, float b) { return a + b; }
+    static inline float Sub(float a, float b) { return a - b; }
+    static inline float Mul(float a, float b) { return a * b; }
+    static inline float Splat(float a, float) { return a; }
+#ifdef P3D_DECODE_SSE2
+    static inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+    static inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+    static inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+    static inline __m128 Splat(float a, __m128) { return _mm_set1_ps(a); }
+#endif
+
+    template <typename V>
+    static inline void IDCT1D(V& x0, V& x1, V& x2, V& x3, V& x4, V& x5, V& x6, V& x7) {
+        const V sqrt2 = Splat(1.414213562f, x0);
+        // Parte par
+        V tmp10 = Add(x0, x4), tmp11 = Sub(x0, x4);
+        V tmp13 = Add(x2, x6);
+        V tmp12 = Sub(Mul(Sub(x2, x6), sqrt2), tmp13);
+        V even0 = Add(tmp10, tmp13), even3 = Sub(tmp10, tmp13);
+        V even1 = Add(tmp11, tmp12), even2 = Sub(tmp11, tmp12);
+        // Parte ímpar
+        V z13 = Add(x5, x3), z10 = Sub(x5, x3);
+        V z11 = Add(x1, x7), z12 = Sub(x1, x7);
+        V odd7 = Add(z11, z13);
+        V odd11 = Mul(Sub(z11, z13), sqrt2);
+        V z5 = Mul(Add(z10, z12), Splat(1.847759065f, x0));
+        V odd10 = Sub(Mul(z12, Splat(1.082392200f, x0)), z5);
+        V odd12 = Add(Mul(z10, Splat(-2.613125930f, x0)), z5);
+        V odd6 = Sub(odd12, odd7);
+        V odd5 = Sub(odd11, odd6);
+        V odd4 = Add(odd10, odd5);
+
+        x0 = Add(even0, odd7); x7 = Sub(even0, odd7);
+        x1 = Add(even1, odd6); x6 = Sub(even1, odd6);
+        x2 = Add(even2, odd5); x5 = Sub(even2, odd5);
+        x4 = Add(even3, odd4); x3 = Sub(even3, odd4);
+    }
+
+    static inline uint8_t ClampSample(float value) {
+        int i = static_cast<int>(value + 128.5f);
+        return static_cast<uint8_t>(i < 0 ? 0 : (i > 255 ? 255 : i));
+    }
+
+    // block: coeficientes dequantizados em ordem natural (com a escala AAN)
+    static void IDCT8x8(float block[64], uint8_t* out, int stride) {
+#ifdef P3D_DECODE_SSE2
+        __m128 r[8][2];
+        for (int i = 0; i < 8; ++i) {
+            r[i][0] = _mm_loadu_ps(block + i * 8);
+            r[i][1] = _mm_loadu_ps(block + i * 8 + 4);
+        }
+        // Colunas: cada registo tem 4 colunas da mesma linha
+        for (int h = 0; h < 2; ++h) {
+            IDCT1D(r[0][h], r[1][h], r[2][h], r[3][h], r[4][h], r[5][h], r[6][h], r[7][h]);
+        }
+        // Transpor 8x8 = transpor os 4 quadrantes e trocar os dois fora da diagonal
+        for (int pass = 0; pass < 2; ++pass) {
+            _MM_TRANSPOSE4_PS(r[0][0], r[1][0], r[2][0], r[3][0]);
+            _MM_TRANSPOSE4_PS(r[0][1], r[1][1], r[2][1], r[3][1]);
+            _MM_TRANSPOSE4_PS(r[4][0], r[5][0], r[6][0], r[7][0]);
+            _MM_TRANSPOSE4_PS(r[4][1], r[5][1], r[6][1], r[7][1]);
+            for (int i = 0; i < 4; ++i) std::swap(r[i][1], r[4 + i][0]);
+            if (pass == 1) break;
+            // Linhas
+            for (int h = 0; h < 2; ++h) {
+                IDCT1D(r[0][h], r[1][h], r[2][h], r[3][h], r[4][h], r[5][h], r[6][h], r[7][h]);
+            }
+        }
+        const __m128 bias = _mm_set1_ps(128.0f);
+        for (int i = 0; i < 8; ++i) {
+            __m128i low = _mm_cvtps_epi32(_mm_add_ps(r[i][0], bias));
+            __m128i high = _mm_cvtps_epi32(_mm_add_ps(r[i][1], bias));
+            __m128i words = _mm_packs_epi32(low, high);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i * stride), _mm_packus_epi16(words, words));
+        }
+#else
+        for (int c = 0; c < 8; ++c) {
+            float* x = block + c;
+            IDCT1D(x[0], x[8], x[16], x[24], x[32], x[40], x[48], x[56]);
+        }
+        for (int i = 0; i < 8; ++i) {
+            float* x = block + i * 8;
+            IDCT1D(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7]);
+            for (int j = 0; j < 8; ++j) out[i * stride + j] = ClampSample(x[j]);
+        }
+#endif
+    }
+
+    // IDCT reduzida a NxN (N = 4, 2, 1) com os coeficientes de frequência < N: as amostras
+    // ficam ~ a média dos blocos de (8/N)x(8/N) pixels. block sem a escala AAN.
+    struct ScaledIDCTTables {
+        float m4[4][4];     // [u][x] = 0.5 * C(u) * cos((2x + 1) u pi / 2N)
+        float m2[2][2];
+
+        ScaledIDCTTables() {
+            const double pi = 3.14159265358979323846;
+            for (int u = 0; u < 4; ++u) {
+                for (int x = 0; x < 4; ++x) {
+                    m4[u][x] = static_cast<float>(0.5 * (u == 0 ? std::sqrt(0.5) : 1.0) * std::cos((2 * x + 1) * u * pi / 8.0));
+                }
+            }
+            for (int u = 0; u < 2; ++u) {
+                for (int x = 0; x < 2; ++x) {
+                    m2[u][x] = static_cast<float>(0.5 * (u == 0 ? std::sqrt(0.5) : 1.0) * std::cos((2 * x + 1) * u * pi / 4.0));
+                }
+            }
+        }
+    };
+
+    static const ScaledIDCTTables& ScaledTables() {
+        static const ScaledIDCTTables tables;
+        return tables;
+    }
+
+    template <int N>
+    static void IDCTReduced(const float block[64], const float (&m)[N][N], uint8_t* out, int stride) {
+        float rows[N][N];
+        for (int v = 0; v < N; ++v) {
+            for (int x = 0; x < N; ++x) {
+                float sum = 0.0f;
+                for (int u = 0; u < N; ++u) sum += block[v * 8 + u] * m[u][x];
+                rows[v][x] = sum;
+            }
+        }
+        for (int y = 0; y < N; ++y) {
+            for (int x = 0; x < N; ++x) {
+                float sum = 0.0f;
+                for (int v = 0; v < N; ++v) sum += m[v][y] * rows[v][x];
+                out[y * stride + x] = ClampSample(sum);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------- YCbCr -> RGB
+
+    static void YCbCrToRGB(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* rgb, int count) {
+        int x = 0;
+#ifdef P3D_DECODE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 offset = _mm_set1_ps(128.0f);
+        const __m128 crToR = _mm_set1_ps(1.402f), cbToG = _mm_set1_ps(-0.344136f);
+        const __m128 crToG = _mm_set1_ps(-0.714136f), cbToB = _mm_set1_ps(1.772f);
+        for (; x + 4 <= count; x += 4) {
+            int32_t y4, cb4, cr4;
+            std::memcpy(&y4, y + x, 4);
+            std::memcpy(&cb4, cb + x, 4);
+            std::memcpy(&cr4, cr + x, 4);
+            __m128 yf = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(y4), zero), zero));
+            __m128 cbf = _mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(cb4), zero), zero)), offset);
+            __m128 crf = _mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(cr4), zero), zero)), offset);
+
+            __m128i r = _mm_cvtps_epi32(_mm_add_ps(yf, _mm_mul_ps(crf, crToR)));
+            __m128i g = _mm_cvtps_epi32(_mm_add_ps(yf, _mm_add_ps(_mm_mul_ps(cbf, cbToG), _mm_mul_ps(crf, crToG))));
+            __m128i b = _mm_cvtps_epi32(_mm_add_ps(yf, _mm_mul_ps(cbf, cbToB)));
+            // Saturação para 0..255: r0-r3 g0-g3 b0-b3 em 12 bytes, depois intercalar
+            alignas(16) uint8_t packed[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(packed),
+                _mm_packus_epi16(_mm_packs_epi32(r, g), _mm_packs_epi32(b, zero)));
+            for (int i = 0; i < 4; ++i) {
+                rgb[(x + i) * 3 + 0] = packed[i];
+                rgb[(x + i) * 3 + 1] = packed[4 + i];
+                rgb[(x + i) * 3 + 2] = packed[8 + i];
+            }
+        }
+#endif
+        for (; x < count; ++x) {
+            float yf = y[x], cbf = cb[x] - 128.0f, crf = cr[x] - 128.0f;
+            rgb[x * 3 + 0] = ClampSample(yf + 1.402f * crf - 128.0f);
+            rgb[x * 3 + 1] = ClampSample(yf - 0.344136f * cbf - 0.714136f * crf - 128.0f);
+            rgb[x * 3 + 2] = ClampSample(yf + 1.772f * cbf - 128.0f);
+        }
+    }
+
+    // ---------------------------------------------------------------- descodificador
+
+    // Cabeçalho de um scan, da passagem prévia que decide que scans se podem saltar
+    struct ScanSummary {
+        int componentId;        // primeiro componente (os scans AC progressivos só têm um)
+        int spectralStart, spectralEnd;
+        int approxHigh;
+    };
+
+    class JpegDecoder {
+    public:
+        JpegDecoder(const uint8_t* data, size_t size, int scale)
+            : begin(data), end(data + size), p(data), scale(scale), blockSize(8 / scale),
+            width(0), height(0), hmax(1), vmax(1), mcusX(0), mcusY(0),
+            progressive(false), frameRead(false), scansDecoded(0), adobeTransform(-1),
+            restartInterval(0), scanIndex(0), scanCount(0), spectralStart(0), spectralEnd(0),
+            approxHigh(0), approxLow(0), eobRun(0), failed(false)
+        {
+            // Último coeficiente (em zigzag) que ainda conta para uma IDCT de blockSize
+            maxZigzag = 0;
+            for (int k = 0; k < 64; ++k) {
+                if (ZIGZAG[k] / 8 < blockSize && ZIGZAG[k] % 8 < blockSize) maxZigzag = k;
+            }
+            std::memset(quantDefined, 0, sizeof(quantDefined));
+            bits.Reset(data);
+            bits.end = end;
+        }
+
+        bool Decode(DecodedImage& image);
+
+    private:
+        const uint8_t* begin;
+        const uint8_t* end;
+        const uint8_t* p;
+        int scale;
+        int blockSize;
+        int maxZigzag;
+
+        uint16_t quant[4][64];      // em ordem zigzag, como no DQT
+        bool quantDefined[4];
+        HuffmanTable dcTables[4];
+        HuffmanTable acTables[4];
+        std::vector<JpegComponent> components;
+
+        int width, height;
+        int hmax, vmax;
+        int mcusX, mcusY;
+        bool progressive;
+        bool frameRead;
+        int scansDecoded;
+        int adobeTransform;         // -1 sem marcador Adobe; 0 = RGB, 1 = YCbCr
+        int restartInterval;
+
+        std::vector<ScanSummary> scanList;
+        int scanIndex;
+
+        // Estado do scan atual
+        int scanCount;
+        int scanComponents[4];
+        int spectralStart, spectralEnd;
+        int approxHigh, approxLow;
+        int eobRun;
+        BitReader bits;
+        bool failed;
+
+        bool ReadU16(int& value) {
+            if (end - p < 2) return false;
+            value = (p[0] << 8) | p[1];
+            p += 2;
+            return true;
+        }
+
+        bool ReadQuantTables(const uint8_t* segmentEnd);
+        bool ReadHuffmanTables(const uint8_t* segmentEnd);
+        bool ReadFrame(const uint8_t* segmentEnd);
+        bool ReadScanHeader(const uint8_t* segmentEnd);
+        bool DecodeScan();
+        void ListScans();
+        bool CanSkipScan() const;
+        void SkipEntropyData();
+        bool Restart();
+
+        int DecodeSymbol(const HuffmanTable& table);
+        void DecodeBlock(JpegComponent& component, int16_t* coefficients);
+        void DecodeBaselineBlock(JpegComponent& component, int16_t* coefficients);
+        void DecodeACFirst(int16_t* coefficients, const HuffmanTable& table);
+        void DecodeACRefine(int16_t* coefficients, const HuffmanTable& table);
+
+        void Reconstruct(JpegComponent& component);
+        void Output(DecodedImage& image);
+    };
+
+    bool JpegDecoder::ReadQuantTables(const uint8_t* segmentEnd) {
+        while (p < segmentEnd) {
+            int precision = *p >> 4, table = *p & 15;
+            ++p;
+            if (table > 3 || precision > 1 || segmentEnd - p < 64 * (precision + 1)) return false;
+            for (int k = 0; k < 64; ++k) {
+                quant[table][k] = precision ? static_cast<uint16_t>((p[0] << 8) | p[1]) : p[0];
+                p += precision + 1;
+            }
+            quantDefined[table] = true;
+        }
+        return true;
+    }
+
+    bool JpegDecoder::ReadHuffmanTables(const uint8_t* segmentEnd) {
+        while (p < segmentEnd) {
+            if (segmentEnd - p < 17) return false;
+            int tableClass = *p >> 4, index = *p & 15;
+            ++p;
+            if (tableClass > 1 || index > 3) return false;
+            int counts[17] = { 0 };
+            int total = 0;
+            for (int length = 1; length <= 16; ++length) {
+                counts[length] = *p++;
+                total += counts[length];
+            }
+            if (total > 256 || segmentEnd - p < total) return false;
+
+            HuffmanTable& table = tableClass == 0 ? dcTables[index] : acTables[index];
+            table.defined = false;
+            std::memcpy(table.values, p, total);
+            p += total;
+            std::memset(table.fastLength, 0, sizeof(table.fastLength));
+
+            // Códigos canónicos (anexo C): crescentes dentro de cada comprimento
+            int code = 0, symbol = 0;
+            for (int length = 1; length <= 16; ++length) {
+                table.valueOffset[length] = symbol - code;
+                for (int i = 0; i < counts[length]; ++i, ++code, ++symbol) {
+                    // Tabela sobre-subscrita: o código já não cabe em length bits e as
+                    // escritas abaixo sairiam de fastLength/fastSymbol
+                    if (code >= (1 << length)) return false;
+                    if (length <= HUFFMAN_FAST_BITS) {
+                        int shift = HUFFMAN_FAST_BITS - length;
+                        for (int j = 0; j < (1 << shift); ++j) {
+                            table.fastLength[(code << shift) | j] = static_cast<uint8_t>(length);
+                            table.fastSymbol[(code << shift) | j] = table.values[symbol];
+                        }
+                    }
+                }
+                table.maxCode[length] = counts[length] ? code - 1 : -1;
+                code <<= 1;
+            }
+            table.defined = true;
+        }
+        return true;
+    }
+
+    bool JpegDecoder::ReadFrame(const uint8_t* segmentEnd) {
+        if (frameRead || segmentEnd - p < 6) return false;
+        int precision = p[0];
+        height = (p[1] << 8) | p[2];
+        width = (p[3] << 8) | p[4];
+        int count = p[5];
+        p += 6;
+        // 12 bits, altura definida por DNL e CMYK ficam para o stb_image
+        if (precision != 8 || width == 0 || height == 0 || (count != 1 && count != 3)) return false;
+        if (static_cast<uint64_t>(width) * height > (1u << 28) || segmentEnd - p < count * 3) return false;
+
+        components.resize(count);
+        for (JpegComponent& component : components) {
+            component.id = p[0];
+            component.h = p[1] >> 4;
+            component.v = p[1] & 15;
+            component.quantTable = p[2];
+            p += 3;
+            if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quantTable > 3) return false;
+            hmax = std::max(hmax, component.h);
+            vmax = std::max(vmax, component.v);
+        }
+        mcusX = (width + 8 * hmax - 1) / (8 * hmax);
+        mcusY = (height + 8 * vmax - 1) / (8 * vmax);
+        for (JpegComponent& component : components) {
+            component.blocksX = mcusX * component.h;
+            component.blocksY = mcusY * component.v;
+            int componentWidth = (width * component.h + hmax - 1) / hmax;
+            int componentHeight = (height * component.v + vmax - 1) / vmax;
+            component.usedBlocksX = (componentWidth + 7) / 8;
+            component.usedBlocksY = (componentHeight + 7) / 8;
+            component.coefficients.assign(static_cast<size_t>(component.blocksX) * component.blocksY * 64, 0);
+            component.dcTable = component.acTable = 0;
+            component.dcPrediction = 0;
+        }
+        frameRead = true;
+        return true;
+    }
+
+    bool JpegDecoder::ReadScanHeader(const uint8_t* segmentEnd) {
+        if (!frameRead || segmentEnd - p < 1) return false;
+        scanCount = *p++;
+        if (scanCount < 1 || scanCount > static_cast<int>(components.size()) || segmentEnd - p < scanCount * 2 + 3) return false;
+        for (int i = 0; i < scanCount; ++i) {
+            int id = p[0], tables = p[1];
+            p += 2;
+            int index = -1;
+            for (size_t c = 0; c < components.size(); ++c) {
+                if (components[c].id == id) index = static_cast<int>(c);
+            }
+            if (index < 0) return false;
+            components[index].dcTable = tables >> 4;
+            components[index].acTable = tables & 15;
+            if (components[index].dcTable > 3 || components[index].acTable > 3) return false;
+            scanComponents[i] = index;
+        }
+        spectralStart = p[0];
+        spectralEnd = p[1];
+        approxHigh = p[2] >> 4;
+        approxLow = p[2] & 15;
+        p += 3;
+
+        if (progressive) {
+            if (spectralStart > spectralEnd || spectralEnd > 63 || approxLow > 13) return false;
+            if (spectralStart == 0 && spectralEnd != 0) return false;
+            if (spectralStart > 0 && scanCount != 1) return false;
+        }
+        else if (spectralStart != 0 || spectralEnd != 63 || approxHigh != 0 || approxLow != 0) {
+            return false;
+        }
+        for (int i = 0; i < scanCount; ++i) {
+            const JpegComponent& component = components[scanComponents[i]];
+            if (!quantDefined[component.quantTable]) return false;
+            if (spectralStart == 0 && approxHigh == 0 && !dcTables[component.dcTable].defined) return false;
+            if (spectralEnd > 0 && !acTables[component.acTable].defined) return false;
+        }
+        p = segmentEnd;
+        return true;
+    }
+
+    int JpegDecoder::DecodeSymbol(const HuffmanTable& table) {
+        bits.Fill();
+        uint32_t look = bits.Peek(HUFFMAN_FAST_BITS);
+        int length = table.fastLength[look];
+        if (length) {
+            bits.Consume(length);
+            return table.fastSymbol[look];
+        }
+        for (length = HUFFMAN_FAST_BITS + 1; length <= 16; ++length) {
+            int32_t code = static_cast<int32_t>(bits.Peek(length));
+            if (code <= table.maxCode[length]) {
+                bits.Consume(length);
+                return table.values[(code + table.valueOffset[length]) & 255];
+            }
+        }
+        failed = true;
+        return 0;
+    }
+
+    void JpegDecoder::DecodeBaselineBlock(JpegComponent& component, int16_t* coefficients) {
+        int size = DecodeSymbol(dcTables[component.dcTable]);
+        if (size > 16) { failed = true; return; }
+        component.dcPrediction += size ? Extend(bits.GetBits(size), size) : 0;
+        coefficients[0] = static_cast<int16_t>(component.dcPrediction);
+
+        // Os AC acima de maxZigzag têm de ser lidos, mas não se guardam
+        const HuffmanTable& table = acTables[component.acTable];
+        for (int k = 1; k < 64;) {
+            int rs = DecodeSymbol(table);
+            int run = rs >> 4, bitCount = rs & 15;
+            if (bitCount == 0) {
+                if (run != 15) break;   // EOB
+                k += 16;
+                continue;
+            }
+            k += run;
+            if (k > 63) { failed = true; return; }
+            int value = Extend(bits.GetBits(bitCount), bitCount);
+            if (k <= maxZigzag) coefficients[k] = static_cast<int16_t>(value);
+            ++k;
+        }
+    }
+
+    void JpegDecoder::DecodeACFirst(int16_t* coefficients, const HuffmanTable& table) {
+        if (eobRun > 0) {
+            --eobRun;
+            return;
+        }
+        for (int k = spectralStart; k <= spectralEnd;) {
+            int rs = DecodeSymbol(table);
+            int run = rs >> 4, bitCount = rs & 15;
+            if (bitCount == 0) {
+                if (run < 15) {
+                    // EOBn: este bloco e os próximos eobRun não têm mais coeficientes nesta banda
+                    eobRun = (1 << run) - 1;
+                    if (run) eobRun += bits.GetBits(run);
+                    break;
+                }
+                k += 16;
+                continue;
+            }
+            k += run;
+            if (k > 63) { failed = true; return; }
+            coefficients[k] = static_cast<int16_t>(Extend(bits.GetBits(bitCount), bitCount) * (1 << approxLow));
+            ++k;
+        }
+    }
+
+    // Aproximação sucessiva dos AC (G.1.2.3): um bit a mais em cada coeficiente já não nulo
+    // e novos coeficientes de valor +-1 << Al
+    void JpegDecoder::DecodeACRefine(int16_t* coefficients, const HuffmanTable& table) {
+        const int positive = 1 << approxLow;
+        const int negative = -1 * (1 << approxLow);
+        int k = spectralStart;
+
+        auto refine = [&](int16_t& coefficient) {
+            if (bits.GetBit() && (coefficient & positive) == 0) {
+                coefficient = static_cast<int16_t>(coefficient + (coefficient >= 0 ? positive : negative));
+            }
+        };
+
+        if (eobRun == 0) {
+            for (; k <= spectralEnd; ++k) {
+                int rs = DecodeSymbol(table);
+                int run = rs >> 4, bitCount = rs & 15;
+                int value = 0;
+                if (bitCount) {
+                    if (bitCount != 1) { failed = true; return; }
+                    value = bits.GetBit() ? positive : negative;
+                }
+                else if (run != 15) {
+                    eobRun = 1 << run;
+                    if (run) eobRun += bits.GetBits(run);
+                    break;
+                }
+                // Saltar run coeficientes nulos, refinando os não nulos pelo caminho
+                while (k <= spectralEnd) {
+                    int16_t& coefficient = coefficients[k];
+                    if (coefficient != 0) refine(coefficient);
+                    else if (--run < 0) break;
+                    ++k;
+                }
+                if (value && k <= spectralEnd) coefficients[k] = static_cast<int16_t>(value);
+            }
+        }
+        if (eobRun > 0) {
+            for (; k <= spectralEnd; ++k) {
+                if (coefficients[k] != 0) refine(coefficients[k]);
+            }
+            --eobRun;
+        }
+    }
+
+    void JpegDecoder::DecodeBlock(JpegComponent& component, int16_t* coefficients) {
+        if (!progressive) {
+            DecodeBaselineBlock(component, coefficients);
+        }
+        else if (spectralStart == 0) {
+            if (approxHigh == 0) {
+                int size = DecodeSymbol(dcTables[component.dcTable]);
+                if (size > 16) { failed = true; return; }
+                component.dcPrediction += size ? Extend(bits.GetBits(size), size) : 0;
+                coefficients[0] = static_cast<int16_t>(component.dcPrediction * (1 << approxLow));
+            }
+            else if (bits.GetBit()) {
+                coefficients[0] = static_cast<int16_t>(coefficients[0] | (1 << approxLow));
+            }
+        }
+        else if (approxHigh == 0) {
+            DecodeACFirst(coefficients, acTables[component.acTable]);
+        }
+        else {
+            DecodeACRefine(coefficients, acTables[component.acTable]);
+        }
+    }
+
+    // Depois de restartInterval MCUs vem um RSTn: os bits que sobram são enchimento
+    bool JpegDecoder::Restart() {
+        const uint8_t* q = bits.p;
+        while (q + 1 < end && !(q[0] == 0xFF && q[1] >= 0xD0 && q[1] <= 0xD7)) {
+            if (q[0] == 0xFF && q[1] != 0x00 && q[1] != 0xFF) return false;  // outro marcador: dados truncados
+            ++q;
+        }
+        if (q + 1 >= end) return false;
+        bits.Reset(q + 2);
+        eobRun = 0;
+        for (JpegComponent& component : components) component.dcPrediction = 0;
+        return true;
+    }
+
+    bool JpegDecoder::DecodeScan() {
+        bits.Reset(p);
+        eobRun = 0;
+        for (JpegComponent& component : components) component.dcPrediction = 0;
+
+        int units = 0;
+        if (scanCount == 1) {
+            // Não intercalado: um bloco por MCU, só os blocos com pixels
+            JpegComponent& component = components[scanComponents[0]];
+            for (int by = 0; by < component.usedBlocksY && !failed; ++by) {
+                for (int bx = 0; bx < component.usedBlocksX && !failed; ++bx, ++units) {
+                    if (restartInterval && units > 0 && units % restartInterval == 0 && !Restart()) return false;
+                    DecodeBlock(component, &component.coefficients[(static_cast<size_t>(by) * component.blocksX + bx) * 64]);
+                }
+            }
+        }
+        else {
+            for (int my = 0; my < mcusY && !failed; ++my) {
+                for (int mx = 0; mx < mcusX && !failed; ++mx, ++units) {
+                    if (restartInterval && units > 0 && units % restartInterval == 0 && !Restart()) return false;
+                    for (int i = 0; i < scanCount; ++i) {
+                        JpegComponent& component = components[scanComponents[i]];
+                        for (int v = 0; v < component.v; ++v) {
+                            for (int h = 0; h < component.h; ++h) {
+                                size_t block = static_cast<size_t>(my * component.v + v) * component.blocksX + mx * component.h + h;
+                                DecodeBlock(component, &component.coefficients[block * 64]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        p = bits.p;
+        return !failed;
+    }
+
+    // Percorre os marcadores do ficheiro (saltando os dados entrópicos) só para ler os SOS
+    void JpegDecoder::ListScans() {
+        const uint8_t* q = begin + 2;
+        while (end - q >= 4) {
+            if (q[0] != 0xFF || q[1] == 0xFF) { ++q; continue; }
+            int marker = q[1];
+            if (marker == 0x00 || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) { q += 2; continue; }
+            if (marker == 0xD9) break;
+            int length = (q[2] << 8) | q[3];
+            if (length < 2 || end - q < length + 2) break;
+            if (marker == 0xDA && length >= 6 + 2 * q[4]) {
+                int count = q[4];
+                ScanSummary scan;
+                scan.componentId = q[5];
+                scan.spectralStart = q[5 + 2 * count];
+                scan.spectralEnd = q[6 + 2 * count];
+                scan.approxHigh = q[7 + 2 * count] >> 4;
+                scanList.push_back(scan);
+            }
+            q += length + 2;
+        }
+    }
+
+    // Uma banda acima de maxZigzag só se pode saltar se nenhum refinamento descodificado
+    // depois a cobrir: o refinamento precisa de saber que coeficientes já não são nulos
+    bool JpegDecoder::CanSkipScan() const {
+        if (!progressive || spectralStart <= maxZigzag) return false;
+        const int id = components[scanComponents[0]].id;
+        for (size_t i = scanIndex + 1; i < scanList.size(); ++i) {
+            const ScanSummary& later = scanList[i];
+            if (later.componentId != id || later.approxHigh == 0) continue;
+            if (later.spectralStart == 0 || later.spectralStart > maxZigzag) continue;
+            if (later.spectralStart <= spectralEnd && later.spectralEnd >= spectralStart) return false;
+        }
+        return true;
+    }
+
+    // Avança até ao próximo marcador que não seja RSTn (scans que não contam para este tamanho)
+    void JpegDecoder::SkipEntropyData() {
+        while (p + 1 < end) {
+            if (p[0] == 0xFF && p[1] != 0x00 && p[1] != 0xFF && !(p[1] >= 0xD0 && p[1] <= 0xD7)) return;
+            ++p;
+        }
+        p = end;
+    }
+
+    void JpegDecoder::Reconstruct(JpegComponent& component) {
+        component.planeWidth = component.usedBlocksX * blockSize;
+        component.planeHeight = component.usedBlocksY * blockSize;
+        component.plane.resize(static_cast<size_t>(component.planeWidth) * component.planeHeight);
+
+        // Dequantização por posição zigzag; a 8x8 inclui a escala do AAN e o 1/8 final
+        static const float AAN[8] = { 1.0f, 1.387039845f, 1.306562965f, 1.175875602f,
+            1.0f, 0.785694958f, 0.541196100f, 0.275899379f };
+        float multiplier[64];
+        const uint16_t* table = quant[component.quantTable];
+        for (int k = 0; k < 64; ++k) {
+            int n = ZIGZAG[k];
+            multiplier[k] = scale == 1 ? table[k] * AAN[n / 8] * AAN[n % 8] * 0.125f : static_cast<float>(table[k]);
+        }
+        const ScaledIDCTTables& scaled = ScaledTables();
+        const int lastCoefficient = maxZigzag;
+
+        float block[64];
+        for (int by = 0; by < component.usedBlocksY; ++by) {
+            for (int bx = 0; bx < component.usedBlocksX; ++bx) {
+                const int16_t* coefficients = &component.coefficients[(static_cast<size_t>(by) * component.blocksX + bx) * 64];
+                uint8_t* out = &component.plane[static_cast<size_t>(by) * blockSize * component.planeWidth + bx * blockSize];
+
+                bool dcOnly = true;
+                for (int k = 1; k <= lastCoefficient && dcOnly; ++k) dcOnly = coefficients[k] == 0;
+                if (dcOnly) {
+                    // Bloco liso (muito comum): o valor é DC / 8 em qualquer tamanho
+                    uint8_t value = ClampSample(coefficients[0] * static_cast<float>(table[0]) * 0.125f);
+                    for (int y = 0; y < blockSize; ++y) std::memset(out + y * component.planeWidth, value, blockSize);
+                    continue;
+                }
+
+                std::memset(block, 0, sizeof(block));
+                for (int k = 0; k <= lastCoefficient; ++k) {
+                    if (coefficients[k]) block[ZIGZAG[k]] = coefficients[k] * multiplier[k];
+                }
+                switch (blockSize) {
+                case 8: IDCT8x8(block, out, component.planeWidth); break;
+                case 4: IDCTReduced<4>(block, scaled.m4, out, component.planeWidth); break;
+                case 2: IDCTReduced<2>(block, scaled.m2, out, component.planeWidth); break;
+                default: *out = ClampSample(block[0] * 0.125f); break;
+                }
+            }
+        }
+        // Os coeficientes já não são precisos
+        std::vector<int16_t>().swap(component.coefficients);
+    }
+
+    void JpegDecoder::Output(DecodedImage& image) {
+        image.width = (width + scale - 1) / scale;
+        image.height = (height + scale - 1) / scale;
+        image.channels = components.size() == 1 ? 1 : 3;
+        image.pixels.resize(static_cast<size_t>(image.width) * image.height * image.channels);
+
+        // Amostra de cada componente para cada coluna/linha de saída (vizinho mais próximo
+        // nos componentes subamostrados)
+        const size_t count = components.size();
+        std::vector<std::vector<int>> columns(count);
+        for (size_t c = 0; c < count; ++c) {
+            columns[c].resize(image.width);
+            for (int x = 0; x < image.width; ++x) {
+                columns[c][x] = std::min(x * components[c].h / hmax, components[c].planeWidth - 1);
+            }
+        }
+
+        std::vector<uint8_t> rows[3];
+        for (size_t c = 0; c < count; ++c) rows[c].resize(image.width);
+        for (int y = 0; y < image.height; ++y) {
+            const uint8_t* row[3];
+            for (size_t c = 0; c < count; ++c) {
+                const JpegComponent& component = components[c];
+                int sourceY = std::min(y * component.v / vmax, component.planeHeight - 1);
+                const uint8_t* source = &component.plane[static_cast<size_t>(sourceY) * component.planeWidth];
+                if (component.h == hmax) {
+                    row[c] = source;
+                }
+                else {
+                    for (int x = 0; x < image.width; ++x) rows[c][x] = source[columns[c][x]];
+                    row[c] = rows[c].data();
+                }
+            }
+            uint8_t* out = &image.pixels[static_cast<size_t>(y) * image.width * image.channels];
+            if (count == 1) {
+                std::memcpy(out, row[0], image.width);
+            }
+            else if (adobeTransform == 0) {
+                for (int x = 0; x < image.width; ++x) {
+                    out[x * 3 + 0] = row[0][x];
+                    out[x * 3 + 1] = row[1][x];
+                    out[x * 3 + 2] = row[2][x];
+                }
+            }
+            else {
+                YCbCrToRGB(row[0], row[1], row[2], out, image.width);
+            }
+        }
+    }
+
+    bool JpegDecoder::Decode(DecodedImage& image) {
+        if (end - begin < 4 || begin[0] != 0xFF || begin[1] != 0xD8) return false;
+        p = begin + 2;
+        if (maxZigzag < 63) ListScans();
+
+        for (;;) {
+            // Próximo marcador (pode haver bytes 0xFF de enchimento antes)
+            while (p < end && *p != 0xFF) ++p;
+            while (p < end && *p == 0xFF) ++p;
+            if (p >= end) break;
+            int marker = *p++;
+            if (marker == 0xD9) break;                          // EOI
+            // 0x00 = byte de dados com enchimento (lixo depois de um scan), TEM e RSTn não têm tamanho
+            if (marker == 0x00 || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+
+            int length;
+            if (!ReadU16(length) || length < 2 || end - p < length - 2) return false;
+            const uint8_t* segmentEnd = p + length - 2;
+            switch (marker) {
+            case 0xC0: case 0xC1: case 0xC2:
+                progressive = marker == 0xC2;
+                if (!ReadFrame(segmentEnd)) return false;
+                break;
+            case 0xC4:
+                if (!ReadHuffmanTables(segmentEnd)) return false;
+                break;
+            case 0xDB:
+                if (!ReadQuantTables(segmentEnd)) return false;
+                break;
+            case 0xDD:
+                if (length < 4) return false;
+                restartInterval = (p[0] << 8) | p[1];
+                break;
+            case 0xEE:
+                if (length >= 14 && std::memcmp(p, "Adobe", 5) == 0) adobeTransform = p[11];
+                break;
+            case 0xDA:
+                if (!ReadScanHeader(segmentEnd)) return false;
+                // Nos progressivos, as bandas de frequência acima do que a IDCT reduzida usa nem se leem
+                if (CanSkipScan()) SkipEntropyData();
+                else if (!DecodeScan()) return false;
+                ++scansDecoded;
+                ++scanIndex;
+                continue;
+            default:
+                // SOF3/5-15 (sem perdas, hierárquico, aritmético) não são suportados
+                if ((marker >= 0xC3 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)) return false;
+                break;
+            }
+            p = segmentEnd;
+        }
+        if (!frameRead || scansDecoded == 0) return false;
+
+        for (JpegComponent& component : components) Reconstruct(component);
+        Output(image);
+        return true;
+    }
+
+    bool DecodeJPEG(const unsigned char* data, size_t size, DecodedImage& image, int scale) {
+        if (scale != 1 && scale != 2 && scale != 4 && scale != 8) return false;
+        JpegDecoder decoder(data, size, scale);
+        return decoder.Decode(image);
+    }
+
+    // ---------------------------------------------------------------- com stb_image como alternativa
+
+    // Média de blocos scale x scale (o stb_image não tem descodificação reduzida)
+    static void Downscale(DecodedImage& image, int scale) {
+        DecodedImage reduced;
+        reduced.width = (image.width + scale - 1) / scale;
+        reduced.height = (image.height + scale - 1) / scale;
+        reduced.channels = image.channels;
+        reduced.pixels.resize(static_cast<size_t>(reduced.width) * reduced.height * reduced.channels);
+        for (int y = 0; y < reduced.height; ++y) {
+            for (int x = 0; x < reduced.width; ++x) {
+                int x1 = std::min(image.width, (x + 1) * scale), y1 = std::min(image.height, (y + 1) * scale);
+                int count = (x1 - x * scale) * (y1 - y * scale);
+                for (int c = 0; c < image.channels; ++c) {
+                    int sum = 0;
+                    for (int sy = y * scale; sy < y1; ++sy) {
+                        for (int sx = x * scale; sx < x1; ++sx) {
+                            sum += image.pixels[(static_cast<size_t>(sy) * image.width + sx) * image.channels + c];
+                        }
+                    }
+                    reduced.pixels[(static_cast<size_t>(y) * reduced.width + x) * reduced.channels + c] =
+                        static_cast<unsigned char>((sum + count / 2) / count);
+                }
+            }
+        }
+        image = std::move(reduced);
+    }
+
+    void ConvertImageChannels(DecodedImage& image, int desiredChannels) {
+        if (desiredChannels == 0 || desiredChannels == image.channels) return;
+        std::vector<unsigned char> converted(static_cast<size_t>(image.width) * image.height * desiredChannels);
+        const size_t count = static_cast<size_t>(image.width) * image.height;
+        for (size_t i = 0; i < count; ++i) {
+            const unsigned char* in = &image.pixels[i * image.channels];
+            unsigned char* out = &converted[i * desiredChannels];
+            unsigned char r = in[0], g = image.channels >= 3 ? in[1] : in[0], b = image.channels >= 3 ? in[2] : in[0];
+            if (desiredChannels == 1) {
+                out[0] = static_cast<unsigned char>((r * 77 + g * 150 + b * 29) >> 8);
+                continue;
+            }
+            out[0] = r; out[1] = g; out[2] = b;
+            if (desiredChannels == 4) out[3] = image.channels == 4 ? in[3] : (image.channels == 2 ? in[1] : 255);
+        }
+        image.pixels.swap(converted);
+        image.channels = desiredChannels;
+    }
+
+    bool DecodeImage(const unsigned char* data, size_t size, DecodedImage& image, int desiredChannels, int scale) {
+        if (scale != 1 && scale != 2 && scale != 4 && scale != 8) return false;
+        if (DecodeJPEG(data, size, image, scale)) {
+            ConvertImageChannels(image, desiredChannels);
+            return true;
+        }
+
+        int width, height, channels;
+        unsigned char* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, desiredChannels);
+        if (!pixels) return false;
+        image.width = width;
+        image.height = height;
+        image.channels = desiredChannels ? desiredChannels : channels;
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * image.channels);
+        stbi_image_free(pixels);
+        if (scale > 1) Downscale(image, scale);
+        return true;
+    }
+
+    static bool ReadFile(const std::string& filePath, std::vector<unsigned char>& data) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        std::streamoff size = file.tellg();
+        if (size <= 0) return false;
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+    }
+
+    bool DecodeImageFile(const std::string& filePath, DecodedImage& image, int desiredChannels, int scale) {
+        std::vector<unsigned char> data;
+        return ReadFile(filePath, data) && DecodeImage(data.data(), data.size(), image, desiredChannels, scale);
+    }
+
+    // ---------------------------------------------------------------- listas de imagens
+
+    static bool IsImageFile(const std::string& name) {
+        size_t dot = name.find_last_of('.');
+        if (dot == std::string::npos) return false;
+        std::string extension = name.substr(dot + 1);
+        for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return extension == "jpg" || extension == "jpeg" || extension == "png" || extension == "tga" || extension == "bmp";
+    }
+
+    static bool IsDirectory(const std::string& path) {
+#ifdef _WIN32
+        struct _stat64 info;
+        return _stat64(path.c_str(), &info) == 0 && (info.st_mode & _S_IFDIR);
+#else
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+    }
+
+    static void ListImages(const std::string& directory, std::vector<std::string>& images) {
+        std::string prefix = directory;
+        if (!prefix.empty() && prefix.back() != '/' && prefix.back() != '\\') prefix += '/';
+        std::vector<std::string> names;
+#ifdef _WIN32
+        struct _finddata_t entry;
+        intptr_t handle = _findfirst((prefix + "*").c_str(), &entry);
+        if (handle != -1) {
+            do {
+                if (!(entry.attrib & _A_SUBDIR) && IsImageFile(entry.name)) names.push_back(entry.name);
+            } while (_findnext(handle, &entry) == 0);
+            _findclose(handle);
+        }
+#else
+        if (DIR* dir = opendir(prefix.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                if (IsImageFile(entry->d_name)) names.push_back(entry->d_name);
+            }
+            closedir(dir);
+        }
+#endif
+        std::sort(names.begin(), names.end());
+        for (const std::string& name : names) images.push_back(prefix + name);
+    }
+
+    void CollectImageFiles(const std::vector<std::string>& inputs, std::vector<std::string>& images) {
+        for (const std::string& input : inputs) {
+            if (IsDirectory(input)) ListImages(input, images);
+            else images.push_back(input);
+        }
+    }
+
+    // ---------------------------------------------------------------- --bench-decode
+
+    static double PSNR(const DecodedImage& a, const unsigned char* b, size_t count) {
+        double error = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double d = static_cast<double>(a.pixels[i]) - b[i];
+            error += d * d;
+        }
+        if (error == 0.0) return 99.0;
+        return 10.0 * std::log10(255.0 * 255.0 * count / error);
+    }
+
+    int RunDecodeBenchmark(const std::vector<std::string>& inputs, int iterations) {
+        std::vector<std::string> images;
+        CollectImageFiles(inputs, images);
+        if (images.empty()) {
+            std::cerr << "Erro: nenhuma imagem para o benchmark" << std::endl;
+            return -1;
+        }
+        iterations = std::max(1, iterations);
+        static const int SCALES[4] = { 1, 2, 4, 8 };
+
+        std::printf("%-36s %10s %9s %9s %9s %9s %9s %7s\n", "imagem", "tamanho", "stbi ms", "1/1 ms", "1/2 ms", "1/4 ms", "1/8 ms", "PSNR");
+        double totalStbi = 0.0, totalScaled[4] = { 0, 0, 0, 0 };
+        double megapixels = 0.0;
+        for (const std::string& path : images) {
+            std::vector<unsigned char> data;
+            if (!ReadFile(path, data)) {
+                std::cerr << "Erro ao abrir a imagem: " << path << std::endl;
+                continue;
+            }
+
+            // Melhor tempo de iterations descodificações (o ficheiro já está em memória)
+            int width = 0, height = 0, channels = 0;
+            double stbiMs = 1e30;
+            unsigned char* reference = nullptr;
+            for (int i = 0; i < iterations; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                unsigned char* pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channels, 3);
+                stbiMs = std::min(stbiMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                if (reference) stbi_image_free(reference);
+                reference = pixels;
+            }
+            if (!reference) {
+                std::cerr << "Erro ao descodificar com o stb_image: " << path << std::endl;
+                continue;
+            }
+
+            double scaledMs[4];
+            double psnr = 0.0;
+            bool supported = true;
+            for (int s = 0; s < 4 && supported; ++s) {
+                scaledMs[s] = 1e30;
+                for (int i = 0; i < iterations && supported; ++i) {
+                    DecodedImage image;
+                    auto start = std::chrono::steady_clock::now();
+                    supported = DecodeJPEG(data.data(), data.size(), image, SCALES[s]);
+                    scaledMs[s] = std::min(scaledMs[s], std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                    if (supported && s == 0 && i == 0) {
+                        ConvertImageChannels(image, 3);
+                        psnr = PSNR(image, reference, static_cast<size_t>(width) * height * 3);
+                    }
+                }
+            }
+            stbi_image_free(reference);
+
+            char size[32];
+            std::snprintf(size, sizeof(size), "%dx%d", width, height);
+            if (!supported) {
+                std::printf("%-36s %10s %9.2f %9s (formato não suportado, usa o stb_image)\n", path.c_str(), size, stbiMs, "-");
+                continue;
+            }
+            std::printf("%-36s %10s %9.2f %9.2f %9.2f %9.2f %9.2f %6.1fdB\n", path.c_str(), size, stbiMs,
+                scaledMs[0], scaledMs[1], scaledMs[2], scaledMs[3], psnr);
+            totalStbi += stbiMs;
+            for (int s = 0; s < 4; ++s) totalScaled[s] += scaledMs[s];
+            megapixels += width * static_cast<double>(height) / 1e6;
+        }
+        if (totalStbi > 0.0) {
+            std::printf("Total: stbi %.1f ms (%.1f MP/s), DecodeJPEG %.1f ms (%.1f MP/s, %.2fx); 1/2 %.1f ms, 1/4 %.1f ms, 1/8 %.1f ms\n",
+                totalStbi, megapixels * 1000.0 / totalStbi, totalScaled[0], megapixels * 1000.0 / totalScaled[0],
+                totalStbi / totalScaled[0], totalScaled[1], totalScaled[2], totalScaled[3]);
+        }
+        return 0;
+    }
+
+} // namespace P3D
@@ -0,0 +1,43 @@
+#ifndef IMAGEDECODE_H
+#define IMAGEDECODE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace P3D {
+
+    struct DecodedImage {
+        int width = 0;
+        int height = 0;
+        int channels = 0;                   // 1 (cinzento), 3 (RGB) ou 4 (RGBA)
+        std::vector<unsigned char> pixels;  // linhas de cima para baixo, sem padding
+    };
+
+    // Descodificador JPEG próprio (baseline e progressivo, 8 bits, cinzento ou YCbCr com
+    // qualquer subamostragem até 2x2). IDCT e conversão YCbCr->RGB em SSE2, com versão
+    // escalar. scale 2, 4 ou 8 devolve a imagem a 1/scale (arredondado para cima) usando
+    // IDCTs reduzidas: nos JPEG progressivos os scans AC que não contribuem para esse
+    // tamanho nem são lidos, e a 1/8 só contam os coeficientes DC.
+    // Falso em formatos que não suporta (aritmético, 12 bits, CMYK...).
+    bool DecodeJPEG(const unsigned char* data, size_t size, DecodedImage& image, int scale = 1);
+
+    // DecodeJPEG e, se falhar ou não for JPEG, stb_image (reduzido depois com média de
+    // blocos se scale > 1). desiredChannels como no stbi_load: 0 = os do ficheiro, 3 ou 4.
+    bool DecodeImage(const unsigned char* data, size_t size, DecodedImage& image, int desiredChannels = 0, int scale = 1);
+    bool DecodeImageFile(const std::string& filePath, DecodedImage& image, int desiredChannels = 0, int scale = 1);
+
+    // Muda o número de canais (1, 3 ou 4) como o req_comp do stbi_load; 0 não mexe
+    void ConvertImageChannels(DecodedImage& image, int desiredChannels);
+
+    // Junta as imagens (.jpg/.jpeg/.png/.tga/.bmp) das entradas: ficheiros tal como estão,
+    // pastas por ordem alfabética e sem subpastas
+    void CollectImageFiles(const std::vector<std::string>& inputs, std::vector<std::string>& images);
+
+    // --bench-decode: tempo do stbi_load_from_memory vs DecodeJPEG a 1, 1/2, 1/4 e 1/8
+    // em cada imagem, e PSNR do DecodeJPEG em relação ao stb_image. 0 se correu.
+    int RunDecodeBenchmark(const std::vector<std::string>& inputs, int iterations);
+
+} // namespace P3D
+
+#endif // IMAGEDECODE_H
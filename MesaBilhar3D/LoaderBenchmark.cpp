@@ -0,0 +1,449 @@
+// windows.h (incluído pelo tinyobj_loader_opt.h e para o pico de memória) sem as macros min/max
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include "LoaderBenchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#define TINYOBJ_LOADER_OPT_IMPLEMENTATION
+#include "tinyobj_loader_opt.h"
+
+#include "MeshImport.h"
+#include "Model.h"
+#include "P3D.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/resource.h>
+#endif
+
+// Contagem de alocações: substitui o operator new global do programa inteiro.
+// Um incremento relaxed por alocação; malloc direto (ex.: stb_image) não é contado.
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    for (;;) {
+        void* p = std::malloc(size);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+namespace P3D {
+
+    // Nome na linha de comando do filho e nome na tabela
+    struct LoaderInfo {
+        const char* id;
+        const char* name;
+    };
+
+    // "cache" tem de ser o último: a cache é gravada pelo processo pai logo antes
+    static const LoaderInfo LOADERS[] = {
+        { "simple", "Import simples" },
+        { "parallel", "Import paralelo" },
+        { "p3d", "P3D::Model" },
+        { "pool3d", "Pool3D::Model" },
+        { "tinyobj_opt", "tinyobj_opt" },
+        { "cache", "Import cache" },
+    };
+
+    static const size_t FACE_COUNTS[] = { 1000, 10000, 100000, 1000000, 10000000 };
+
+    static const char* FacesName(SyntheticFaces faces) {
+        switch (faces) {
+        case SyntheticFaces::Triangles: return "tri";
+        case SyntheticFaces::Quads: return "quad";
+        case SyntheticFaces::Polygons: return "ngon6";
+        default: return "lshape";
+        }
+    }
+
+    // Pico do working set / RSS do processo atual, em KB
+    static size_t PeakResidentKB() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+        return counters.PeakWorkingSetSize / 1024;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss) / 1024;    // bytes em macOS
+#else
+        return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+    }
+
+    static size_t FileSize(const std::string& filePath) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return 0;
+        return static_cast<size_t>(file.tellg());
+    }
+
+    // Escrita com um buffer grande: os ficheiros de 10M faces passam de 1 GB
+    class OBJWriter {
+    public:
+        explicit OBJWriter(const std::string& filePath) : file(filePath, std::ios::binary) {
+            buffer.reserve(BUFFER_SIZE + 256);
+        }
+        ~OBJWriter() { Flush(); }
+
+        bool IsOpen() const { return file.is_open(); }
+        bool Good() { Flush(); return file.good(); }
+
+        void Line(const char* text, size_t length) {
+            buffer.insert(buffer.end(), text, text + length);
+            if (buffer.size() >= BUFFER_SIZE) Flush();
+        }
+
+    private:
+        static const size_t BUFFER_SIZE = 1 << 20;
+        std::ofstream file;
+        std::vector<char> buffer;
+
+        void Flush() {
+            if (buffer.empty()) return;
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    };
+
+    bool WriteSyntheticOBJ(const std::string& filePath, size_t faceCount, SyntheticFaces faces, bool withAttributes) {
+        OBJWriter writer(filePath);
+        if (!writer.IsOpen()) {
+            std::cerr << "Erro ao criar " << filePath << std::endl;
+            return false;
+        }
+
+        // Células da grelha necessárias: 2 triângulos ou 1 quad por célula, 1 hexágono por 2 células,
+        // 1 L + 1 quad por bloco de 2x2 células
+        size_t cells = faces == SyntheticFaces::Triangles ? (faceCount + 1) / 2
+            : faces == SyntheticFaces::Quads ? faceCount : faceCount * 2;
+        const size_t stepX = faces == SyntheticFaces::Polygons || faces == SyntheticFaces::Concave ? 2 : 1;
+        const size_t stepZ = faces == SyntheticFaces::Concave ? 2 : 1;
+        size_t cellsX = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(cells))));
+        cellsX += cellsX & 1;   // par, para os hexágonos e os blocos 2x2 não cruzarem linhas
+        size_t cellsZ = (cells + cellsX - 1) / cellsX;
+        cellsZ += cellsZ & (stepZ - 1);
+        size_t rowVertices = cellsX + 1;
+
+        char line[160];
+        int length = std::snprintf(line, sizeof(line), "# %zu faces %s%s\n", faceCount, FacesName(faces),
+            withAttributes ? " com vt/vn" : "");
+        writer.Line(line, length);
+
+        for (size_t z = 0; z <= cellsZ; ++z) {
+            for (size_t x = 0; x <= cellsX; ++x) {
+                float px = x * 0.01f;
+                float pz = z * 0.01f;
+                float py = 0.05f * std::sin(px * 3.0f) * std::cos(pz * 3.0f);
+                length = std::snprintf(line, sizeof(line), "v %.4f %.4f %.4f\n", px, py, pz);
+                writer.Line(line, length);
+            }
+        }
+        if (withAttributes) {
+            for (size_t z = 0; z <= cellsZ; ++z) {
+                for (size_t x = 0; x <= cellsX; ++x) {
+                    length = std::snprintf(line, sizeof(line), "vt %.5f %.5f\n",
+                        static_cast<float>(x) / cellsX, static_cast<float>(z) / cellsZ);
+                    writer.Line(line, length);
+                }
+            }
+            for (size_t z = 0; z <= cellsZ; ++z) {
+                for (size_t x = 0; x <= cellsX; ++x) {
+                    float nx = 0.15f * std::cos(x * 0.03f) * std::cos(z * 0.03f);
+                    length = std::snprintf(line, sizeof(line), "vn %.4f %.4f %.4f\n", nx, std::sqrt(1.0f - nx * nx), 0.0f);
+                    writer.Line(line, length);
+                }
+            }
+        }
+
+        // Índices 1-based, v/vt/vn iguais porque os atributos são por vértice da grelha
+        auto corner = [&](char* out, size_t size, size_t x, size_t z) {
+            size_t index = z * rowVertices + x + 1;
+            return withAttributes ? std::snprintf(out, size, " %zu/%zu/%zu", index, index, index)
+                : std::snprintf(out, size, " %zu", index);
+        };
+        auto face = [&](const size_t (*corners)[2], int count) {
+            int used = std::snprintf(line, sizeof(line), "f");
+            for (int i = 0; i < count; ++i) {
+                used += corner(line + used, sizeof(line) - used, corners[i][0], corners[i][1]);
+            }
+            line[used++] = '\n';
+            writer.Line(line, used);
+        };
+
+        size_t written = 0;
+        for (size_t z = 0; z + stepZ <= cellsZ && written < faceCount; z += stepZ) {
+            for (size_t x = 0; x + stepX <= cellsX && written < faceCount; x += stepX) {
+                if (faces == SyntheticFaces::Triangles) {
+                    const size_t a[3][2] = { { x, z }, { x, z + 1 }, { x + 1, z + 1 } };
+                    face(a, 3);
+                    if (++written == faceCount) break;
+                    const size_t b[3][2] = { { x, z }, { x + 1, z + 1 }, { x + 1, z } };
+                    face(b, 3);
+                }
+                else if (faces == SyntheticFaces::Quads) {
+                    const size_t q[4][2] = { { x, z }, { x, z + 1 }, { x + 1, z + 1 }, { x + 1, z } };
+                    face(q, 4);
+                }
+                else if (faces == SyntheticFaces::Polygons) {
+                    const size_t h[6][2] = { { x, z }, { x, z + 1 }, { x + 1, z + 1 },
+                        { x + 2, z + 1 }, { x + 2, z }, { x + 1, z } };
+                    face(h, 6);
+                }
+                else {
+                    // L a começar num canto de onde o leque sairia do polígono
+                    const size_t l[6][2] = { { x + 2, z + 1 }, { x + 2, z }, { x, z },
+                        { x, z + 2 }, { x + 1, z + 2 }, { x + 1, z + 1 } };
+                    face(l, 6);
+                    if (++written == faceCount) break;
+                    const size_t q[4][2] = { { x + 1, z + 1 }, { x + 1, z + 2 }, { x + 2, z + 2 }, { x + 2, z + 1 } };
+                    face(q, 4);
+                }
+                ++written;
+            }
+        }
+
+        if (!writer.Good()) {
+            std::cerr << "Erro ao gravar " << filePath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Backend fixo e sem ler nem gravar a cache, para medir só o parse
+    static ImportOptions BenchmarkImportOptions(ImportBackend backend) {
+        ImportOptions options;
+        options.backend = backend;
+        options.useCache = false;
+        options.writeCache = false;
+        return options;
+    }
+
+    // Carrega com o loader pedido; o tempo inclui ler o ficheiro mas não destruir o resultado
+    static bool LoadWith(const std::string& loader, const std::string& objFilePath, double& ms, size_t& vertexCount) {
+        auto start = std::chrono::steady_clock::now();
+        if (loader == "simple" || loader == "parallel" || loader == "cache") {
+            ImportBackend backend = loader == "simple" ? ImportBackend::Simple
+                : loader == "parallel" ? ImportBackend::Parallel : ImportBackend::Cache;
+            MeshData mesh;
+            bool loaded = ImportMesh(objFilePath, mesh, BenchmarkImportOptions(backend));
+            ms = ElapsedMs(start);
+            vertexCount = mesh.vertices.size();
+            return loaded;
+        }
+        if (loader == "nenhum") {
+            ms = ElapsedMs(start);
+            vertexCount = 0;
+            return true;
+        }
+        if (loader == "p3d") {
+            Model model;
+            bool loaded = model.LoadGeometry(objFilePath, BenchmarkImportOptions(ImportBackend::Auto));
+            ms = ElapsedMs(start);
+            vertexCount = model.GetVertexCount();
+            return loaded;
+        }
+        if (loader == "pool3d") {
+            Pool3D::Model model;
+            bool loaded = model.LoadOBJ(objFilePath, BenchmarkImportOptions(ImportBackend::Auto));
+            ms = ElapsedMs(start);
+            vertexCount = 0;
+            for (const Pool3D::MeshGroup& group : model.GetMeshGroups()) vertexCount += group.vertices.size();
+            return loaded;
+        }
+        if (loader == "tinyobj_opt") {
+            // parseObj trabalha sobre o ficheiro inteiro em memória
+            std::ifstream file(objFilePath, std::ios::binary | std::ios::ate);
+            if (!file.is_open()) return false;
+            std::vector<char> data(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(data.data(), data.size());
+
+            tinyobj_opt::attrib_t attrib;
+            std::vector<tinyobj_opt::shape_t> shapes;
+            std::vector<tinyobj_opt::material_t> materials;
+            tinyobj_opt::LoadOption option;     // todas as threads, triangulado
+            bool loaded = tinyobj_opt::parseObj(&attrib, &shapes, &materials, data.data(), data.size(), option);
+            ms = ElapsedMs(start);
+            vertexCount = attrib.indices.size();
+            return loaded;
+        }
+        std::cerr << "Loader desconhecido: " << loader << std::endl;
+        return false;
+    }
+
+    int RunLoaderBenchmarkChild(const std::string& loader, const std::string& objFilePath) {
+        allocationCount.store(0, std::memory_order_relaxed);
+
+        double ms = 0.0;
+        size_t vertexCount = 0;
+        bool loaded = false;
+        try {
+            loaded = LoadWith(loader, objFilePath, ms, vertexCount);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Excecao no loader " << loader << ": " << e.what() << std::endl;
+        }
+        size_t allocations = allocationCount.load(std::memory_order_relaxed);
+
+        if (!loaded) {
+            std::printf("resultado falhou\n");
+            return 1;
+        }
+        std::printf("resultado ok %.3f %zu %zu %zu\n", ms, PeakResidentKB(), allocations, vertexCount);
+        return 0;
+    }
+
+    struct ChildResult {
+        bool ok = false;
+        double ms = 0.0;
+        size_t peakKB = 0;
+        size_t allocations = 0;
+        size_t vertices = 0;
+    };
+
+    // Corre "<exe> --bench-loader-run <loader> <ficheiro>" e lê a linha "resultado ..."
+    static ChildResult RunChild(const std::string& executablePath, const std::string& loader, const std::string& objFilePath) {
+        std::string command = "\"" + executablePath + "\" --bench-loader-run " + loader + " \"" + objFilePath + "\" 2>&1";
+#ifdef _WIN32
+        // cmd /c tira as aspas exteriores quando a linha tem mais de um par
+        command = "\"" + command + "\"";
+#endif
+        ChildResult result;
+        FILE* pipe = popen(command.c_str(), "r");
+        if (!pipe) return result;
+
+        // O resto do output (avisos dos loaders) é ignorado
+        std::string output;
+        char chunk[512];
+        while (std::fgets(chunk, sizeof(chunk), pipe)) output += chunk;
+        pclose(pipe);
+
+        std::istringstream lines(output);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::istringstream iss(line);
+            std::string tag, status;
+            iss >> tag >> status;
+            if (tag != "resultado" || status != "ok") continue;
+            iss >> result.ms >> result.peakKB >> result.allocations >> result.vertices;
+            result.ok = !iss.fail();
+        }
+        return result;
+    }
+
+    int RunLoaderBenchmark(const LoaderBenchmarkOptions& options) {
+        ChildResult baseline = RunChild(options.executablePath, "nenhum", "");
+        if (!baseline.ok) {
+            std::cerr << "Falha a lancar o processo de medicao: " << options.executablePath << std::endl;
+            return -1;
+        }
+        std::printf("Processo vazio: pico RSS %.1f MB, %zu alocacoes (ja incluidos em cada linha)\n\n",
+            baseline.peakKB / 1024.0, baseline.allocations);
+        std::printf("%-9s %-6s %-8s %-14s %9s %10s %9s %10s %12s %10s\n",
+            "faces", "tipo", "atrib", "loader", "MB", "ms", "MB/s", "pico MB", "alocacoes", "vertices");
+
+        const SyntheticFaces kinds[] = {
+            SyntheticFaces::Triangles, SyntheticFaces::Quads, SyntheticFaces::Polygons, SyntheticFaces::Concave
+        };
+        for (size_t faceCount : FACE_COUNTS) {
+            if (faceCount > options.maxFaces) break;
+            for (SyntheticFaces kind : kinds) {
+                for (bool withAttributes : { false, true }) {
+                    std::string filePath = options.directory + "bench_" + std::to_string(faceCount) + "_" +
+                        FacesName(kind) + (withAttributes ? "_vtn" : "_v") + ".obj";
+                    if (!WriteSyntheticOBJ(filePath, faceCount, kind, withAttributes)) return -1;
+                    double fileMB = FileSize(filePath) / (1024.0 * 1024.0);
+
+                    for (const LoaderInfo& loader : LOADERS) {
+                        if (std::string(loader.id) == "cache") {
+                            MeshData mesh;
+                            ImportOptions cacheOptions = BenchmarkImportOptions(ImportBackend::Parallel);
+                            if (!ImportMesh(filePath, mesh, cacheOptions) || !WriteMeshCache(filePath, mesh)) {
+                                std::cerr << "Erro ao gravar a cache de " << filePath << std::endl;
+                            }
+                        }
+                        ChildResult result = RunChild(options.executablePath, loader.id, filePath);
+                        std::printf("%-9zu %-6s %-8s %-14s %9.2f ", faceCount, FacesName(kind),
+                            withAttributes ? "v/vt/vn" : "v", loader.name, fileMB);
+                        if (!result.ok) {
+                            std::printf("%10s\n", "falhou");
+                        }
+                        else {
+                            double seconds = result.ms / 1000.0;
+                            std::printf("%10.2f %9.1f %10.1f %12zu %10zu\n", result.ms,
+                                seconds > 0.0 ? fileMB / seconds : 0.0, result.peakKB / 1024.0,
+                                result.allocations, result.vertices);
+                        }
+                        std::fflush(stdout);
+                    }
+
+                    if (!options.keepFiles) {
+                        std::remove(filePath.c_str());
+                        std::remove(MeshCachePath(filePath).c_str());
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+
+} // namespace P3D
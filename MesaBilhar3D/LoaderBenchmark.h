@@ -0,0 +1,40 @@
+#ifndef LOADERBENCHMARK_H
+#define LOADERBENCHMARK_H
+
+#include <cstddef>
+#include <string>
+
+namespace P3D {
+
+    // Tipo de face dos .obj sintéticos
+    enum class SyntheticFaces {
+        Triangles,
+        Quads,
+        Polygons,       // hexágonos convexos (n-gons de 6 vértices)
+        Concave         // hexágonos em L (côncavos, precisam do earcut) + quads
+    };
+
+    // Grelha plana com faceCount faces; withAttributes acrescenta vt/vn (faces v/vt/vn, senão só v)
+    bool WriteSyntheticOBJ(const std::string& filePath, size_t faceCount, SyntheticFaces faces, bool withAttributes);
+
+    // Compara os backends do ImportMesh (simples, paralelo, cache), o P3D::Model e o
+    // Pool3D::Model por cima dele e o tinyobj_opt::parseObj multithread em .obj sintéticos
+    // de 1K faces até maxFaces. Cada medição corre num processo filho (o próprio executável
+    // com --bench-loader-run) para que o pico de memória seja só desse loader.
+    struct LoaderBenchmarkOptions {
+        std::string executablePath;     // argv[0]
+        std::string directory;          // onde gerar os .obj (vazio = pasta atual)
+        size_t maxFaces = 1000000;      // 10000000 inclui o caso de 10M faces (~1 GB em disco)
+        bool keepFiles = false;
+    };
+
+    // 0 se correu (mesmo com loaders que falham num formato), -1 em erro
+    int RunLoaderBenchmark(const LoaderBenchmarkOptions& options);
+
+    // Lado do processo filho: carrega objFilePath com o loader dado e escreve uma linha
+    // "resultado ok <ms> <pico RSS KB> <alocações> <vértices>" (ou "resultado falhou") no stdout
+    int RunLoaderBenchmarkChild(const std::string& loader, const std::string& objFilePath);
+
+} // namespace P3D
+
+#endif // LOADERBENCHMARK_H
@@ -0,0 +1,146 @@
+#include "MaterialReloader.h"
+
+#include <iostream>
+
+#include "TextureBaker.h"
+
+namespace P3D {
+
+    MaterialReloader::~MaterialReloader() {
+        Stop();
+    }
+
+    void MaterialReloader::WatchBall(const BallObject& ball) {
+        watcher.Watch(ball.mtlFilePath);
+        if (ball.textureFilePath.empty()) return;
+        watcher.Watch(ball.textureFilePath);
+        // Um pacote regenerado com --bake-textures também conta como textura nova
+        watcher.Watch(BakedTexturePath(ball.textureFilePath));
+    }
+
+    bool MaterialReloader::Start(const std::vector<BallObject>& sources, const std::function<void()>& wakeCallback) {
+        if (running) return true;
+        balls = sources;
+        wake = wakeCallback;
+        for (const BallObject& ball : balls) WatchBall(ball);
+        if (!watcher.Start(wake)) return false;
+
+        stopping = false;
+        worker = std::thread(&MaterialReloader::WorkerLoop, this);
+        running = true;
+        return true;
+    }
+
+    void MaterialReloader::Stop() {
+        if (!running) return;
+        watcher.Stop();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            jobs.clear();
+        }
+        jobAvailable.notify_all();
+        worker.join();
+        finished.clear();
+        running = false;
+    }
+
+    std::vector<MaterialReload> MaterialReloader::Poll() {
+        std::vector<MaterialReload> ready;
+        if (!running) return ready;
+
+        std::vector<std::string> changes = watcher.TakeChanges();
+        if (!changes.empty()) {
+            auto now = std::chrono::steady_clock::now();
+            std::vector<Job> requested;
+            for (size_t i = 0; i < balls.size(); ++i) {
+                const BallObject& ball = balls[i];
+                bool mtlChanged = false, textureChanged = false;
+                for (const std::string& filePath : changes) {
+                    if (filePath == ball.mtlFilePath) mtlChanged = true;
+                    else if (!ball.textureFilePath.empty() &&
+                        (filePath == ball.textureFilePath || filePath == BakedTexturePath(ball.textureFilePath))) {
+                        textureChanged = true;
+                    }
+                }
+                if (!mtlChanged && !textureChanged) continue;
+
+                // Mesmo com o tamanho e a data iguais (duas gravações no mesmo segundo) a
+                // textura tem de ser lida outra vez
+                if (textureChanged) TextureCache::Instance().Forget(ball.textureFilePath);
+                Job job;
+                job.ball = i;
+                job.mtlChanged = mtlChanged;
+                job.mtlFilePath = ball.mtlFilePath;
+                job.textureFilePath = ball.textureFilePath;
+                job.detected = now;
+                requested.push_back(job);
+            }
+            if (!requested.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (Job& job : requested) jobs.push_back(job);
+                }
+                jobAvailable.notify_one();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(finished);
+        return ready;
+    }
+
+    void MaterialReloader::Commit(const MaterialReload& reload) {
+        if (reload.ball >= balls.size()) return;
+        BallObject& ball = balls[reload.ball];
+        if (ball.textureFilePath == reload.textureFilePath) return;
+        // O .mtl passou a apontar para outra imagem: a antiga continua vigiada (outra bola
+        // pode usá-la) e é ignorada pelo Poll
+        ball.textureFilePath = reload.textureFilePath;
+        WatchBall(ball);
+    }
+
+    // Na thread de fundo: nada de GL, só ficheiros e a parte thread-safe da TextureCache
+    void MaterialReloader::Reload(const Job& job, MaterialReload& reload) {
+        reload.ball = job.ball;
+        reload.mtlChanged = job.mtlChanged;
+        reload.textureFilePath = job.textureFilePath;
+        reload.detected = job.detected;
+        if (job.mtlChanged) {
+            if (!ReadMTL(job.mtlFilePath, reload.material)) {
+                std::cerr << "Erro ao recarregar MTL: " << job.mtlFilePath << std::endl;
+                reload.failed = true;
+                return;
+            }
+            reload.textureFilePath = reload.material.textureFileName;
+        }
+        // Com o .mtl alterado mas a mesma textura, o Prepare encontra-a na cache sem a ler
+        if (!TextureCache::Instance().Prepare(reload.textureFilePath, reload.texture)) {
+            std::cerr << "Erro ao recarregar textura: " << reload.textureFilePath << std::endl;
+            reload.failed = true;
+        }
+    }
+
+    void MaterialReloader::WorkerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            MaterialReload reload;
+            Reload(job, reload);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping) return;
+                finished.push_back(std::move(reload));
+            }
+            if (wake) wake();
+        }
+    }
+
+} // namespace P3D
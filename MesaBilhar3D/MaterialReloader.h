@@ -0,0 +1,85 @@
+#ifndef MATERIALRELOADER_H
+#define MATERIALRELOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "P3D.h"
+#include "Scene.h"
+#include "TextureCache.h"
+
+namespace P3D {
+
+    // Material de uma bola relido em segundo plano, pronto a trocar na thread GL
+    struct MaterialReload {
+        size_t ball = 0;                 // índice nas bolas dadas ao Start
+        bool mtlChanged = false;         // .mtl relido: cores e talvez outra textura
+        MTLMaterial material;            // só com mtlChanged
+        std::string textureFilePath;
+        PreparedTexture texture;
+        bool failed = false;             // fica o material antigo
+        std::chrono::steady_clock::time_point detected;
+    };
+
+    // Recarregamento a quente dos .mtl e texturas das bolas (--hot-reload). O FileWatcher
+    // diz que ficheiros mudaram; Poll, na thread GL entre frames, passa-os a uma thread de
+    // fundo que só refaz as etapas afetadas (.mtl alterado: .mtl e textura; textura alterada:
+    // só a textura; a geometria nunca) e devolve os materiais já lidos e descodificados.
+    // O envio para a GPU e a troca ficam para quem chama, sempre na fronteira entre frames.
+    class MaterialReloader {
+    public:
+        MaterialReloader() = default;
+        ~MaterialReloader();
+
+        // balls: .mtl e textura de cada bola, pela ordem de quem chama. wake corre noutras
+        // threads quando há trabalho para o Poll (ex.: glfwPostEmptyEvent).
+        bool Start(const std::vector<BallObject>& balls, const std::function<void()>& wake);
+        void Stop();
+        bool IsRunning() const { return running; }
+
+        // Thread GL: pede os recarregamentos detetados desde a última chamada e devolve os
+        // que já terminaram
+        std::vector<MaterialReload> Poll();
+        // Thread GL, depois de trocar o material: a bola passa a usar a textura do reload
+        // (e vigia-a, se for nova)
+        void Commit(const MaterialReload& reload);
+
+    private:
+        struct Job {
+            size_t ball = 0;
+            bool mtlChanged = false;
+            std::string mtlFilePath;
+            std::string textureFilePath;
+            std::chrono::steady_clock::time_point detected;
+        };
+
+        FileWatcher watcher;
+        std::vector<BallObject> balls;
+        std::function<void()> wake;
+        bool running = false;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        std::deque<Job> jobs;
+        std::vector<MaterialReload> finished;
+        bool stopping = false;
+
+        void WatchBall(const BallObject& ball);
+        void WorkerLoop();
+        static void Reload(const Job& job, MaterialReload& reload);
+
+        MaterialReloader(const MaterialReloader&) = delete;
+        MaterialReloader& operator=(const MaterialReloader&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // MATERIALRELOADER_H
@@ -4,7 +4,27 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
+
+#include "GLRenderBackend.h"
+#include "FrameScheduler.h"
+#include "ImageDecode.h"
+#include "LoaderBenchmark.h"
+#include "RegressionSuite.h"
+#include "RenderBackend.h"
+#include "Scene.h"
+#include "ShaderCache.h"
+#include "SoftwareRasterizer.h"
+#include "StartupTrace.h"
+#include "TextureBaker.h"
+#include "TextureCache.h"
+#include "VertexFormatBenchmark.h"
 
 
 // Janela
@@ -18,11 +38,16 @@ float camPitch = 20.0f; // vertical angulo
 bool leftMousePressed = false;
 double lastX, lastY;
 
+// Só desenha quando algo muda (--continuous desenha sempre)
+P3D::FrameScheduler frameScheduler;
+
 // Funções para callback
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
+    float previous = camDistance;
     camDistance -= (float)yoffset * 0.5f;
     if (camDistance < 2.0f) camDistance = 2.0f;
     if (camDistance > 20.0f) camDistance = 20.0f;
+    if (camDistance != previous) frameScheduler.Invalidate();
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
@@ -51,135 +76,253 @@ void cursor_pos_callback(GLFWwindow* window, double xpos, double ypos) {
 
         lastX = xpos;
         lastY = ypos;
+        if (dx != 0.0f || dy != 0.0f) frameScheduler.Invalidate();
     }
 }
 
-// Define vértices do paralelepípedo (mesa)
-float vertices[] = {
-    // Positions           // Colors (R,G,B)
-    // Face frontal (z = 0.5)
-    -1.0f, -0.5f,  0.5f,  1,0,0, // vermelho
-     1.0f, -0.5f,  0.5f,  1,0,0,
-     1.0f,  0.5f,  0.5f,  1,0,0,
-    -1.0f,  0.5f,  0.5f,  1,0,0,
-
-    // Face traseira (z = -0.5)
-    -1.0f, -0.5f, -0.5f,  0,1,0, // verde
-     1.0f, -0.5f, -0.5f,  0,1,0,
-     1.0f,  0.5f, -0.5f,  0,1,0,
-    -1.0f,  0.5f, -0.5f,  0,1,0,
-
-    // Face esquerda (x = -1)
-    -1.0f, -0.5f, -0.5f,  0,0,1, // azul
-    -1.0f, -0.5f,  0.5f,  0,0,1,
-    -1.0f,  0.5f,  0.5f,  0,0,1,
-    -1.0f,  0.5f, -0.5f,  0,0,1,
-
-    // Face direita (x = 1)
-     1.0f, -0.5f, -0.5f,  1,1,0, // amarelo
-     1.0f, -0.5f,  0.5f,  1,1,0,
-     1.0f,  0.5f,  0.5f,  1,1,0,
-     1.0f,  0.5f, -0.5f,  1,1,0,
-
-     // Face topo (y = 0.5)
-     -1.0f,  0.5f, -0.5f,  1,0,1, // magenta
-      1.0f,  0.5f, -0.5f,  1,0,1,
-      1.0f,  0.5f,  0.5f,  1,0,1,
-     -1.0f,  0.5f,  0.5f,  1,0,1,
-
-     // Face baixo (y = -0.5)
-     -1.0f, -0.5f, -0.5f,  0,1,1, // ciano
-      1.0f, -0.5f, -0.5f,  0,1,1,
-      1.0f, -0.5f,  0.5f,  0,1,1,
-     -1.0f, -0.5f,  0.5f,  0,1,1,
-};
-
-unsigned int indices[] = {
-    0,1,2, 2,3,0,       // frente
-    4,5,6, 6,7,4,       // trás
-    8,9,10, 10,11,8,    // esquerda
-    12,13,14, 14,15,12, // direita
-    16,17,18, 18,19,16, // topo
-    20,21,22, 22,23,20  // baixo
-};
-
-// Shader simples - vertex shader
-const char* vertexShaderSource = R"(
-#version 330 core
-layout(location=0) in vec3 aPos;
-layout(location=1) in vec3 aColor;
-
-out vec3 ourColor;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main(){
-    gl_Position = projection * view * model * vec4(aPos,1.0);
-    ourColor = aColor;
+// Janela exposta, redimensionada ou restaurada: o conteúdo tem de ser redesenhado
+void window_refresh_callback(GLFWwindow* window) {
+    frameScheduler.Invalidate();
 }
-)";
 
-// Shader simples - fragment shader
-const char* fragmentShaderSource = R"(
-#version 330 core
-in vec3 ourColor;
-out vec4 FragColor;
+// --headless saida.ppm [--frames N] [--threads N]: render por software, sem janela nem GPU
+int RunHeadless(const std::string& outputPath, int frames, unsigned int threads) {
+    P3D::Scene scene;
+    P3D::BuildPoolScene(scene, "models/");
+
+    P3D::SoftwareRasterizer backend(threads);
+    if (!backend.Init(scene, SCR_WIDTH, SCR_HEIGHT)) {
+        std::cerr << "Falha a inicializar o rasterizador por software" << std::endl;
+        return -1;
+    }
+
+    P3D::Camera camera = P3D::OrbitCamera(camDistance, camYaw, camPitch, (float)SCR_WIDTH / (float)SCR_HEIGHT);
+    P3D::PassStats mainStats, miniStats;
+    double totalMs = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        mainStats.Reset();
+        miniStats.Reset();
+        auto start = std::chrono::steady_clock::now();
+        P3D::RenderFrame(backend, camera, mainStats, miniStats);
+        totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::vector<unsigned char> pixels;
+    backend.ReadPixels(pixels);
+    bool saved = P3D::WritePPM(outputPath, SCR_WIDTH, SCR_HEIGHT, pixels);
 
-void main(){
-    FragColor = vec4(ourColor,1.0);
+    std::printf("%s (%u threads): %d frames, %.3f ms/frame | principal: %u/%u visiveis | minimapa: %u/%u\n",
+        backend.GetName(), backend.GetThreadCount(), frames, totalMs / frames,
+        mainStats.cull.visible, mainStats.cull.tested, miniStats.cull.visible, miniStats.cull.tested);
+    backend.Shutdown();
+    return saved ? 0 : -1;
 }
-)";
-
-
-// Função para compilar shader e checar erros
-unsigned int CompileShader(unsigned int type, const char* source) {
-    unsigned int shader = glCreateShader(type);
-    glShaderSource(shader, 1, &source, nullptr);
-    glCompileShader(shader);
-    int success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        std::cout << "Erro shader: " << infoLog << std::endl;
+
+// Tempo de cada programa desde o pedido até o driver o dar como pronto
+void PrintShaderReport() {
+    const P3D::ShaderCache& shaders = P3D::ShaderCache::Instance();
+    const P3D::ShaderCacheStats& stats = shaders.GetStats();
+    std::printf("Shaders: %u da cache, %u compilados, %u recusados, %.1f ms na thread GL (compilacao paralela: %s)\n",
+        stats.loaded, stats.compiled, stats.rejected, stats.milliseconds, shaders.UsesParallelCompile() ? "sim" : "nao");
+    for (const P3D::ShaderProgramInfo& info : shaders.GetPrograms()) {
+        double ms = std::chrono::duration<double, std::milli>(info.readyTime - info.submitTime).count();
+        std::printf("  %-16s %-9s %7.1f ms%s\n", info.name.c_str(), info.fromBinary ? "binario" : "compilado", ms,
+            info.failed ? " (falhou)" : "");
     }
-    return shader;
 }
 
-// Função para criar programa shader
-unsigned int CreateShaderProgram(const char* vertexSrc, const char* fragSrc) {
-    unsigned int vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSrc);
-    unsigned int fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragSrc);
-
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-
-    int success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        std::cout << "Erro link shader program: " << infoLog << std::endl;
+// Memória de CPU e GPU que cada asset ocupa depois dos envios; a tabela só com --memory-report
+void PrintMemoryReport(const P3D::GLRenderBackend& backend, bool detailed) {
+    std::vector<P3D::AssetMemory> report;
+    backend.GetMemoryReport(report);
+    size_t cpuBytes = 0, gpuBytes = 0;
+    for (const P3D::AssetMemory& memory : report) {
+        cpuBytes += memory.cpuBytes;
+        gpuBytes += memory.gpuBytes;
     }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    std::printf("Memoria residente: %.1f KB na CPU, %.1f KB na GPU (%u assets)\n",
+        cpuBytes / 1024.0, gpuBytes / 1024.0, static_cast<unsigned int>(report.size()));
+    if (!detailed) return;
+    for (const P3D::AssetMemory& memory : report) {
+        std::printf("  %-20s %-9s CPU %9.1f KB  GPU %9.1f KB\n", memory.name.c_str(), memory.residency.c_str(),
+            memory.cpuBytes / 1024.0, memory.gpuBytes / 1024.0);
+    }
+}
 
-    return program;
+// Fecha o trace do arranque (--startup-trace) e grava os relatórios em directory. A
+// compilação de cada programa entra numa linha própria, do pedido até ser visto pronto.
+void FinishStartupTrace(const std::string& directory) {
+    P3D::StartupTrace& trace = P3D::StartupTrace::Instance();
+    for (const P3D::ShaderProgramInfo& info : P3D::ShaderCache::Instance().GetPrograms()) {
+        if (!info.ready) continue;
+        trace.AddSpan("driver: " + info.name, info.fromBinary ? "shader.binario" : "shader.compilar", info.name,
+            trace.ToTraceMs(info.submitTime), trace.ToTraceMs(info.readyTime));
+    }
+    trace.Finish();
+    trace.PrintSummary();
+    if (trace.WriteReports(directory)) {
+        std::printf("Trace do arranque gravado em %s (startup.folded, startup.trace.json, startup.summary.json)\n", directory.c_str());
+    }
 }
 
 
-int main() {
+int main(int argc, char** argv) {
+    // Modos sem janela: não tocam em GLFW/GLEW
+    if (argc >= 3 && std::string(argv[1]) == "--headless") {
+        int frames = 1;
+        unsigned int threads = 0;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string option = argv[i];
+            if (option == "--frames") frames = std::max(1, std::atoi(argv[i + 1]));
+            else if (option == "--threads") threads = static_cast<unsigned int>(std::atoi(argv[i + 1]));
+        }
+        return RunHeadless(argv[2], frames, threads);
+    }
+
+    // --bench-loaders [--max-faces N] [--dir pasta/] [--keep]: compara os loaders de .obj
+    if (argc >= 2 && std::string(argv[1]) == "--bench-loaders") {
+        P3D::LoaderBenchmarkOptions options;
+        options.executablePath = argv[0];
+        for (int i = 2; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--keep") options.keepFiles = true;
+            else if (option == "--max-faces" && i + 1 < argc) options.maxFaces = std::strtoull(argv[++i], nullptr, 10);
+            else if (option == "--dir" && i + 1 < argc) options.directory = argv[++i];
+        }
+        return P3D::RunLoaderBenchmark(options);
+    }
+    // Uso interno do --bench-loaders: uma medição por processo
+    if (argc >= 4 && std::string(argv[1]) == "--bench-loader-run") {
+        return P3D::RunLoaderBenchmarkChild(argv[2], argv[3]);
+    }
+
+    // --bake-textures [--force] [imagens ou pastas...]: gera os .p3dtex (mipmaps + BC1/BC3) que a
+    // TextureCache envia sem descodificar; sem argumentos processa a pasta models/
+    if (argc >= 2 && std::string(argv[1]) == "--bake-textures") {
+        std::vector<std::string> inputs;
+        bool force = false;
+        for (int i = 2; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--force") force = true;
+            else inputs.push_back(option);
+        }
+        if (inputs.empty()) inputs.push_back("models/");
+        return P3D::RunTextureBaker(inputs, force);
+    }
+
+    // --bench-decode [--iterations N] [imagens ou pastas...]: stb_image vs DecodeJPEG (1, 1/2, 1/4, 1/8);
+    // sem argumentos usa as texturas das bolas em models/
+    if (argc >= 2 && std::string(argv[1]) == "--bench-decode") {
+        std::vector<std::string> inputs;
+        int iterations = 5;
+        for (int i = 2; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--iterations" && i + 1 < argc) iterations = std::atoi(argv[++i]);
+            else inputs.push_back(option);
+        }
+        if (inputs.empty()) inputs.push_back("models/");
+        return P3D::RunDecodeBenchmark(inputs, iterations);
+    }
+
+    // --bench-vertex-formats [--slices N] [--draws N] [--frames N]: memória e tempo de desenho
+    // de Float32, Compact e Quantized numa esfera densa (janela escondida)
+    if (argc >= 2 && std::string(argv[1]) == "--bench-vertex-formats") {
+        P3D::VertexFormatBenchmarkOptions options;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            std::string option = argv[i];
+            if (option == "--slices") options.slices = std::atoi(argv[i + 1]);
+            else if (option == "--draws") options.draws = std::atoi(argv[i + 1]);
+            else if (option == "--frames") options.frames = std::atoi(argv[i + 1]);
+        }
+        return P3D::RunVertexFormatBenchmark(options);
+    }
+
+    // --regress [pasta] [--update] [--threads N] [--max-slowdown 0.2]: imagens e tempos de referência
+    if (argc >= 2 && std::string(argv[1]) == "--regress") {
+        P3D::RegressionOptions options;
+        int i = 2;
+        if (i < argc && argv[i][0] != '-') {
+            options.goldenDirectory = argv[i++];
+            if (options.goldenDirectory.back() != '/' && options.goldenDirectory.back() != '\\') {
+                options.goldenDirectory += '/';
+            }
+        }
+        for (; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--update") options.update = true;
+            else if (option == "--threads" && i + 1 < argc) options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+            else if (option == "--max-slowdown" && i + 1 < argc) options.maxSlowdown = static_cast<float>(std::atof(argv[++i]));
+        }
+        return P3D::RunRegressionSuite(options);
+    }
+
+    // --texture-budget MB: VRAM para texturas sem referências antes de serem despejadas (0 = sem limite)
+    // --ball-impostors: bolas como quads com interseção raio-esfera em vez de malhas
+    // --continuous: desenha todos os frames mesmo sem mudanças (sem o modo on-demand)
+    // --dynamic-resolution [ms]: escala a vista principal para manter o tempo de frame (16.7 ms)
+    // --no-shader-cache: compila sempre os shaders, sem ler nem gravar shadercache/
+    // --no-io-uring: lê os ficheiros das bolas com o pool de threads mesmo com io_uring
+    // --hot-reload: relê os .mtl e texturas das bolas quando mudam no disco, sem reiniciar
+    // --memory-report: memória de CPU e GPU de cada malha e textura depois do carregamento
+    // --startup-trace [pasta]: linha do tempo do arranque até ao primeiro frame (startuptrace/)
+    // --exit-after-startup: fecha a janela depois de gravar o trace (para jobs de benchmark)
+    P3D::StartupTrace& trace = P3D::StartupTrace::Instance();
+    std::string traceDirectory;
+    bool exitAfterStartup = false;
+    bool hotReload = false;
+    bool memoryReport = false;
+    P3D::BallRenderMode ballMode = P3D::BallRenderMode::Mesh;
+    bool dynamicResolution = false;
+    P3D::DynamicResolutionSettings resolutionSettings;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--texture-budget" && i + 1 < argc) {
+            P3D::TextureCache::Instance().SetBudget(std::strtoull(argv[++i], nullptr, 10) << 20);
+        }
+        else if (option == "--ball-impostors") {
+            ballMode = P3D::BallRenderMode::Impostor;
+        }
+        else if (option == "--continuous") {
+            frameScheduler.SetOnDemand(false);
+        }
+        else if (option == "--no-shader-cache") {
+            P3D::ShaderCache::Instance().SetDirectory("");
+        }
+        else if (option == "--hot-reload") {
+            hotReload = true;
+        }
+        else if (option == "--memory-report") {
+            memoryReport = true;
+        }
+        else if (option == "--no-io-uring") {
+            P3D::FileBatch::SetUseIoUring(false);
+        }
+        else if (option == "--startup-trace") {
+            trace.Enable();
+            traceDirectory = "startuptrace/";
+            if (i + 1 < argc && argv[i + 1][0] != '-') traceDirectory = argv[++i];
+        }
+        else if (option == "--exit-after-startup") {
+            exitAfterStartup = true;
+        }
+        else if (option == "--dynamic-resolution") {
+            dynamicResolution = true;
+            if (i + 1 < argc && std::atof(argv[i + 1]) > 0.0) {
+                resolutionSettings.targetFrameMs = static_cast<float>(std::atof(argv[++i]));
+            }
+        }
+    }
+
     // Inicializar GLFW
+    P3D::TraceScope glfwScope("glfwInit");
     if (!glfwInit()) {
         std::cout << "Falha a inicializar GLFW" << std::endl;
         return -1;
     }
+    glfwScope.End();
 
     // Criar janela
+    P3D::TraceScope windowScope("glfwCreateWindow");
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Mesa de Bilhar - Passo 1", NULL, NULL);
     if (!window) {
         std::cout << "Falha a criar janela GLFW" << std::endl;
@@ -187,120 +330,140 @@ int main() {
         return -1;
     }
     glfwMakeContextCurrent(window);
+    windowScope.End();
 
     // Callbacks
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_pos_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
 
     // Inicializar GLEW
+    P3D::TraceScope glewScope("glewInit");
     glewExperimental = GL_TRUE;
     if (glewInit() != GLEW_OK) {
         std::cout << "Falha a inicializar GLEW" << std::endl;
         return -1;
     }
+    glewScope.End();
+    if (trace.IsRecording()) {
+        trace.SetMetadata("gl_renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+        trace.SetMetadata("gl_version", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+        trace.SetMetadata("bolas", ballMode == P3D::BallRenderMode::Impostor ? "impostor" : "malha");
+        trace.SetMetadata("cache_shaders", P3D::ShaderCache::Instance().GetDirectory().empty() ? "nao" : "sim");
+    }
 
-    // Configurar viewport
-    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-
-    // Criar shader program
-    unsigned int shaderProgram = CreateShaderProgram(vertexShaderSource, fragmentShaderSource);
-
-    // Setup VAO e VBO
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // posição
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // cor
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
+    // Mesa e bolas descritas uma vez, partilhadas com o rasterizador por software
+    P3D::TraceScope sceneScope("cena");
+    P3D::Scene scene;
+    P3D::BuildPoolScene(scene, "models/");
+    sceneScope.End();
+
+    P3D::TraceScope initScope("GLRenderBackend::Init");
+    P3D::GLRenderBackend backend(ballMode);
+    if (dynamicResolution) backend.EnableDynamicResolution(resolutionSettings);
+    if (!backend.Init(scene, SCR_WIDTH, SCR_HEIGHT)) {
+        std::cout << "Falha a inicializar o renderer OpenGL" << std::endl;
+        return -1;
+    }
+    initScope.End();
+    const P3D::TaskGraphStats& loadStats = backend.GetLoadStats();
+    std::printf("Bolas: %u tarefas em %u threads, %.1f ms (soma %.1f ms, caminho critico %.1f ms, thread GL %.1f ms)\n",
+        loadStats.tasks, loadStats.workers, loadStats.wallMs, loadStats.workMs, loadStats.criticalPathMs, loadStats.glThreadMs);
+    const P3D::FileBatchStats& fileStats = backend.GetLoadFileStats();
+    std::printf("Ficheiros das bolas: %u lidos com %s, %.1f KB em %.1f ms (%u falharam)\n",
+        fileStats.files, fileStats.backend, fileStats.bytes / 1024.0, fileStats.milliseconds, fileStats.failed);
+    // A geometria da cena já está no lote estático (e na GPU): a descrição fica sem ela
+    for (P3D::SceneMesh& mesh : scene.meshes) {
+        P3D::FreeVector(mesh.vertices);
+        P3D::FreeVector(mesh.indices);
+    }
+    PrintMemoryReport(backend, memoryReport);
+    // O watcher e a thread de recarregamento acordam o loop, que pode estar a dormir no
+    // glfwWaitEventsTimeout
+    if (hotReload && !backend.EnableHotReload([]() { glfwPostEmptyEvent(); })) {
+        std::cout << "Recarregamento a quente indisponivel" << std::endl;
+        hotReload = false;
+    }
+    bool shadersReported = false;
 
-    // Ativar profundidade
-    glEnable(GL_DEPTH_TEST);
+    // Estatísticas de culling e de mudanças de estado por passo (do último frame desenhado) e
+    // atividade do loop, mostradas no título uma vez por segundo
+    P3D::PassStats mainStats, miniStats;
+    P3D::SchedulerStats loopStats;
+    double lastStatsTime = glfwGetTime();
+    frameScheduler.SampleStats(lastStatsTime, 1.0, loopStats);
 
     // Loop principal
     while (!glfwWindowShouldClose(window)) {
-        // Limpar tela
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        glUseProgram(shaderProgram);
-
-        // Calcular posição da câmera orbital
-        float camX = camDistance * cos(glm::radians(camPitch)) * sin(glm::radians(camYaw));
-        float camY = camDistance * sin(glm::radians(camPitch));
-        float camZ = camDistance * cos(glm::radians(camPitch)) * cos(glm::radians(camYaw));
-        glm::vec3 cameraPos = glm::vec3(camX, camY, camZ);
-        glm::vec3 target = glm::vec3(0, 0, 0);
-        glm::vec3 up = glm::vec3(0, 1, 0);
-
-        glm::mat4 view = glm::lookAt(cameraPos, target, up);
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        glm::mat4 model = glm::mat4(1.0f);
-
-        // Passar matrizes para o shader
-        unsigned int modelLoc = glGetUniformLocation(shaderProgram, "model");
-        unsigned int viewLoc = glGetUniformLocation(shaderProgram, "view");
-        unsigned int projLoc = glGetUniformLocation(shaderProgram, "projection");
-
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection[0][0]);
-
-        // Desenhar mesa
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, sizeof(indices) / sizeof(unsigned int), GL_UNSIGNED_INT, 0);
-
-        // --- MINIMAPA ---
-        // Viewport pequeno no canto superior direito
-        int miniSize = 200;
-        glViewport(SCR_WIDTH - miniSize - 10, SCR_HEIGHT - miniSize - 10, miniSize, miniSize);
-        glClear(GL_DEPTH_BUFFER_BIT); // limpar depth para desenhar minimapa
-
-        // Câmera top-down para minimapa
-        glm::vec3 miniCamPos = glm::vec3(0, 10, 0);
-        glm::vec3 miniTarget = glm::vec3(0, 0, 0);
-        glm::vec3 miniUp = glm::vec3(0, 0, -1); // para olhar "para frente"
-
-        glm::mat4 miniView = glm::lookAt(miniCamPos, miniTarget, miniUp);
-        glm::mat4 miniProjection = glm::ortho(-2.0f, 2.0f, -2.0f, 2.0f, 0.1f, 20.0f);
-
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &miniView[0][0]);
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, &miniProjection[0][0]);
-
-        glDrawElements(GL_TRIANGLES, sizeof(indices) / sizeof(unsigned int), GL_UNSIGNED_INT, 0);
-
-        // Voltar viewport normal
-        glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // Materiais relidos em segundo plano entram aqui, entre dois frames
+        if (hotReload && backend.ApplyReloads()) frameScheduler.Invalidate();
+
+        double now = glfwGetTime();
+        if (frameScheduler.NeedsFrame(now)) {
+            // Só regista enquanto o trace do arranque estiver aberto
+            P3D::TraceScope frameScope("frame");
+            mainStats.Reset();
+            miniStats.Reset();
+
+            P3D::TraceScope renderScope("RenderFrame");
+            P3D::Camera camera = P3D::OrbitCamera(camDistance, camYaw, camPitch, (float)SCR_WIDTH / (float)SCR_HEIGHT);
+            P3D::RenderFrame(backend, camera, mainStats, miniStats);
+            renderScope.End();
+
+            P3D::TraceScope swapScope("glfwSwapBuffers");
+            glfwSwapBuffers(window);
+            swapScope.End();
+            trace.Mark("primeiro-frame");
+            frameScheduler.FrameRendered();
+
+            // Ia parar num frame desenhado a escala reduzida: mais um à escala máxima
+            if (!frameScheduler.NeedsFrame(glfwGetTime()) && backend.SettleResolution()) frameScheduler.Invalidate();
+
+            // Shaders ainda a compilar: continua a desenhar para os trocar assim que prontos
+            if (backend.HasPendingPrograms()) frameScheduler.Invalidate();
+            else if (!shadersReported) {
+                PrintShaderReport();
+                shadersReported = true;
+
+                // Primeiro frame com todos os programas: fim do arranque
+                frameScope.End();
+                if (trace.IsRecording()) {
+                    trace.Mark("primeiro-frame-completo");
+                    FinishStartupTrace(traceDirectory);
+                    if (exitAfterStartup) glfwSetWindowShouldClose(window, GLFW_TRUE);
+                }
+            }
+        }
+
+        now = glfwGetTime();
+        if (frameScheduler.SampleStats(now, 1.0, loopStats)) {
+            char title[384];
+            int length = std::snprintf(title, sizeof(title),
+                "Mesa de Bilhar - Passo 1 | principal: %u/%u visiveis, %u mudancas de estado | minimapa: %u/%u, %u"
+                " | %s: %.0f fps, %.0f wakeups/s, CPU %.1f%%",
+                mainStats.cull.visible, mainStats.cull.tested, mainStats.render.StateChanges(),
+                miniStats.cull.visible, miniStats.cull.tested, miniStats.render.StateChanges(),
+                loopStats.idle ? "parado" : "ativo", loopStats.FramesPerSecond(), loopStats.WakeupsPerSecond(),
+                loopStats.cpuPercent);
+            if (backend.UsesDynamicResolution() && length > 0 && length < (int)sizeof(title)) {
+                const P3D::ResolutionController& controller = backend.GetResolutionController();
+                std::snprintf(title + length, sizeof(title) - length, " | escala %.2f (CPU %.1f ms, GPU %.1f ms)",
+                    controller.GetScale(), controller.GetFilteredCpuMs(), controller.GetFilteredGpuMs());
+            }
+            glfwSetWindowTitle(window, title);
+            lastStatsTime = now;
+        }
+
+        // Sem frame pendente dorme até ao próximo evento ou à próxima atualização do título
+        frameScheduler.ProcessEvents(lastStatsTime + 1.0);
     }
 
-    // Limpar buffers
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glDeleteProgram(shaderProgram);
+    // Limpar recursos GL antes de destruir o contexto
+    backend.Shutdown();
 
     glfwDestroyWindow(window);
     glfwTerminate();
 
     return 0;
-}
\ No newline at end of file
+}
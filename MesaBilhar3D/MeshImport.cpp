@@ -0,0 +1,796 @@
+#include "MeshImport.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <sys/stat.h>
+
+#include "mapbox/earcut.hpp"
+#include "StartupTrace.h"
+
+namespace P3D {
+
+    static const char CACHE_MAGIC[4] = { 'P', '3', 'D', 'M' };
+    static const uint32_t CACHE_VERSION = 1;
+
+    // Blocos mais pequenos do que isto não compensam uma thread
+    static const size_t PARALLEL_MIN_CHUNK = 256 * 1024;
+
+    // Canto de face tal como está no .obj: índices 1-based, 0 = atributo ausente.
+    // Os índices negativos (relativos ao fim da lista) são convertidos para 0-based em
+    // relação ao início do bloco e marcados em relative, porque um bloco não sabe
+    // quantos vértices vieram nos blocos anteriores.
+    struct FaceCorner {
+        int index[3];           // v, vt, vn
+        uint8_t relative;       // bit i: index[i] é relativo ao bloco
+    };
+
+    struct MaterialSwitch {
+        size_t face;            // primeira face do bloco com este material
+        std::string name;
+    };
+
+    // Resultado do parse de um bloco de linhas inteiras
+    struct ObjChunk {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        std::vector<FaceCorner> corners;
+        std::vector<uint32_t> faceSizes;    // número de cantos de cada face
+        std::vector<MaterialSwitch> switches;
+        std::string mtllib;
+    };
+
+    // Cabeçalho da cache binária; seguem-se vértices, índices, submeshes e strings
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t reserved;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t submeshCount;
+        uint64_t materialCount;
+    };
+
+    static std::string DirectoryOf(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // Tamanho e data de modificação (segundos) do ficheiro
+    static bool FileStamp(const std::string& path, uint64_t& size, int64_t& time) {
+#ifdef _WIN32
+        struct _stat64 info;
+        if (_stat64(path.c_str(), &info) != 0) return false;
+#else
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+#endif
+        size = static_cast<uint64_t>(info.st_size);
+        time = static_cast<int64_t>(info.st_mtime);
+        return true;
+    }
+
+    // ---------------------------------------------------------------- parse do .obj
+    // O buffer termina sempre em '\n', por isso as funções de uma linha param no fim
+    // da linha sem testar o fim do buffer.
+
+    static bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+    static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+    static bool IsLineEnd(char c) { return c == '\n' || c == '\r'; }
+
+    static const char* SkipSpaces(const char* p) {
+        while (IsSpace(*p)) ++p;
+        return p;
+    }
+
+    static const char* NextLine(const char* p, const char* end) {
+        while (p < end && *p != '\n') ++p;
+        return p < end ? p + 1 : end;
+    }
+
+    static bool StartsWith(const char* p, const char* keyword, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            if (p[i] != keyword[i]) return false;
+        }
+        return IsSpace(p[length]);
+    }
+
+    static double Pow10(int exponent) {
+        static const double table[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        return exponent <= 22 ? table[exponent] : std::pow(10.0, exponent);
+    }
+
+    // Número decimal sem locale (ao contrário de istream/strtof); falso se não houver dígitos
+    static bool ParseFloat(const char*& p, float& value) {
+        p = SkipSpaces(p);
+        bool negative = *p == '-';
+        if (*p == '-' || *p == '+') ++p;
+
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int digits = 0;
+        bool any = false;
+        for (; IsDigit(*p); ++p, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) ++digits;
+            }
+            else {
+                ++exponent;
+            }
+        }
+        if (*p == '.') {
+            for (++p; IsDigit(*p); ++p, any = true) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    if (mantissa) ++digits;
+                    --exponent;
+                }
+            }
+        }
+        if (!any) return false;
+
+        if (*p == 'e' || *p == 'E') {
+            const char* q = p + 1;
+            bool negativeExponent = *q == '-';
+            if (*q == '-' || *q == '+') ++q;
+            if (IsDigit(*q)) {
+                int e = 0;
+                for (; IsDigit(*q); ++q) e = std::min(e * 10 + (*q - '0'), 1000);
+                exponent += negativeExponent ? -e : e;
+                p = q;
+            }
+        }
+
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / Pow10(-exponent) : result * Pow10(exponent);
+        value = static_cast<float>(negative ? -result : result);
+        return true;
+    }
+
+    static bool ParseInt(const char*& p, int& value) {
+        bool negative = *p == '-';
+        if (*p == '-' || *p == '+') ++p;
+        if (!IsDigit(*p)) return false;
+        int result = 0;
+        for (; IsDigit(*p); ++p) result = result * 10 + (*p - '0');
+        value = negative ? -result : result;
+        return true;
+    }
+
+    static std::string ParseName(const char* p) {
+        p = SkipSpaces(p);
+        const char* start = p;
+        while (!IsSpace(*p) && !IsLineEnd(*p)) ++p;
+        return std::string(start, p);
+    }
+
+    // Até count números seguidos; os que faltarem ficam como estavam
+    static void ParseFloats(const char* p, float* values, int count) {
+        for (int i = 0; i < count && ParseFloat(p, values[i]); ++i) {
+        }
+    }
+
+    static void SetCornerIndex(FaceCorner& corner, int slot, int value, size_t chunkCount) {
+        if (value < 0) {
+            corner.index[slot] = static_cast<int>(chunkCount) + value;
+            corner.relative |= static_cast<uint8_t>(1 << slot);
+        }
+        else {
+            corner.index[slot] = value;
+        }
+    }
+
+    // f v | v/vt | v//vn | v/vt/vn, com qualquer número de cantos (>= 3)
+    static void ParseFace(const char* p, ObjChunk& chunk) {
+        uint32_t count = 0;
+        for (;;) {
+            p = SkipSpaces(p);
+            if (IsLineEnd(*p) || *p == '#') break;
+
+            FaceCorner corner = { { 0, 0, 0 }, 0 };
+            int value;
+            bool valid = ParseInt(p, value);
+            if (valid) SetCornerIndex(corner, 0, value, chunk.positions.size());
+            if (valid && *p == '/') {
+                ++p;
+                if (*p != '/') {
+                    valid = ParseInt(p, value);
+                    if (valid) SetCornerIndex(corner, 1, value, chunk.texCoords.size());
+                }
+                if (valid && *p == '/') {
+                    ++p;
+                    valid = ParseInt(p, value);
+                    if (valid) SetCornerIndex(corner, 2, value, chunk.normals.size());
+                }
+            }
+            if (!valid || !(IsSpace(*p) || IsLineEnd(*p))) {
+                // Canto mal formado: a face inteira é ignorada
+                chunk.corners.resize(chunk.corners.size() - count);
+                return;
+            }
+            chunk.corners.push_back(corner);
+            ++count;
+        }
+
+        if (count >= 3) {
+            chunk.faceSizes.push_back(count);
+        }
+        else {
+            chunk.corners.resize(chunk.corners.size() - count);
+        }
+    }
+
+    static void ParseChunk(const char* p, const char* end, ObjChunk& chunk) {
+        while (p < end) {
+            p = SkipSpaces(p);
+            if (p[0] == 'v' && IsSpace(p[1])) {
+                glm::vec3 v(0.0f);
+                ParseFloats(p + 2, &v.x, 3);
+                chunk.positions.push_back(v);
+            }
+            else if (p[0] == 'v' && p[1] == 't' && IsSpace(p[2])) {
+                glm::vec2 vt(0.0f);
+                ParseFloats(p + 3, &vt.x, 2);
+                chunk.texCoords.push_back(vt);
+            }
+            else if (p[0] == 'v' && p[1] == 'n' && IsSpace(p[2])) {
+                glm::vec3 vn(0.0f);
+                ParseFloats(p + 3, &vn.x, 3);
+                chunk.normals.push_back(vn);
+            }
+            else if (p[0] == 'f' && IsSpace(p[1])) {
+                ParseFace(p + 2, chunk);
+            }
+            else if (StartsWith(p, "usemtl", 6)) {
+                MaterialSwitch materialSwitch;
+                materialSwitch.face = chunk.faceSizes.size();
+                materialSwitch.name = ParseName(p + 7);
+                chunk.switches.push_back(materialSwitch);
+            }
+            else if (StartsWith(p, "mtllib", 6) && chunk.mtllib.empty()) {
+                chunk.mtllib = ParseName(p + 7);
+            }
+            p = NextLine(p, end);
+        }
+    }
+
+    // Índice 0-based global de um atributo do canto; -1 se ausente, falso se fora da lista
+    static bool ResolveIndex(const FaceCorner& corner, int slot, size_t chunkOffset, size_t count, int& index) {
+        long long global;
+        if (corner.relative & (1 << slot)) {
+            global = static_cast<long long>(chunkOffset) + corner.index[slot];
+        }
+        else if (corner.index[slot] == 0) {
+            index = -1;
+            return true;
+        }
+        else {
+            global = static_cast<long long>(corner.index[slot]) - 1;
+        }
+        if (global < 0 || global >= static_cast<long long>(count)) return false;
+        index = static_cast<int>(global);
+        return true;
+    }
+
+    // Triangulação das faces com mais de 3 cantos. Os buffers são reutilizados de face
+    // para face; só os polígonos côncavos (earcut) alocam, para os nós internos do earcut.
+    class FaceTriangulator {
+    public:
+        // corners: posição de cada canto; vertexIndices: vértice de cada canto
+        void Triangulate(const std::vector<glm::vec3>& corners, const std::vector<unsigned int>& vertexIndices,
+            std::vector<unsigned int>& out) {
+            const size_t count = corners.size();
+            if (count == 3) {
+                Emit(vertexIndices, 0, 1, 2, out);
+                return;
+            }
+
+            // Normal de Newell: estável com cantos colineares e faces pouco planares
+            glm::vec3 normal(0.0f);
+            for (size_t i = 0; i < count; ++i) {
+                const glm::vec3& a = corners[i];
+                const glm::vec3& b = corners[(i + 1) % count];
+                normal.x += (a.y - b.y) * (a.z + b.z);
+                normal.y += (a.z - b.z) * (a.x + b.x);
+                normal.z += (a.x - b.x) * (a.y + b.y);
+            }
+
+            if (count == 4) {
+                // Quad: a diagonal 0-2 serve se os dois triângulos tiverem a orientação da face
+                // (sempre, se for convexo); senão o canto côncavo é o 1 ou o 3 e a diagonal é 1-3
+                if (Facing(corners[0], corners[1], corners[2], normal) && Facing(corners[0], corners[2], corners[3], normal)) {
+                    Emit(vertexIndices, 0, 1, 2, out);
+                    Emit(vertexIndices, 0, 2, 3, out);
+                }
+                else {
+                    Emit(vertexIndices, 1, 2, 3, out);
+                    Emit(vertexIndices, 1, 3, 0, out);
+                }
+                return;
+            }
+
+            if (IsConvex(corners, normal) || !Earcut(corners, normal, vertexIndices, out)) {
+                Fan(vertexIndices, out);
+            }
+        }
+
+    private:
+        typedef std::array<float, 2> Point;
+
+        std::vector<std::vector<Point>> polygon;    // um só anel (sem buracos)
+        mapbox::detail::Earcut<uint32_t> earcut;
+
+        static void Emit(const std::vector<unsigned int>& vertexIndices, size_t a, size_t b, size_t c,
+            std::vector<unsigned int>& out) {
+            out.push_back(vertexIndices[a]);
+            out.push_back(vertexIndices[b]);
+            out.push_back(vertexIndices[c]);
+        }
+
+        static void Fan(const std::vector<unsigned int>& vertexIndices, std::vector<unsigned int>& out) {
+            for (size_t i = 1; i + 1 < vertexIndices.size(); ++i) Emit(vertexIndices, 0, i, i + 1, out);
+        }
+
+        static bool Facing(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& normal) {
+            return glm::dot(glm::cross(b - a, c - a), normal) >= 0.0f;
+        }
+
+        // Cantos colineares contam como convexos (o leque só gera triângulos degenerados)
+        static bool IsConvex(const std::vector<glm::vec3>& corners, const glm::vec3& normal) {
+            const size_t count = corners.size();
+            for (size_t i = 0; i < count; ++i) {
+                const glm::vec3& a = corners[i];
+                const glm::vec3& b = corners[(i + 1) % count];
+                const glm::vec3& c = corners[(i + 2) % count];
+                if (glm::dot(glm::cross(b - a, c - b), normal) < 0.0f) return false;
+            }
+            return true;
+        }
+
+        // Earcut na projeção sobre o plano dos dois eixos que não dominam a normal.
+        // Falso se o polígono não der count - 2 triângulos (auto-interseções, degenerado).
+        bool Earcut(const std::vector<glm::vec3>& corners, const glm::vec3& normal,
+            const std::vector<unsigned int>& vertexIndices, std::vector<unsigned int>& out) {
+            const glm::vec3 magnitude = glm::abs(normal);
+            const int axis = magnitude.x > magnitude.y ? (magnitude.x > magnitude.z ? 0 : 2) : (magnitude.y > magnitude.z ? 1 : 2);
+            const int u = (axis + 1) % 3;
+            const int v = (axis + 2) % 3;
+
+            polygon.resize(1);
+            std::vector<Point>& ring = polygon[0];
+            ring.clear();
+            for (const glm::vec3& corner : corners) {
+                Point point = { { corner[u], corner[v] } };
+                ring.push_back(point);
+            }
+
+            earcut(polygon);
+            const std::vector<uint32_t>& triangles = earcut.indices;
+            if (triangles.size() != (corners.size() - 2) * 3) return false;
+
+            // Com (u, v) nesta ordem cíclica a área projetada tem o sinal de normal[axis];
+            // o earcut não garante a orientação, por isso compara-se com o primeiro triângulo
+            const Point& p0 = ring[triangles[0]];
+            const Point& p1 = ring[triangles[1]];
+            const Point& p2 = ring[triangles[2]];
+            float area = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]);
+            const bool flip = (area > 0.0f) != (normal[axis] > 0.0f);
+
+            for (size_t i = 0; i < triangles.size(); i += 3) {
+                if (flip) Emit(vertexIndices, triangles[i], triangles[i + 2], triangles[i + 1], out);
+                else Emit(vertexIndices, triangles[i], triangles[i + 1], triangles[i + 2], out);
+            }
+            return true;
+        }
+    };
+
+    template <typename T>
+    static void Concatenate(std::vector<ObjChunk>& chunks, std::vector<T> ObjChunk::* member, std::vector<T>& out) {
+        size_t total = 0;
+        for (const ObjChunk& chunk : chunks) total += (chunk.*member).size();
+        out.reserve(total);
+        for (ObjChunk& chunk : chunks) {
+            out.insert(out.end(), (chunk.*member).begin(), (chunk.*member).end());
+            std::vector<T>().swap(chunk.*member);
+        }
+    }
+
+    // Junta os blocos pela ordem do ficheiro: resolve os índices, cria um vértice por
+    // combinação v/vt/vn distinta, triangula e agrupa as faces por material
+    static bool AssembleMesh(std::vector<ObjChunk>& chunks, const std::string& objFilePath, MeshData& mesh) {
+        std::vector<size_t> positionOffsets, texCoordOffsets, normalOffsets;
+        size_t positionTotal = 0, texCoordTotal = 0, normalTotal = 0, cornerTotal = 0, faceTotal = 0;
+        for (const ObjChunk& chunk : chunks) {
+            positionOffsets.push_back(positionTotal);
+            texCoordOffsets.push_back(texCoordTotal);
+            normalOffsets.push_back(normalTotal);
+            positionTotal += chunk.positions.size();
+            texCoordTotal += chunk.texCoords.size();
+            normalTotal += chunk.normals.size();
+            cornerTotal += chunk.corners.size();
+            faceTotal += chunk.faceSizes.size();
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        Concatenate(chunks, &ObjChunk::positions, positions);
+        Concatenate(chunks, &ObjChunk::texCoords, texCoords);
+        Concatenate(chunks, &ObjChunk::normals, normals);
+
+        // Vértices já criados para cada posição, numa lista ligada (normalmente 1 a 4 entradas)
+        struct VertexLink {
+            int texCoord, normal;
+            int next;
+        };
+        std::vector<int> firstVertex(positions.size(), -1);
+        std::vector<VertexLink> links;
+        links.reserve(positions.size());
+        mesh.vertices.reserve(positions.size());
+        mesh.indices.reserve((cornerTotal - 2 * faceTotal) * 3);
+
+        std::unordered_map<std::string, uint32_t> materialIDs;
+        auto materialID = [&](const std::string& name) {
+            auto it = materialIDs.find(name);
+            if (it != materialIDs.end()) return it->second;
+            uint32_t id = static_cast<uint32_t>(mesh.materials.size());
+            MeshMaterial material;
+            material.name = name;
+            mesh.materials.push_back(material);
+            materialIDs.emplace(name, id);
+            return id;
+        };
+
+        // Um submesh por sequência de faces com o mesmo material
+        std::string currentMaterial;
+        unsigned int submeshStart = 0;
+        auto closeSubmesh = [&]() {
+            unsigned int end = static_cast<unsigned int>(mesh.indices.size());
+            if (end == submeshStart) return;
+            Submesh submesh = { submeshStart, end - submeshStart, materialID(currentMaterial) };
+            mesh.submeshes.push_back(submesh);
+            submeshStart = end;
+        };
+        auto switchMaterial = [&](const std::string& name) {
+            if (name == currentMaterial) return;
+            closeSubmesh();
+            currentMaterial = name;
+        };
+
+        FaceTriangulator triangulator;
+        std::vector<unsigned int> faceIndices;
+        std::vector<glm::vec3> facePositions;
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            ObjChunk& chunk = chunks[c];
+            if (mesh.mtlFilePath.empty() && !chunk.mtllib.empty()) {
+                mesh.mtlFilePath = DirectoryOf(objFilePath) + chunk.mtllib;
+            }
+
+            size_t corner = 0;
+            size_t nextSwitch = 0;
+            for (size_t face = 0; face < chunk.faceSizes.size(); ++face) {
+                for (; nextSwitch < chunk.switches.size() && chunk.switches[nextSwitch].face == face; ++nextSwitch) {
+                    switchMaterial(chunk.switches[nextSwitch].name);
+                }
+
+                const uint32_t size = chunk.faceSizes[face];
+                faceIndices.clear();
+                facePositions.clear();
+                for (uint32_t i = 0; i < size; ++i) {
+                    const FaceCorner& faceCorner = chunk.corners[corner + i];
+                    int v, vt, vn;
+                    if (!ResolveIndex(faceCorner, 0, positionOffsets[c], positions.size(), v) || v < 0 ||
+                        !ResolveIndex(faceCorner, 1, texCoordOffsets[c], texCoords.size(), vt) ||
+                        !ResolveIndex(faceCorner, 2, normalOffsets[c], normals.size(), vn)) {
+                        std::cerr << "Erro: índice de face inválido em " << objFilePath << std::endl;
+                        return false;
+                    }
+
+                    int found = -1;
+                    for (int k = firstVertex[v]; k >= 0; k = links[k].next) {
+                        if (links[k].texCoord == vt && links[k].normal == vn) {
+                            found = k;
+                            break;
+                        }
+                    }
+                    if (found < 0) {
+                        found = static_cast<int>(mesh.vertices.size());
+                        Vertex vertex;
+                        vertex.position = positions[v];
+                        vertex.texCoord = vt >= 0 ? texCoords[vt] : glm::vec2(0.0f);
+                        vertex.normal = vn >= 0 ? normals[vn] : glm::vec3(0.0f, 1.0f, 0.0f);
+                        mesh.vertices.push_back(vertex);
+                        VertexLink link = { vt, vn, firstVertex[v] };
+                        links.push_back(link);
+                        firstVertex[v] = found;
+                    }
+                    faceIndices.push_back(static_cast<unsigned int>(found));
+                    facePositions.push_back(positions[v]);
+                }
+
+                triangulator.Triangulate(facePositions, faceIndices, mesh.indices);
+                corner += size;
+            }
+            // usemtl depois da última face do bloco
+            for (; nextSwitch < chunk.switches.size(); ++nextSwitch) {
+                switchMaterial(chunk.switches[nextSwitch].name);
+            }
+            std::vector<FaceCorner>().swap(chunk.corners);
+        }
+        closeSubmesh();
+        return true;
+    }
+
+    // Ficheiro inteiro em memória, terminado em "\n\0"
+    static bool ReadFile(const std::string& filePath, std::vector<char>& data) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        size_t size = static_cast<size_t>(file.tellg());
+        data.resize(size + 2);
+        file.seekg(0);
+        file.read(data.data(), size);
+        if (static_cast<size_t>(file.gcount()) != size) return false;
+        data[size] = '\n';
+        data[size + 1] = '\0';
+        return true;
+    }
+
+    static bool ParseOBJ(const std::string& objFilePath, bool parallel, unsigned int threads, MeshData& mesh) {
+        std::vector<char> data;
+        if (!ReadFile(objFilePath, data)) {
+            std::cerr << "Erro ao abrir o arquivo OBJ: " << objFilePath << std::endl;
+            return false;
+        }
+        const size_t length = data.size() - 1;
+
+        size_t chunkCount = 1;
+        if (parallel) {
+            unsigned int threadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+            chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, length / PARALLEL_MIN_CHUNK));
+        }
+
+        // Fronteiras dos blocos sempre a seguir a um '\n'
+        std::vector<size_t> starts(chunkCount + 1, length);
+        starts[0] = 0;
+        for (size_t i = 1; i < chunkCount; ++i) {
+            size_t position = std::max(length * i / chunkCount, starts[i - 1]);
+            while (position < length && position > 0 && data[position - 1] != '\n') ++position;
+            starts[i] = position;
+        }
+
+        std::vector<ObjChunk> chunks(chunkCount);
+        auto parse = [&](size_t i) {
+            TraceScope scope("obj.bloco", objFilePath);
+            scope.AddBytes(starts[i + 1] - starts[i]);
+            ParseChunk(data.data() + starts[i], data.data() + starts[i + 1], chunks[i]);
+        };
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunkCount; ++i) {
+            workers.emplace_back(parse, i);
+        }
+        parse(0);
+        for (std::thread& worker : workers) worker.join();
+
+        std::vector<char>().swap(data);
+        return AssembleMesh(chunks, objFilePath, mesh);
+    }
+
+    // ---------------------------------------------------------------- materiais
+
+    // Preenche os materiais já referidos pelo .obj; os do .mtl sem faces são ignorados
+    static bool ParseMTL(const std::string& mtlFilePath, std::vector<MeshMaterial>& materials) {
+        std::ifstream file(mtlFilePath);
+        if (!file.is_open()) return false;
+
+        TraceScope scope("mtl", mtlFilePath);
+        std::string directory = DirectoryOf(mtlFilePath);
+        MeshMaterial* current = nullptr;
+        std::string line;
+        while (std::getline(file, line)) {
+            scope.AddBytes(line.size() + 1);
+            std::istringstream iss(line);
+            std::string prefix;
+            iss >> prefix;
+
+            if (prefix == "newmtl") {
+                std::string name;
+                iss >> name;
+                current = nullptr;
+                for (MeshMaterial& material : materials) {
+                    if (material.name == name) current = &material;
+                }
+            }
+            else if (!current) {
+                continue;
+            }
+            else if (prefix == "Ka") {
+                iss >> current->ambient.r >> current->ambient.g >> current->ambient.b;
+            }
+            else if (prefix == "Kd") {
+                iss >> current->diffuse.r >> current->diffuse.g >> current->diffuse.b;
+            }
+            else if (prefix == "Ks") {
+                iss >> current->specular.r >> current->specular.g >> current->specular.b;
+            }
+            else if (prefix == "Ns") {
+                iss >> current->shininess;
+            }
+            else if (prefix == "map_Kd") {
+                std::string textureFileName;
+                iss >> textureFileName;
+                current->diffuseMap = directory + textureFileName;
+            }
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- cache binária
+
+    std::string MeshCachePath(const std::string& objFilePath) {
+        size_t slash = objFilePath.find_last_of("/\\");
+        size_t dot = objFilePath.find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return objFilePath + ".p3dmesh";
+        return objFilePath.substr(0, dot) + ".p3dmesh";
+    }
+
+    static void WriteString(std::ofstream& file, const std::string& text) {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(text.data(), length);
+    }
+
+    static bool ReadString(std::ifstream& file, std::string& text) {
+        uint32_t length = 0;
+        if (!file.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > (1u << 16)) return false;
+        text.resize(length);
+        return length == 0 || static_cast<bool>(file.read(&text[0], length));
+    }
+
+    bool WriteMeshCache(const std::string& objFilePath, const MeshData& mesh) {
+        CacheHeader header = {};
+        if (!FileStamp(objFilePath, header.sourceSize, header.sourceTime)) return false;
+        std::copy(CACHE_MAGIC, CACHE_MAGIC + 4, header.magic);
+        header.version = CACHE_VERSION;
+        header.vertexSize = sizeof(Vertex);
+        header.vertexCount = mesh.vertices.size();
+        header.indexCount = mesh.indices.size();
+        header.submeshCount = mesh.submeshes.size();
+        header.materialCount = mesh.materials.size();
+
+        // Grava num temporário e só depois substitui, para nunca deixar uma cache a meio
+        std::string cachePath = MeshCachePath(objFilePath);
+        std::string temporaryPath = cachePath + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+            file.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+            file.write(reinterpret_cast<const char*>(mesh.submeshes.data()), mesh.submeshes.size() * sizeof(Submesh));
+            for (const MeshMaterial& material : mesh.materials) WriteString(file, material.name);
+            WriteString(file, mesh.mtlFilePath);
+            if (!file.good()) {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+        std::remove(cachePath.c_str());
+        return std::rename(temporaryPath.c_str(), cachePath.c_str()) == 0;
+    }
+
+    // Falso se a cache não existir, for de outra versão ou o .obj tiver mudado
+    static bool ReadMeshCache(const std::string& objFilePath, uint64_t sourceSize, int64_t sourceTime, MeshData& mesh) {
+        std::ifstream file(MeshCachePath(objFilePath), std::ios::binary);
+        if (!file.is_open()) return false;
+
+        CacheHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (!std::equal(CACHE_MAGIC, CACHE_MAGIC + 4, header.magic) || header.version != CACHE_VERSION ||
+            header.vertexSize != sizeof(Vertex) || header.sourceSize != sourceSize || header.sourceTime != sourceTime) {
+            return false;
+        }
+        // Limite grosseiro contra cabeçalhos corrompidos: nada maior do que o próprio .obj
+        if (header.vertexCount * sizeof(Vertex) > sourceSize * 16 || header.indexCount > sourceSize * 4 ||
+            header.submeshCount > header.indexCount || header.materialCount > header.indexCount + 1) {
+            return false;
+        }
+
+        mesh.vertices.resize(static_cast<size_t>(header.vertexCount));
+        mesh.indices.resize(static_cast<size_t>(header.indexCount));
+        mesh.submeshes.resize(static_cast<size_t>(header.submeshCount));
+        mesh.materials.resize(static_cast<size_t>(header.materialCount));
+        file.read(reinterpret_cast<char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+        file.read(reinterpret_cast<char*>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+        file.read(reinterpret_cast<char*>(mesh.submeshes.data()), mesh.submeshes.size() * sizeof(Submesh));
+        if (!file) return false;
+        for (MeshMaterial& material : mesh.materials) {
+            if (!ReadString(file, material.name)) return false;
+        }
+        if (!ReadString(file, mesh.mtlFilePath)) return false;
+
+        for (const Submesh& submesh : mesh.submeshes) {
+            if (submesh.material >= mesh.materials.size() ||
+                static_cast<uint64_t>(submesh.indexOffset) + submesh.indexCount > mesh.indices.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- API
+
+    const char* ImportBackendName(ImportBackend backend) {
+        switch (backend) {
+        case ImportBackend::Simple: return "simples";
+        case ImportBackend::Parallel: return "paralelo";
+        case ImportBackend::Cache: return "cache";
+        default: return "auto";
+        }
+    }
+
+    bool ImportMesh(const std::string& objFilePath, MeshData& mesh, const ImportOptions& options, ImportBackend* usedBackend) {
+        mesh = MeshData();
+
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+        if (!FileStamp(objFilePath, sourceSize, sourceTime)) {
+            std::cerr << "Erro ao abrir o arquivo OBJ: " << objFilePath << std::endl;
+            return false;
+        }
+        TraceScope scope("obj", objFilePath);
+        scope.AddBytes(sourceSize);
+
+        ImportBackend backend = options.backend;
+        bool fromCache = false;
+        if (backend == ImportBackend::Cache || (backend == ImportBackend::Auto && options.useCache)) {
+            fromCache = ReadMeshCache(objFilePath, sourceSize, sourceTime, mesh);
+            if (!fromCache) {
+                mesh = MeshData();
+                if (backend == ImportBackend::Cache) {
+                    std::cerr << "Cache em falta ou desatualizada: " << MeshCachePath(objFilePath) << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        if (fromCache) {
+            backend = ImportBackend::Cache;
+        }
+        else {
+            if (backend == ImportBackend::Auto) {
+                backend = sourceSize >= options.parallelMinBytes ? ImportBackend::Parallel : ImportBackend::Simple;
+            }
+            if (!ParseOBJ(objFilePath, backend == ImportBackend::Parallel, options.threads, mesh)) return false;
+
+            if (options.writeCache && sourceSize >= options.cacheMinBytes && !WriteMeshCache(objFilePath, mesh)) {
+                std::cerr << "Aviso: não foi possível gravar a cache " << MeshCachePath(objFilePath) << std::endl;
+            }
+        }
+        if (usedBackend) *usedBackend = backend;
+
+        // O .mtl não entra na cache: é pequeno e assim as alterações aparecem logo.
+        // Sem .mtl os materiais ficam com os valores por omissão.
+        if (!mesh.mtlFilePath.empty()) ParseMTL(mesh.mtlFilePath, mesh.materials);
+
+        if (!mesh.vertices.empty()) {
+            mesh.bounds = ComputeBounds(&mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex));
+        }
+        return true;
+    }
+
+} // namespace P3D
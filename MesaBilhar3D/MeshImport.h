@@ -0,0 +1,72 @@
+#ifndef MESHIMPORT_H
+#define MESHIMPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // Intervalo do índice partilhado desenhado com um só material
+    struct Submesh {
+        unsigned int indexOffset;
+        unsigned int indexCount;
+        uint32_t material;          // índice em MeshData::materials
+    };
+
+    // Material do .mtl (valores por omissão iguais aos do P3D::Model)
+    struct MeshMaterial {
+        std::string name;           // vazio = faces antes de qualquer usemtl
+        glm::vec3 ambient = glm::vec3(0.1f);
+        glm::vec3 diffuse = glm::vec3(0.8f);
+        glm::vec3 specular = glm::vec3(1.0f);
+        float shininess = 32.0f;
+        std::string diffuseMap;     // map_Kd, já com a pasta do .mtl
+    };
+
+    // Malha em CPU comum a todos os loaders: vértices intercalados sem duplicados
+    // (uma entrada por combinação v/vt/vn), faces trianguladas e agrupadas por material
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<Submesh> submeshes;
+        std::vector<MeshMaterial> materials;
+        std::string mtlFilePath;    // mtllib, já com a pasta do .obj; vazio se não houver
+        Bounds bounds;
+    };
+
+    enum class ImportBackend {
+        Auto,       // cache se for válida, senão Simple ou Parallel conforme o tamanho
+        Simple,     // parse numa só thread, sem custo de arranque
+        Parallel,   // ficheiro dividido em blocos de linhas, um por thread
+        Cache       // só a cache binária (falha se não existir ou estiver desatualizada)
+    };
+
+    struct ImportOptions {
+        ImportBackend backend = ImportBackend::Auto;
+        size_t parallelMinBytes = 1 << 20;  // Auto: abaixo disto o Simple é mais rápido
+        size_t cacheMinBytes = 1 << 20;     // só se grava cache para .obj a partir deste tamanho
+        bool useCache = true;
+        bool writeCache = true;
+        unsigned int threads = 0;           // 0 = std::thread::hardware_concurrency()
+    };
+
+    // Carrega um .obj (e os materiais do seu .mtl). usedBackend diz que backend foi usado.
+    bool ImportMesh(const std::string& objFilePath, MeshData& mesh,
+        const ImportOptions& options = ImportOptions(), ImportBackend* usedBackend = nullptr);
+
+    // Cache binária ao lado do .obj (mesmo nome, extensão .p3dmesh); é válida enquanto o
+    // tamanho e a data de modificação do .obj forem os que foram gravados no cabeçalho
+    std::string MeshCachePath(const std::string& objFilePath);
+    bool WriteMeshCache(const std::string& objFilePath, const MeshData& mesh);
+
+    const char* ImportBackendName(ImportBackend backend);
+
+} // namespace P3D
+
+#endif // MESHIMPORT_H
@@ -3,75 +3,195 @@
 #include <sstream>
 #include <iostream>
 
+#include "StartupTrace.h"
+#include "TextureCache.h"
+
 using namespace Pool3D;
 
+void MeshGroup::Setup(P3D::VertexFormat vertexFormat, P3D::MeshResidency residency) {
+    P3D::TraceScope scope("malha.enviar");
+    format = vertexFormat;
+    if (!vertices.empty()) {
+        bounds = P3D::ComputeBounds(&vertices[0].position, vertices.size(), sizeof(Vertex));
+    }
+
+    std::vector<unsigned char> packed;
+    P3D::PackVertices(vertices, format, packed, &quantization);
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+    P3D::SetupVertexAttributes(format, 0, 1, 2);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    scope.AddBytes(packed.size() + indices.size() * sizeof(unsigned int));
+
+    glBindVertexArray(0);
+
+    indexCount = indices.size();
+    gpuBytes = packed.size() + indexCount * sizeof(unsigned int);
+    // Os vértices do grupo já são compactos (só os usados pelos seus índices): as
+    // posições ficam com a mesma numeração
+    if (residency != P3D::MeshResidency::BoundsOnly) {
+        collisionPositions.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) collisionPositions[i] = vertices[i].position;
+    }
+    if (residency == P3D::MeshResidency::Full) return;
+    P3D::FreeVector(vertices);
+    if (residency == P3D::MeshResidency::BoundsOnly) P3D::FreeVector(indices);
+}
+
+size_t MeshGroup::GetCPUBytes() const {
+    return P3D::ReservedBytes(vertices) + P3D::ReservedBytes(indices) + P3D::ReservedBytes(collisionPositions);
+}
+
 Model::Model() {}
 
-Model::~Model() {}
+Model::~Model() {
+    // Grupos sem Install() (só LoadOBJ) não têm objetos GL
+    for (MeshGroup& group : meshGroups) {
+        if (group.VBO) glDeleteBuffers(1, &group.VBO);
+        if (group.EBO) glDeleteBuffers(1, &group.EBO);
+        if (group.VAO) glDeleteVertexArrays(1, &group.VAO);
+    }
+    for (Material& material : materials) {
+        P3D::TextureCache::Instance().Release(material.textureID);
+    }
+}
 
-bool Model::LoadOBJ(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+uint32_t Model::GetMaterialID(const std::string& name) {
+    auto it = materialIDs.find(name);
+    if (it != materialIDs.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(materials.size());
+    Material material;
+    material.name = name;
+    materials.push_back(material);
+    materialIDs.emplace(name, id);
+    return id;
+}
+
+bool Model::LoadOBJ(const std::string& filename, const P3D::ImportOptions& options) {
+    P3D::MeshData mesh;
+    if (!P3D::ImportMesh(filename, mesh, options)) {
         std::cerr << "Erro ao abrir o arquivo OBJ: " << filename << std::endl;
         return false;
     }
 
-    directory = filename.substr(0, filename.find_last_of('/'));
+    size_t slash = filename.find_last_of('/');
+    directory = (slash == std::string::npos) ? std::string() : filename.substr(0, slash + 1);
+    mtlFileName = mesh.mtlFilePath;
+
+    // Cada submesh vira um grupo com os seus próprios vértices (índices locais ao grupo)
+    std::vector<int> localIndex(mesh.vertices.size(), -1);
+    for (const P3D::Submesh& submesh : mesh.submeshes) {
+        const P3D::MeshMaterial& source = mesh.materials[submesh.material];
+        MeshGroup group;
+        group.materialID = GetMaterialID(source.name);
+        if (materials[group.materialID].diffuseTexPath.empty()) {
+            materials[group.materialID].diffuseTexPath = source.diffuseMap;
+        }
+
+        for (unsigned int i = submesh.indexOffset; i < submesh.indexOffset + submesh.indexCount; ++i) {
+            unsigned int index = mesh.indices[i];
+            if (localIndex[index] < 0) {
+                localIndex[index] = static_cast<int>(group.vertices.size());
+                group.vertices.push_back(mesh.vertices[index]);
+            }
+            group.indices.push_back(static_cast<unsigned int>(localIndex[index]));
+        }
+        for (unsigned int i = submesh.indexOffset; i < submesh.indexOffset + submesh.indexCount; ++i) {
+            localIndex[mesh.indices[i]] = -1;
+        }
+        meshGroups.push_back(std::move(group));
+    }
+    return true;
+}
+
+bool Model::LoadMTL(const std::string& mtlFilename) {
+    std::ifstream file(mtlFilename);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir o arquivo MTL: " << mtlFilename << std::endl;
+        return false;
+    }
+
+    size_t slash = mtlFilename.find_last_of('/');
+    std::string mtlDirectory = (slash == std::string::npos) ? std::string() : mtlFilename.substr(0, slash + 1);
+
+    P3D::TraceScope scope("mtl", mtlFilename);
 
+    // Guardar o índice e não um ponteiro: materials pode crescer durante o parse
+    int current = -1;
     std::string line;
     while (std::getline(file, line)) {
-        ProcessOBJLine(line);
-    }
+        scope.AddBytes(line.size() + 1);
+        std::istringstream iss(line);
+        std::string prefix;
+        iss >> prefix;
 
+        if (prefix == "newmtl") {
+            std::string name;
+            iss >> name;
+            current = static_cast<int>(GetMaterialID(name));
+        }
+        else if (prefix == "map_Kd" && current >= 0) {
+            std::string texPath;
+            iss >> texPath;
+            materials[current].diffuseTexPath = mtlDirectory + texPath;
+        }
+    }
     file.close();
+    scope.End();
+
+    for (Material& material : materials) {
+        if (!material.diffuseTexPath.empty() && material.textureID == 0) {
+            LoadTexture(material);
+        }
+    }
     return true;
 }
 
-void Model::ProcessOBJLine(const std::string& line) {
-    std::istringstream iss(line);
-    std::string prefix;
-    iss >> prefix;
+void Model::LoadTexture(Material& material) {
+    // Materiais de modelos diferentes com a mesma imagem partilham a textura
+    material.textureID = P3D::TextureCache::Instance().Acquire(material.diffuseTexPath);
+}
 
-    if (prefix == "v") {
-        glm::vec3 pos;
-        iss >> pos.x >> pos.y >> pos.z;
-        tempPositions.push_back(pos);
+void Model::Install(P3D::VertexFormat format, P3D::MeshResidency policy) {
+    residency = policy;
+    for (MeshGroup& group : meshGroups) {
+        group.Setup(format, residency);
     }
-    else if (prefix == "vt") {
-        glm::vec2 tex;
-        iss >> tex.x >> tex.y;
-        tempTexCoords.push_back(tex);
-    }
-    else if (prefix == "vn") {
-        glm::vec3 norm;
-        iss >> norm.x >> norm.y >> norm.z;
-        tempNormals.push_back(norm);
-    }
-    else if (prefix == "f") {
-        std::string vertexStr;
-        while (iss >> vertexStr) {
-            std::istringstream viss(vertexStr);
-            std::string v, t, n;
-
-            size_t p1 = vertexStr.find('/');
-            size_t p2 = vertexStr.find('/', p1 + 1);
-
-            int vi = std::stoi(vertexStr.substr(0, p1)) - 1;
-            int ti = std::stoi(vertexStr.substr(p1 + 1, p2 - p1 - 1)) - 1;
-            int ni = std::stoi(vertexStr.substr(p2 + 1)) - 1;
-
-            Vertex vertex;
-            vertex.position = tempPositions[vi];
-            vertex.texCoord = tempTexCoords[ti];
-            vertex.normal = tempNormals[ni];
-
-            vertices.push_back(vertex);
-            indices.push_back(static_cast<unsigned int>(vertices.size() - 1));
-        }
-    }
-    else if (prefix == "mtllib") {
-        iss >> mtlFileName;
-        std::cout << "Material file: " << mtlFileName << std::endl;
+}
+
+P3D::AssetMemory Model::GetMemory(const std::string& name) const {
+    P3D::AssetMemory memory;
+    memory.name = name;
+    memory.residency = P3D::ResidencyName(residency);
+    for (const MeshGroup& group : meshGroups) {
+        memory.cpuBytes += group.GetCPUBytes();
+        memory.gpuBytes += group.GetGPUBytes();
     }
+    return memory;
 }
 
+void Model::Draw(P3D::DrawQueue& queue, GLuint shaderProgram, const glm::mat4& model, float depth) {
+    for (const MeshGroup& group : meshGroups) {
+        if (!group.VAO) continue;
+
+        P3D::DrawCommand command;
+        command.program = shaderProgram;
+        command.texture = group.materialID < materials.size() ? materials[group.materialID].textureID : 0;
+        command.vao = group.VAO;
+        command.indexCount = static_cast<GLsizei>(group.indexCount);
+        command.model = model;
+        if (group.format == P3D::VertexFormat::Quantized) command.quantization = &group.quantization;
+        command.key = P3D::DrawQueue::MakeKey(command.program, command.texture, command.vao, depth);
+        queue.Add(command);
+    }
+}
@@ -3,17 +3,21 @@
 
 #include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
+#include <cstdint>
 #include <glm/glm.hpp>
-#include <glad/glad.h>
+#include <GL/glew.h>
+
+#include "DrawQueue.h"
+#include "Frustum.h"
+#include "MeshImport.h"
+#include "Residency.h"
+#include "VertexFormat.h"
 
 namespace Pool3D {
 
-    struct Vertex {
-        glm::vec3 position;
-        glm::vec2 texCoord;
-        glm::vec3 normal;
-    };
+    // Mesmo layout intercalado usado pelo P3D::Model
+    using Vertex = P3D::Vertex;
 
     struct Material {
         std::string name;
@@ -24,10 +28,23 @@ namespace Pool3D {
     struct MeshGroup {
         std::vector<Vertex> vertices;
         std::vector<unsigned int> indices;
-        std::string materialName;
+        std::vector<glm::vec3> collisionPositions;  // feitas no Setup, indexadas por indices
+        size_t indexCount = 0;    // sobrevive  libertao de indices
+        uint32_t materialID = 0;  // ndice em Model::materials
 
         GLuint VAO = 0, VBO = 0, EBO = 0;
-        void Setup();
+        P3D::VertexFormat format = P3D::VertexFormat::Float32;
+        P3D::QuantizationInfo quantization;
+        P3D::Bounds bounds;  // espao do modelo
+
+        // Depois do envio fica na CPU s o que residency pede (ver P3D::MeshResidency)
+        void Setup(P3D::VertexFormat vertexFormat = P3D::VertexFormat::Float32,
+            P3D::MeshResidency residency = P3D::MeshResidency::Positions);
+        size_t GetCPUBytes() const;
+        size_t GetGPUBytes() const { return gpuBytes; }
+
+    private:
+        size_t gpuBytes = 0;
     };
 
     class Model {
@@ -35,20 +52,37 @@ namespace Pool3D {
         Model();
         ~Model();
 
-        bool LoadOBJ(const std::string& filename); // Parte 1: carregar .obj
+        // Parte 1: carregar .obj (P3D::ImportMesh, um MeshGroup por submesh)
+        bool LoadOBJ(const std::string& filename, const P3D::ImportOptions& options = P3D::ImportOptions());
         bool LoadMTL(const std::string& mtlFilename); // Parte 2: carregar .mtl
-        void Draw(); // Parte 3: renderizar com texturas
+        void Install(P3D::VertexFormat format = P3D::VertexFormat::Float32,
+            P3D::MeshResidency residency = P3D::MeshResidency::Positions);
+        // Parte 3: renderizar com texturas (os draws so ordenados pela DrawQueue)
+        void Draw(P3D::DrawQueue& queue, GLuint shaderProgram, const glm::mat4& model, float depth);
+
+        const std::string& GetMTLFileName() const { return mtlFileName; }
+        const std::vector<MeshGroup>& GetMeshGroups() const { return meshGroups; }
+        // Soma dos grupos; as texturas so contadas na TextureCache
+        P3D::AssetMemory GetMemory(const std::string& name) const;
 
     private:
         std::string directory;
         std::string mtlFileName;
+        P3D::MeshResidency residency = P3D::MeshResidency::Positions;
 
         std::vector<MeshGroup> meshGroups;
-        std::map<std::string, Material> materials;
+
+        // Materiais internados: o ID de um material  o seu ndice neste vetor.
+        // O mapa de nomes s  usado durante o carregamento.
+        std::vector<Material> materials;
+        std::unordered_map<std::string, uint32_t> materialIDs;
 
         // Funes auxiliares
-        void ProcessOBJLine(const std::string& line);
         void LoadTexture(Material& material);
+        uint32_t GetMaterialID(const std::string& name);
+
+        Model(const Model&) = delete;
+        Model& operator=(const Model&) = delete;
     };
 
 } // namespace Pool3D
@@ -1,53 +1,33 @@
 #include "ObjLoader.hpp"
-#include <fstream>
-#include <sstream>
-#include <iostream>
-#include <glad/glad.h>
+#include <GL/glew.h>
 
-ObjLoader::ObjLoader(const std::string& path) {
+#include "MeshImport.h"
+#include "Residency.h"
+
+ObjLoader::ObjLoader(const std::string& path, bool upload)
+    : indexCount(0), VAO(0), VBO(0), EBO(0)
+{
     loadObj(path);
-    setupMesh();
+    if (!positions.empty()) {
+        bounds = P3D::ComputeBounds(&positions[0], positions.size(), sizeof(glm::vec3));
+    }
+    if (upload && !positions.empty()) setupMesh();
 }
 
 void ObjLoader::loadObj(const std::string& path) {
-    std::ifstream file(path);
-    std::string line;
-    std::vector<glm::vec3> temp_pos;
-    std::vector<glm::vec2> temp_tex;
-    std::vector<glm::vec3> temp_norm;
+    P3D::MeshData mesh;
+    if (!P3D::ImportMesh(path, mesh)) return;
 
-    while (std::getline(file, line)) {
-        std::istringstream ss(line);
-        std::string type;
-        ss >> type;
-
-        if (type == "v") {
-            glm::vec3 pos;
-            ss >> pos.x >> pos.y >> pos.z;
-            temp_pos.push_back(pos);
-        }
-        else if (type == "vt") {
-            glm::vec2 tex;
-            ss >> tex.x >> tex.y;
-            texCoords.push_back(tex);
-        }
-        else if (type == "vn") {
-            glm::vec3 norm;
-            ss >> norm.x >> norm.y >> norm.z;
-            temp_norm.push_back(norm);
-        }
-        else if (type == "f") {
-            unsigned int p, t, n;
-            char slash;
-            for (int i = 0; i < 3; i++) {
-                ss >> p >> slash >> t >> slash >> n;
-                positions.push_back(temp_pos[p - 1]);
-                if (!temp_tex.empty()) texCoords.push_back(texCoords[t - 1]);
-                if (!temp_norm.empty()) normals.push_back(temp_norm[n - 1]);
-                indices.push_back(indices.size());
-            }
-        }
+    positions.reserve(mesh.vertices.size());
+    texCoords.reserve(mesh.vertices.size());
+    normals.reserve(mesh.vertices.size());
+    for (const P3D::Vertex& vertex : mesh.vertices) {
+        positions.push_back(vertex.position);
+        texCoords.push_back(vertex.texCoord);
+        normals.push_back(vertex.normal);
     }
+    indices.swap(mesh.indices);
+    indexCount = indices.size();
 }
 
 void ObjLoader::setupMesh() {
@@ -81,11 +61,14 @@ void ObjLoader::setupMesh() {
     glEnableVertexAttribArray(1);
 
     glBindVertexArray(0);
+
+    P3D::FreeVector(texCoords);
+    P3D::FreeVector(normals);
 }
 
 void ObjLoader::draw() const {
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, 0);
 }
 
 unsigned int ObjLoader::getVAO() const {
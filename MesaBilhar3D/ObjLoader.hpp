@@ -0,0 +1,35 @@
+#ifndef OBJLOADER_HPP
+#define OBJLOADER_HPP
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+
+class ObjLoader {
+public:
+    // upload = false só faz o parse (sem contexto GL), ex.: no benchmark de loaders
+    ObjLoader(const std::string& path, bool upload = true);
+    void draw() const;
+    unsigned int getVAO() const;
+    size_t getVertexCount() const { return positions.size(); }
+    const P3D::Bounds& getBounds() const { return bounds; }
+
+private:
+    void loadObj(const std::string& path);
+    void setupMesh();
+
+    // Depois do envio só ficam as posições e os índices (picking); UVs e normais são
+    // libertados em setupMesh
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    std::vector<unsigned int> indices;
+    size_t indexCount;
+    P3D::Bounds bounds;
+
+    unsigned int VAO, VBO, EBO;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <cstdio>
 
@@ -12,74 +13,68 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// stb_image para carregar textura
+// stb_image para carregar textura (usado pela TextureCache e pelo rasterizador por software)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-namespace P3D {
-
-    class Model {
-    public:
-        Model();
-        ~Model();
-
-        bool Load(const std::string& objFilePath);
-        void Install();
-        void Render(GLuint shaderProgram, const glm::vec3& position, const glm::vec3& orientation);
-        void BindShaderAttributes(GLuint shaderProgram);
-
-    private:
-        // Dados do modelo
-        std::vector<glm::vec3> vertices;
-        std::vector<glm::vec2> texCoords;
-        std::vector<glm::vec3> normals;
-        std::vector<unsigned int> indices;
-
-        // Material
-        glm::vec3 Ka;
-        glm::vec3 Kd;
-        glm::vec3 Ks;
-        float Ns;
-
-        GLuint textureID;
+#include "P3D.h"
+#include "FileBatch.h"
+#include "Sphere.h"
+#include "StartupTrace.h"
+#include "TaskGraph.h"
+#include "TextureCache.h"
 
-        GLuint VAO;
-        GLuint VBO_Vertices;
-        GLuint VBO_TexCoords;
-        GLuint VBO_Normals;
-        GLuint EBO;
-
-        std::string mtlFileName;
-        std::string textureFileName;
+namespace P3D {
 
-        bool LoadOBJ(const std::string& objFilePath);
-        bool LoadMTL(const std::string& mtlFilePath);
-        bool LoadTexture(const std::string& textureFilePath);
+    static std::string DirectoryOf(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
 
-        void SetupBuffers();
-    };
+    float ProjectedRadius(const glm::mat4& view, const glm::mat4& projection,
+        const glm::vec3& center, float radius, int viewportHeight) {
+        // w = -z de vista em perspetiva, 1 em ortogrfica
+        glm::vec4 clip = projection * view * glm::vec4(center, 1.0f);
+        if (clip.w <= 0.0f) return 0.0f;
+        return radius * projection[1][1] * 0.5f * viewportHeight / clip.w;
+    }
 
     Model::Model()
-        : Ka(0.1f), Kd(0.8f), Ks(1.0f), Ns(32.0f),
+        : vertexCount(0), indexCount(0), residency(MeshResidency::Positions),
+        Ka(0.1f), Kd(0.8f), Ks(1.0f), Ns(32.0f),
         textureID(0),
-        VAO(0), VBO_Vertices(0), VBO_TexCoords(0), VBO_Normals(0), EBO(0)
+        VAO(0), VBO(0), EBO(0),
+        vertexFormat(VertexFormat::Float32), vertexBufferBytes(0)
     {
     }
 
     Model::~Model() {
-        glDeleteBuffers(1, &VBO_Vertices);
-        glDeleteBuffers(1, &VBO_TexCoords);
-        glDeleteBuffers(1, &VBO_Normals);
-        glDeleteBuffers(1, &EBO);
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteTextures(1, &textureID);
+        // Sem Install() no h objetos GL (nem contexto, no caso de LoadGeometry)
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        TextureCache::Instance().Release(textureID);
     }
 
-    bool Model::Load(const std::string& objFilePath) {
-        if (!LoadOBJ(objFilePath)) {
+    bool Model::LoadGeometry(const std::string& objFilePath, const ImportOptions& options) {
+        MeshData mesh;
+        if (!ImportMesh(objFilePath, mesh, options)) {
             std::cerr << "Erro ao carregar OBJ: " << objFilePath << std::endl;
             return false;
         }
+        // Um s material por modelo: os submeshes so desenhados juntos
+        vertices.swap(mesh.vertices);
+        indices.swap(mesh.indices);
+        mtlFileName = mesh.mtlFilePath;
+        BuildLODs();
+        vertexCount = vertices.size();
+        indexCount = indices.size();
+        return true;
+    }
+
+    bool Model::Load(const std::string& objFilePath) {
+        if (!LoadGeometry(objFilePath)) return false;
+
         if (!LoadMTL(mtlFileName)) {
             std::cerr << "Erro ao carregar MTL: " << mtlFileName << std::endl;
             return false;
@@ -91,96 +86,170 @@ namespace P3D {
         return true;
     }
 
-    bool Model::LoadOBJ(const std::string& objFilePath) {
-        std::ifstream file(objFilePath);
-        if (!file.is_open()) return false;
+    bool Model::LoadSphere(const std::string& mtlFilePath, float radius) {
+        BuildSphere(radius);
 
-        std::string line;
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string prefix;
-            iss >> prefix;
+        mtlFileName = mtlFilePath;
+        if (!LoadMTL(mtlFileName)) {
+            std::cerr << "Erro ao carregar MTL: " << mtlFileName << std::endl;
+            return false;
+        }
+        if (!LoadTexture(textureFileName)) {
+            std::cerr << "Erro ao carregar textura: " << textureFileName << std::endl;
+            return false;
+        }
+        return true;
+    }
 
-            if (prefix == "v") {
-                glm::vec3 v;
-                iss >> v.x >> v.y >> v.z;
-                vertices.push_back(v);
-            }
-            else if (prefix == "vt") {
-                glm::vec2 vt;
-                iss >> vt.x >> vt.y;
-                texCoords.push_back(vt);
-            }
-            else if (prefix == "vn") {
-                glm::vec3 vn;
-                iss >> vn.x >> vn.y >> vn.z;
-                normals.push_back(vn);
-            }
-            else if (prefix == "f") {
-                // Parse faces do tipo: v/vt/vn, v//vn, v/vt, ou apenas v
-                std::string vertexStr;
-                for (int i = 0; i < 3; ++i) {
-                    iss >> vertexStr;
-                    unsigned int vi = 0, ti = 0, ni = 0;
-
-                    size_t firstSlash = vertexStr.find('/');
-                    size_t lastSlash = vertexStr.rfind('/');
-
-                    if (firstSlash == std::string::npos) {
-                        // s vrtice
-                        vi = std::stoi(vertexStr);
-                    }
-                    else if (firstSlash == lastSlash) {
-                        // v/vt
-                        vi = std::stoi(vertexStr.substr(0, firstSlash));
-                        ti = std::stoi(vertexStr.substr(firstSlash + 1));
-                    }
-                    else {
-                        // v/vt/vn ou v//vn
-                        vi = std::stoi(vertexStr.substr(0, firstSlash));
-                        std::string middle = vertexStr.substr(firstSlash + 1, lastSlash - firstSlash - 1);
-                        if (!middle.empty()) {
-                            ti = std::stoi(middle);
-                        }
-                        ni = std::stoi(vertexStr.substr(lastSlash + 1));
-                    }
-
-                    indices.push_back(vi - 1);
-                    // Opcional: pode armazenar ti e ni se quiser usar
-                }
-            }
-            else if (prefix == "mtllib") {
-                iss >> mtlFileName;
-            }
+    void Model::BuildSphere(float radius) {
+        TraceScope scope("esfera");
+        vertices.clear();
+        indices.clear();
+        AppendSphere(vertices, indices, glm::vec3(0.0f), radius, SPHERE_LOD_SLICES[0], SPHERE_LOD_SLICES[0] / 2);
+        BuildLODs();
+        vertexCount = vertices.size();
+        indexCount = indices.size();
+    }
+
+    int Model::AddLoadTasks(TaskGraph& graph, const std::string& objFilePath, FileBatch* files) {
+        int geometry = graph.Add("modelo.obj", TaskQueue::Worker, [this, objFilePath]() {
+            return LoadGeometry(objFilePath);
+        });
+        // O caminho do .mtl s se sabe depois de ler o mtllib do .obj
+        return AddMaterialTasks(graph, geometry, { geometry }, files);
+    }
+
+    int Model::AddSphereTasks(TaskGraph& graph, const std::string& mtlFilePath, float radius, FileBatch* files) {
+        mtlFileName = mtlFilePath;
+        int geometry = graph.Add("modelo.esfera", TaskQueue::Worker, [this, radius]() {
+            BuildSphere(radius);
+            return true;
+        });
+        return AddMaterialTasks(graph, geometry, {}, files);
+    }
+
+    // As tarefas do .mtl e da textura s mexem no material e as da geometria s nos
+    // vrtices, por isso correm ao mesmo tempo sobre o mesmo Model
+    int Model::AddMaterialTasks(TaskGraph& graph, int geometryTask, const std::vector<int>& mtlDependencies, FileBatch* files) {
+        int material = graph.Add("modelo.mtl", TaskQueue::Worker, [this, files]() {
+            if (LoadMTL(mtlFileName, files ? files->Wait(mtlFileName) : nullptr)) return true;
+            std::cerr << "Erro ao carregar MTL: " << mtlFileName << std::endl;
+            return false;
+        }, mtlDependencies);
+
+        std::shared_ptr<PreparedTexture> prepared = std::make_shared<PreparedTexture>();
+        int decode = graph.Add("modelo.textura", TaskQueue::Worker, [this, prepared, files]() {
+            if (TextureCache::Instance().Prepare(textureFileName, *prepared, files)) return true;
+            std::cerr << "Erro ao carregar textura: " << textureFileName << std::endl;
+            return false;
+        }, { material });
+        int upload = graph.Add("modelo.enviar-textura", TaskQueue::GLThread, [this, prepared]() {
+            return LoadTexture(*prepared);
+        }, { decode });
+        int install = graph.Add("modelo.enviar-malha", TaskQueue::GLThread, [this]() {
+            Install();
+            return true;
+        }, { geometryTask });
+        return graph.Add("modelo.pronto", TaskQueue::GLThread, []() { return true; }, { upload, install });
+    }
+
+    void Model::BuildLODs() {
+        lods.clear();
+        if (vertices.empty()) return;
+
+        bounds = ComputeBounds(&vertices[0].position, vertices.size(), sizeof(Vertex));
+        const glm::vec3 center = bounds.sphere.center;
+        const float radius = bounds.sphere.radius;
+
+        float minDistance = radius;
+        for (const Vertex& v : vertices) {
+            float d = glm::length(v.position - center);
+            if (d < minDistance) minDistance = d;
         }
-        file.close();
+
+        LOD full = { 0, static_cast<unsigned int>(indices.size()), 0.0f };
+        lods.push_back(full);
+
+        // S malhas esfricas (todos os vrtices a ~2% do raio) recebem a cadeia paramtrica
+        if (radius <= 0.0f || minDistance < radius * 0.98f) return;
+
+        lods[0].minScreenRadius = SPHERE_LOD_SCREEN_RADIUS[0];
+        for (int i = 1; i < SPHERE_LOD_COUNT; ++i) {
+            LOD lod;
+            lod.indexOffset = static_cast<unsigned int>(indices.size());
+            AppendSphere(vertices, indices, center, radius, SPHERE_LOD_SLICES[i], SPHERE_LOD_SLICES[i] / 2);
+            lod.indexCount = static_cast<unsigned int>(indices.size()) - lod.indexOffset;
+            lod.minScreenRadius = SPHERE_LOD_SCREEN_RADIUS[i];
+            lods.push_back(lod);
+        }
+    }
+
+    int Model::SelectLOD(float screenRadius) const {
+        for (size_t i = 0; i < lods.size(); ++i) {
+            if (screenRadius >= lods[i].minScreenRadius) return static_cast<int>(i);
+        }
+        return GetLowestLOD();
+    }
+
+    bool Model::LoadMTL(const std::string& mtlFilePath, const std::vector<unsigned char>* contents) {
+        MTLMaterial material;
+        if (!ReadMTL(mtlFilePath, material, contents)) return false;
+        Ka = material.Ka;
+        Kd = material.Kd;
+        Ks = material.Ks;
+        Ns = material.Ns;
+        textureFileName = material.textureFileName;
         return true;
     }
 
-    bool Model::LoadMTL(const std::string& mtlFilePath) {
-        std::ifstream file(mtlFilePath);
-        if (!file.is_open()) return false;
+    void Model::ApplyMaterial(const MTLMaterial* material, GLuint texture) {
+        if (material) {
+            Ka = material->Ka;
+            Kd = material->Kd;
+            Ks = material->Ks;
+            Ns = material->Ns;
+            textureFileName = material->textureFileName;
+        }
+        TextureCache::Instance().Release(textureID);
+        textureID = texture;
+    }
+
+    bool ReadMTL(const std::string& mtlFilePath, MTLMaterial& material, const std::vector<unsigned char>* contents) {
+        std::ifstream file;
+        std::istringstream memory;
+        if (contents) {
+            memory.str(std::string(contents->begin(), contents->end()));
+        }
+        else {
+            file.open(mtlFilePath);
+            if (!file.is_open()) return false;
+        }
+        std::istream& stream = contents ? static_cast<std::istream&>(memory) : file;
 
+        TraceScope scope("mtl", mtlFilePath);
         std::string line;
-        while (std::getline(file, line)) {
+        while (std::getline(stream, line)) {
+            scope.AddBytes(line.size() + 1);
             std::istringstream iss(line);
             std::string prefix;
             iss >> prefix;
 
             if (prefix == "Ka") {
-                iss >> Ka.r >> Ka.g >> Ka.b;
+                iss >> material.Ka.r >> material.Ka.g >> material.Ka.b;
             }
             else if (prefix == "Kd") {
-                iss >> Kd.r >> Kd.g >> Kd.b;
+                iss >> material.Kd.r >> material.Kd.g >> material.Kd.b;
             }
             else if (prefix == "Ks") {
-                iss >> Ks.r >> Ks.g >> Ks.b;
+                iss >> material.Ks.r >> material.Ks.g >> material.Ks.b;
             }
             else if (prefix == "Ns") {
-                iss >> Ns;
+                iss >> material.Ns;
             }
             else if (prefix == "map_Kd") {
-                iss >> textureFileName;
+                // A textura  relativa  pasta do .mtl
+                iss >> material.textureFileName;
+                material.textureFileName = DirectoryOf(mtlFilePath) + material.textureFileName;
             }
         }
         file.close();
@@ -188,104 +257,133 @@ namespace P3D {
     }
 
     bool Model::LoadTexture(const std::string& textureFilePath) {
-        int width, height, nrChannels;
-        unsigned char* data = stbi_load(textureFilePath.c_str(), &width, &height, &nrChannels, 0);
-        if (!data) {
-            std::cerr << "Falha ao carregar textura: " << textureFilePath << std::endl;
-            return false;
-        }
-
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(data);
+        // A mesma imagem usada por vrios modelos  descodificada e enviada uma s vez
+        textureID = TextureCache::Instance().Acquire(textureFilePath);
+        return textureID != 0;
+    }
 
-        return true;
+    bool Model::LoadTexture(PreparedTexture& prepared) {
+        textureID = TextureCache::Instance().Acquire(prepared);
+        return textureID != 0;
     }
 
     void Model::Install() {
+        TraceScope scope("malha.enviar");
         glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO_Vertices);
-        glGenBuffers(1, &VBO_TexCoords);
-        glGenBuffers(1, &VBO_Normals);
+        glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
 
         glBindVertexArray(VAO);
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_Vertices);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(0);
+        // Um nico VBO intercalado: posio, UV e normal lidos no mesmo stream
+        std::vector<unsigned char> packed;
+        PackVertices(vertices, vertexFormat, packed, &quantization);
+        vertexBufferBytes = packed.size();
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_TexCoords);
-        glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(1);
+        if (vertexFormat == VertexFormat::Quantized) {
+            std::cout << "Quantizacao: erro max posicao " << quantization.maxPositionError
+                << ", uv " << quantization.maxTexCoordError
+                << ", normal " << quantization.maxNormalError << " graus" << std::endl;
+        }
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_Normals);
-        glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(2);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+        SetupVertexAttributes(vertexFormat, 0, 1, 2);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        scope.AddBytes(packed.size() + indices.size() * sizeof(unsigned int));
 
         glBindVertexArray(0);
+        ReleaseGeometry();
+    }
+
+    // Depois do envio a GPU tem tudo o que o desenho precisa: na CPU fica s o que a
+    // poltica pede
+    void Model::ReleaseGeometry() {
+        if (residency != MeshResidency::BoundsOnly && !lods.empty()) {
+            ExtractPositions(vertices, indices.data() + lods[0].indexOffset, lods[0].indexCount,
+                collisionPositions, collisionIndices);
+        }
+        if (residency == MeshResidency::Full) return;
+        FreeVector(vertices);
+        FreeVector(indices);
+    }
+
+    AssetMemory Model::GetMemory(const std::string& name) const {
+        AssetMemory memory;
+        memory.name = name;
+        memory.residency = ResidencyName(residency);
+        memory.cpuBytes = ReservedBytes(vertices) + ReservedBytes(indices) + ReservedBytes(lods) +
+            ReservedBytes(collisionPositions) + ReservedBytes(collisionIndices);
+        if (VBO) memory.gpuBytes = vertexBufferBytes + indexCount * sizeof(unsigned int);
+        return memory;
     }
 
     void Model::BindShaderAttributes(GLuint shaderProgram) {
         glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
         GLint posLoc = glGetAttribLocation(shaderProgram, "position");
-        if (posLoc != -1) {
-            glEnableVertexAttribArray(posLoc);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO_Vertices);
-            glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        }
-
         GLint texLoc = glGetAttribLocation(shaderProgram, "texcoord");
-        if (texLoc != -1) {
-            glEnableVertexAttribArray(texLoc);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO_TexCoords);
-            glVertexAttribPointer(texLoc, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-        }
-
         GLint normLoc = glGetAttribLocation(shaderProgram, "normal");
-        if (normLoc != -1) {
-            glEnableVertexAttribArray(normLoc);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO_Normals);
-            glVertexAttribPointer(normLoc, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        }
+        SetupVertexAttributes(vertexFormat, posLoc, texLoc, normLoc);
 
         glBindVertexArray(0);
     }
 
-    void Model::Render(GLuint shaderProgram, const glm::vec3& position, const glm::vec3& orientation) {
+    static glm::mat4 ModelMatrix(const glm::vec3& position, const glm::vec3& orientation) {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, position);
         // Exemplo simples de orientao (assumindo vetor Euler em radians)
         model = glm::rotate(model, orientation.x, glm::vec3(1, 0, 0));
         model = glm::rotate(model, orientation.y, glm::vec3(0, 1, 0));
         model = glm::rotate(model, orientation.z, glm::vec3(0, 0, 1));
+        return model;
+    }
+
+    void Model::LODRange(int lod, GLsizei& count, size_t& offset) const {
+        count = static_cast<GLsizei>(indexCount);
+        offset = 0;
+        if (lods.empty()) return;
+
+        if (lod < 0) lod = 0;
+        if (lod > GetLowestLOD()) lod = GetLowestLOD();
+        count = static_cast<GLsizei>(lods[lod].indexCount);
+        offset = lods[lod].indexOffset * sizeof(unsigned int);
+    }
+
+    void Model::Submit(DrawQueue& queue, GLuint shaderProgram, const glm::vec3& position,
+        const glm::vec3& orientation, int lod, float depth) const {
+        DrawCommand command;
+        command.program = shaderProgram;
+        command.texture = textureID;
+        command.vao = VAO;
+        LODRange(lod, command.indexCount, command.indexOffset);
+        command.model = ModelMatrix(position, orientation);
+        if (vertexFormat == VertexFormat::Quantized) command.quantization = &quantization;
+        command.key = DrawQueue::MakeKey(command.program, command.texture, command.vao, depth);
+        queue.Add(command);
+    }
+
+    void Model::Render(GLuint shaderProgram, const glm::vec3& position, const glm::vec3& orientation, int lod) {
+        glm::mat4 model = ModelMatrix(position, orientation);
         GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
         glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        if (vertexFormat == VertexFormat::Quantized) {
+            SetQuantizationUniforms(shaderProgram, quantization);
+        }
 
         // Bind da textura
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, textureID);
 
+        GLsizei count;
+        size_t offset;
+        LODRange(lod, count, offset);
+
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)offset);
         glBindVertexArray(0);
     }
 } // namespace P3D
\ No newline at end of file
@@ -0,0 +1,153 @@
+#ifndef P3D_H
+#define P3D_H
+
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "DrawQueue.h"
+#include "Frustum.h"
+#include "MeshImport.h"
+#include "Residency.h"
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    class FileBatch;
+    class TaskGraph;
+    struct PreparedTexture;
+
+    // Nível de detalhe: intervalo de índices dentro do EBO partilhado do modelo
+    struct LOD {
+        unsigned int indexOffset;
+        unsigned int indexCount;
+        float minScreenRadius;   // raio projetado mínimo (pixels) para usar este nível
+    };
+
+    // O que o Model usa de um .mtl
+    struct MTLMaterial {
+        glm::vec3 Ka = glm::vec3(0.1f);
+        glm::vec3 Kd = glm::vec3(0.8f);
+        glm::vec3 Ks = glm::vec3(1.0f);
+        float Ns = 32.0f;
+        std::string textureFileName;     // map_Kd, já com a pasta do .mtl
+    };
+
+    // Lê o .mtl sem tocar em GL (qualquer thread); contents é o ficheiro já lido (ex.: por
+    // um FileBatch), nulo lê-o do disco
+    bool ReadMTL(const std::string& mtlFilePath, MTLMaterial& material, const std::vector<unsigned char>* contents = nullptr);
+
+    class Model {
+    public:
+        Model();
+        ~Model();
+
+        bool Load(const std::string& objFilePath);
+        // Só o .obj (vértices, índices, LODs), sem .mtl nem textura - não precisa de contexto GL
+        bool LoadGeometry(const std::string& objFilePath, const ImportOptions& options = ImportOptions());
+        // Bola sem OBJ: esfera paramétrica com o material/textura do .mtl dado
+        bool LoadSphere(const std::string& mtlFilePath, float radius);
+        // Load e LoadSphere como tarefas de um TaskGraph: .obj/esfera, .mtl e descodificação da
+        // textura nas threads do pool, envio da textura e Install na thread GL. A textura
+        // depende do .mtl (map_Kd) e, no Load, o .mtl depende do .obj (mtllib). Devolve a
+        // última tarefa, que só tem sucesso se o modelo carregou todo. Com files, o .mtl e a
+        // textura vêm do lote quando lá foram pedidos (o .obj continua no ImportMesh).
+        int AddLoadTasks(TaskGraph& graph, const std::string& objFilePath, FileBatch* files = nullptr);
+        int AddSphereTasks(TaskGraph& graph, const std::string& mtlFilePath, float radius, FileBatch* files = nullptr);
+        void Install();
+        // Recarregamento a quente, na thread GL entre frames: troca as cores (se material não
+        // for nulo) e a textura. texture já traz uma referência; a da textura antiga é largada.
+        void ApplyMaterial(const MTLMaterial* material, GLuint texture);
+        void Render(GLuint shaderProgram, const glm::vec3& position, const glm::vec3& orientation, int lod = 0);
+        void BindShaderAttributes(GLuint shaderProgram);
+        // Como Render, mas acrescenta o draw à fila ordenada em vez de o executar
+        void Submit(DrawQueue& queue, GLuint shaderProgram, const glm::vec3& position,
+            const glm::vec3& orientation, int lod, float depth) const;
+
+        // Escolhe o LOD a partir do raio projetado no ecrã (ver ProjectedRadius)
+        int SelectLOD(float screenRadius) const;
+        int GetLODCount() const { return static_cast<int>(lods.size()); }
+        int GetLowestLOD() const { return GetLODCount() - 1; }
+        float GetBoundingRadius() const { return bounds.sphere.radius; }
+        // Volumes envolventes em espaço do modelo, calculados no carregamento
+        const Bounds& GetBounds() const { return bounds; }
+
+        // Deve ser chamado antes de Install(); Compact exige octDecode() e Quantized
+        // também dequantPosition()/dequantTexCoord() no vertex shader
+        void SetVertexFormat(VertexFormat format) { vertexFormat = format; }
+        const QuantizationInfo& GetQuantization() const { return quantization; }
+        size_t GetVertexBufferBytes() const { return vertexBufferBytes; }
+        size_t GetIndexBufferBytes() const { return indexCount * sizeof(unsigned int); }
+        size_t GetVertexCount() const { return vertexCount; }
+
+        // O que fica em memória de CPU depois do Install (ver MeshResidency); deve ser
+        // escolhido antes dele. Por omissão ficam as posições para colisões e picking.
+        void SetResidency(MeshResidency policy) { residency = policy; }
+        MeshResidency GetResidency() const { return residency; }
+        // Malha do LOD 0 só com posições, feita pelo Install (vazia com BoundsOnly e antes
+        // do Install)
+        const std::vector<glm::vec3>& GetCollisionPositions() const { return collisionPositions; }
+        const std::vector<unsigned int>& GetCollisionIndices() const { return collisionIndices; }
+        // Bytes que o modelo ocupa agora na CPU (geometria) e na GPU (VBO + EBO; a textura
+        // é partilhada e contada na TextureCache)
+        AssetMemory GetMemory(const std::string& name) const;
+
+    private:
+        // Dados do modelo (vértices intercalados posição/UV/normal)
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<LOD> lods;
+        // Contagens que sobrevivem à libertação dos vetores acima
+        size_t vertexCount;
+        size_t indexCount;
+
+        MeshResidency residency;
+        std::vector<glm::vec3> collisionPositions;
+        std::vector<unsigned int> collisionIndices;
+
+        Bounds bounds;
+
+        // Material
+        glm::vec3 Ka;
+        glm::vec3 Kd;
+        glm::vec3 Ks;
+        float Ns;
+
+        GLuint textureID;
+
+        GLuint VAO;
+        GLuint VBO;
+        GLuint EBO;
+
+        VertexFormat vertexFormat;
+        QuantizationInfo quantization;
+        size_t vertexBufferBytes;
+
+        std::string mtlFileName;
+        std::string textureFileName;
+
+        // contents: o .mtl já lido (ex.: por um FileBatch); nulo lê o ficheiro
+        bool LoadMTL(const std::string& mtlFilePath, const std::vector<unsigned char>* contents = nullptr);
+        bool LoadTexture(const std::string& textureFilePath);
+        bool LoadTexture(PreparedTexture& prepared);
+        void BuildSphere(float radius);
+        int AddMaterialTasks(TaskGraph& graph, int geometryTask, const std::vector<int>& mtlDependencies, FileBatch* files);
+
+        void BuildLODs();
+        void LODRange(int lod, GLsizei& count, size_t& offset) const;
+        void SetupBuffers();
+        void ReleaseGeometry();
+
+        Model(const Model&) = delete;
+        Model& operator=(const Model&) = delete;
+    };
+
+    // Raio (em pixels) de uma esfera depois de projetada num viewport com a altura dada
+    float ProjectedRadius(const glm::mat4& view, const glm::mat4& projection,
+        const glm::vec3& center, float radius, int viewportHeight);
+
+} // namespace P3D
+
+#endif // P3D_H
@@ -0,0 +1,156 @@
+#include "RegressionSuite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "RenderBackend.h"
+#include "Scene.h"
+#include "SoftwareRasterizer.h"
+
+namespace P3D {
+
+    // Resolução fixa das referências (igual à janela)
+    static const int FRAME_WIDTH = 800;
+    static const int FRAME_HEIGHT = 600;
+
+    struct CameraPose {
+        const char* name;
+        float yaw;
+        float pitch;
+        float distance;
+    };
+
+    // Poses que cobrem LODs diferentes, recorte no plano near e culling de parte da mesa
+    static const CameraPose POSES[] = {
+        { "frente",   0.0f, 20.0f,  5.0f },
+        { "lado",    90.0f, 20.0f,  5.0f },
+        { "perto",   30.0f, 35.0f,  2.0f },
+        { "topo",     0.0f, 89.0f,  6.0f },
+        { "rasante", -45.0f, 3.0f,  3.0f },
+        { "longe",  200.0f, 25.0f, 20.0f },
+    };
+
+    static std::map<std::string, double> ReadTimings(const std::string& filePath) {
+        std::map<std::string, double> timings;
+        std::ifstream file(filePath);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream iss(line);
+            std::string name;
+            double ms;
+            if (iss >> name >> ms) timings[name] = ms;
+        }
+        return timings;
+    }
+
+    int RunRegressionSuite(const RegressionOptions& options) {
+        Scene scene;
+        BuildPoolScene(scene, "models/");
+
+        SoftwareRasterizer backend(options.threads);
+        if (!backend.Init(scene, FRAME_WIDTH, FRAME_HEIGHT)) {
+            std::cerr << "Falha a inicializar o rasterizador por software" << std::endl;
+            return -1;
+        }
+
+        const std::string timingsPath = options.goldenDirectory + "timings.txt";
+        std::map<std::string, double> baseline = ReadTimings(timingsPath);
+        std::map<std::string, double> measured;
+
+        bool failed = false;
+        bool error = false;
+        std::printf("%-8s %10s %10s %8s %8s %9s  %s\n", "pose", "ms/frame", "ref ms", "dif %", "dE medio", "pixels %", "resultado");
+
+        for (const CameraPose& pose : POSES) {
+            Camera camera = OrbitCamera(pose.distance, pose.yaw, pose.pitch, (float)FRAME_WIDTH / (float)FRAME_HEIGHT);
+            PassStats mainStats, miniStats;
+
+            // Mediana do tempo de frame depois de aquecer caches e threads
+            std::vector<double> frameMs;
+            for (int frame = 0; frame < options.warmupFrames + options.measuredFrames; ++frame) {
+                mainStats.Reset();
+                miniStats.Reset();
+                auto start = std::chrono::steady_clock::now();
+                RenderFrame(backend, camera, mainStats, miniStats);
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (frame >= options.warmupFrames) frameMs.push_back(ms);
+            }
+            std::sort(frameMs.begin(), frameMs.end());
+            double median = frameMs.empty() ? 0.0 : frameMs[frameMs.size() / 2];
+            measured[pose.name] = median;
+
+            Image frame;
+            frame.width = FRAME_WIDTH;
+            frame.height = FRAME_HEIGHT;
+            backend.ReadPixels(frame.rgba);
+
+            const std::string goldenPath = options.goldenDirectory + pose.name + ".ppm";
+            if (options.update) {
+                if (!WritePPM(goldenPath, frame.width, frame.height, frame.rgba)) error = true;
+                std::printf("%-8s %10.3f %10s %8s %8s %9s  %s\n", pose.name, median, "-", "-", "-", "-", "atualizado");
+                continue;
+            }
+
+            Image golden;
+            if (!ReadPPM(goldenPath, golden)) {
+                std::cerr << "Imagem de referencia em falta: " << goldenPath << " (usar --update)" << std::endl;
+                error = true;
+                continue;
+            }
+
+            Image diff;
+            CompareResult result = CompareImages(golden, frame, options.tolerance, &diff);
+            bool imageOk = result.Passed(options.tolerance);
+
+            // Sem tempo de referência a pose não passa, como sem imagem de referência
+            auto reference = baseline.find(pose.name);
+            const bool hasReference = reference != baseline.end() && reference->second > 0.0;
+            double slowdown = 0.0;
+            bool timeOk = true;
+            if (hasReference) {
+                slowdown = median / reference->second - 1.0;
+                timeOk = slowdown <= options.maxSlowdown || median - reference->second <= options.minSlowdownMs;
+            }
+            else {
+                std::cerr << "Tempo de referencia em falta: " << pose.name << " em " << timingsPath << " (usar --update)" << std::endl;
+                error = true;
+            }
+
+            const char* verdict = !hasReference ? (imageOk ? "sem referência" : "IMAGEM+sem referência")
+                : imageOk ? (timeOk ? "ok" : "LENTO") : (timeOk ? "IMAGEM" : "IMAGEM+LENTO");
+            std::printf("%-8s %10.3f %10.3f %+7.1f%% %8.3f %8.3f%%  %s\n", pose.name, median,
+                hasReference ? reference->second : 0.0, slowdown * 100.0,
+                result.meanDeltaE, result.differentFraction * 100.0f, verdict);
+
+            // Imagem obtida e mapa de diferenças ao lado da referência, para inspecionar
+            if (!imageOk) {
+                WritePPM(options.goldenDirectory + pose.name + "_atual.ppm", frame.width, frame.height, frame.rgba);
+                if (result.sizeMatches) {
+                    WritePPM(options.goldenDirectory + pose.name + "_diff.ppm", diff.width, diff.height, diff.rgba);
+                }
+            }
+            if (!imageOk || !timeOk) failed = true;
+        }
+        backend.Shutdown();
+
+        if (options.update) {
+            std::ofstream file(timingsPath);
+            if (!file.is_open()) {
+                std::cerr << "Erro ao gravar " << timingsPath << std::endl;
+                return -1;
+            }
+            file << "# pose  mediana ms/frame (" << backend.GetThreadCount() << " threads)\n";
+            for (const auto& entry : measured) file << entry.first << " " << entry.second << "\n";
+        }
+
+        if (error) return -1;
+        return failed ? 1 : 0;
+    }
+
+} // namespace P3D
@@ -0,0 +1,29 @@
+#ifndef REGRESSIONSUITE_H
+#define REGRESSIONSUITE_H
+
+#include <string>
+
+#include "FrameCompare.h"
+
+namespace P3D {
+
+    // Renderiza poses fixas da câmara orbital no rasterizador por software, compara com
+    // as imagens de referência (<pose>.ppm) e o tempo de frame com timings.txt, ambos
+    // em goldenDirectory. Com update grava novas referências em vez de comparar.
+    struct RegressionOptions {
+        std::string goldenDirectory = "golden/";
+        bool update = false;
+        unsigned int threads = 0;
+        int warmupFrames = 3;
+        int measuredFrames = 20;
+        float maxSlowdown = 0.2f;       // mediana do tempo de frame até +20% da referência...
+        float minSlowdownMs = 1.0f;     // ...ou até +1 ms (frames curtos têm muito ruído)
+        CompareTolerance tolerance;
+    };
+
+    // 0 se todas as poses passam, 1 se alguma regrediu, -1 em erro (ex.: referência em falta)
+    int RunRegressionSuite(const RegressionOptions& options);
+
+} // namespace P3D
+
+#endif // REGRESSIONSUITE_H
@@ -0,0 +1,53 @@
+#include "RenderBackend.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace P3D {
+
+    // Minimapa no canto superior direito
+    static const int MINIMAP_SIZE = 200;
+    static const int MINIMAP_MARGIN = 10;
+
+    void RenderFrame(RenderBackend& backend, const Camera& camera, PassStats& mainStats, PassStats& miniStats) {
+        const int width = backend.GetWidth();
+        const int height = backend.GetHeight();
+
+        backend.BeginFrame(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
+
+        // Mesa + bolas (LOD escolhido pelo tamanho projetado)
+        Viewport mainViewport = { 0, 0, width, height };
+        backend.RenderPass(camera, mainViewport, false, &mainStats);
+
+        // Minimapa usa sempre o LOD mais baixo
+        Viewport miniViewport = { width - MINIMAP_SIZE - MINIMAP_MARGIN, height - MINIMAP_SIZE - MINIMAP_MARGIN,
+            MINIMAP_SIZE, MINIMAP_SIZE };
+        backend.RenderPass(MinimapCamera(), miniViewport, true, &miniStats);
+
+        backend.EndFrame();
+    }
+
+    bool WritePPM(const std::string& filePath, int width, int height, const std::vector<unsigned char>& rgba) {
+        if (rgba.size() < static_cast<size_t>(width) * height * 4) return false;
+
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Erro ao criar imagem: " << filePath << std::endl;
+            return false;
+        }
+        file << "P6\n" << width << " " << height << "\n255\n";
+
+        std::vector<char> row(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; ++y) {
+            const unsigned char* src = &rgba[static_cast<size_t>(y) * width * 4];
+            for (int x = 0; x < width; ++x) {
+                row[x * 3 + 0] = static_cast<char>(src[x * 4 + 0]);
+                row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+                row[x * 3 + 2] = static_cast<char>(src[x * 4 + 2]);
+            }
+            file.write(row.data(), row.size());
+        }
+        return file.good();
+    }
+
+} // namespace P3D
@@ -0,0 +1,56 @@
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "DrawQueue.h"
+#include "Frustum.h"
+#include "Scene.h"
+
+namespace P3D {
+
+    // Estatísticas de um passo de render (vista principal, minimapa, ...)
+    struct PassStats {
+        CullStats cull;
+        RenderStats render;
+
+        void Reset() { cull.Reset(); render.Reset(); }
+    };
+
+    // Interface comum ao renderer OpenGL e ao rasterizador por software.
+    // Cada frame: BeginFrame, um ou mais RenderPass, EndFrame.
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() {}
+
+        // Prepara os recursos da cena para um framebuffer width x height
+        virtual bool Init(const Scene& scene, int width, int height) = 0;
+        // Liberta os recursos (o backend OpenGL precisa do contexto ainda ativo)
+        virtual void Shutdown() = 0;
+
+        // Limpa cor e profundidade de todo o framebuffer
+        virtual void BeginFrame(const glm::vec4& clearColor) = 0;
+        // Limpa a profundidade e desenha a cena no viewport; lowestLOD força o nível mais simples
+        virtual void RenderPass(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats* stats) = 0;
+        virtual void EndFrame() = 0;
+
+        // Cópia do framebuffer em RGBA8, primeira linha = topo da imagem
+        virtual bool ReadPixels(std::vector<unsigned char>& rgba) = 0;
+
+        virtual int GetWidth() const = 0;
+        virtual int GetHeight() const = 0;
+        virtual const char* GetName() const = 0;
+    };
+
+    // Os dois passos de cada frame (vista principal + minimapa no canto superior direito),
+    // iguais para qualquer backend
+    void RenderFrame(RenderBackend& backend, const Camera& camera, PassStats& mainStats, PassStats& miniStats);
+
+    // Grava RGBA8 (primeira linha = topo) como PPM binário (P6), ignorando o alfa
+    bool WritePPM(const std::string& filePath, int width, int height, const std::vector<unsigned char>& rgba);
+
+} // namespace P3D
+
+#endif // RENDERBACKEND_H
@@ -0,0 +1,34 @@
+#include "Residency.h"
+
+namespace P3D {
+
+    const char* ResidencyName(MeshResidency residency) {
+        switch (residency) {
+        case MeshResidency::Full: return "completa";
+        case MeshResidency::Positions: return "posicoes";
+        case MeshResidency::BoundsOnly: return "volumes";
+        }
+        return "?";
+    }
+
+    void ExtractPositions(const std::vector<Vertex>& vertices, const unsigned int* indices, size_t indexCount,
+        std::vector<glm::vec3>& positions, std::vector<unsigned int>& positionIndices) {
+        positions.clear();
+        positionIndices.clear();
+        positionIndices.reserve(indexCount);
+
+        // Os LODs das esferas acrescentam vértices depois dos do LOD 0: só estes passam
+        std::vector<unsigned int> remap(vertices.size(), ~0u);
+        for (size_t i = 0; i < indexCount; ++i) {
+            unsigned int index = indices[i];
+            if (index >= vertices.size()) continue;
+            if (remap[index] == ~0u) {
+                remap[index] = static_cast<unsigned int>(positions.size());
+                positions.push_back(vertices[index].position);
+            }
+            positionIndices.push_back(remap[index]);
+        }
+        positions.shrink_to_fit();
+    }
+
+} // namespace P3D
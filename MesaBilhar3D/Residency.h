@@ -0,0 +1,49 @@
+#ifndef RESIDENCY_H
+#define RESIDENCY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // O que uma malha guarda em memória de CPU depois de ir para a GPU
+    enum class MeshResidency {
+        Full,           // vértices e índices completos, como antes (reenviar, ferramentas)
+        Positions,      // só posições (12 bytes por vértice) e índices do LOD 0: colisões e picking
+        BoundsOnly      // só os volumes envolventes (culling; colisões analíticas, ex.: as bolas)
+    };
+
+    const char* ResidencyName(MeshResidency residency);
+
+    // Uma linha do relatório de memória residente (--memory-report)
+    struct AssetMemory {
+        std::string name;
+        std::string residency;      // política da malha, ou "textura"
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+    };
+
+    // Cópia compacta para colisões: só os vértices usados pelos índices dados, com os
+    // índices renumerados para ela
+    void ExtractPositions(const std::vector<Vertex>& vertices, const unsigned int* indices, size_t indexCount,
+        std::vector<glm::vec3>& positions, std::vector<unsigned int>& positionIndices);
+
+    // Bytes reservados (capacity, não size): é o que o vetor ocupa de facto
+    template <typename T>
+    size_t ReservedBytes(const std::vector<T>& data) {
+        return data.capacity() * sizeof(T);
+    }
+
+    // clear() não devolve a memória; a troca com um vetor vazio sim
+    template <typename T>
+    void FreeVector(std::vector<T>& data) {
+        std::vector<T>().swap(data);
+    }
+
+} // namespace P3D
+
+#endif // RESIDENCY_H
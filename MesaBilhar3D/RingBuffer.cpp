@@ -0,0 +1,104 @@
+#include "RingBuffer.h"
+#include <iostream>
+
+using namespace P3D;
+
+RingBuffer::RingBuffer()
+    : buffer(0), target(GL_ARRAY_BUFFER), mapped(nullptr),
+    frameSize(0), head(0), frameIndex(0), stallCount(0)
+{
+    for (int i = 0; i < FRAMES; ++i) fences[i] = nullptr;
+}
+
+RingBuffer::~RingBuffer() {
+    Destroy();
+}
+
+bool RingBuffer::Create(GLenum bufferTarget, GLsizeiptr bytesPerFrame) {
+    Destroy();
+
+    // glBufferStorage só existe a partir do OpenGL 4.4 (ou ARB_buffer_storage)
+    if (!GLEW_ARB_buffer_storage) {
+        std::cerr << "RingBuffer: ARB_buffer_storage nao suportado" << std::endl;
+        return false;
+    }
+
+    target = bufferTarget;
+    frameSize = bytesPerFrame;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr totalSize = frameSize * FRAMES;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+    glBufferStorage(target, totalSize, nullptr, flags);
+    mapped = static_cast<unsigned char*>(glMapBufferRange(target, 0, totalSize, flags));
+    glBindBuffer(target, 0);
+
+    if (!mapped) {
+        std::cerr << "RingBuffer: falha ao mapear buffer persistente" << std::endl;
+        Destroy();
+        return false;
+    }
+    return true;
+}
+
+void RingBuffer::Destroy() {
+    for (int i = 0; i < FRAMES; ++i) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = nullptr;
+        }
+    }
+    if (buffer) {
+        // Apagar o buffer desfaz também o mapeamento persistente
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    mapped = nullptr;
+    frameSize = 0;
+    head = 0;
+    frameIndex = 0;
+}
+
+void RingBuffer::BeginFrame() {
+    head = 0;
+
+    GLsync& fence = fences[frameIndex];
+    if (!fence) return;
+
+    // A GPU ainda pode estar a ler esta região (frame de há FRAMES frames atrás)
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++stallCount;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+RingAllocation RingBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    RingAllocation alloc;
+    if (!mapped) return alloc;
+
+    GLsizeiptr start = (head + alignment - 1) / alignment * alignment;
+    if (start + size > frameSize) {
+        std::cerr << "RingBuffer: regiao do frame esgotada (" << size << " bytes)" << std::endl;
+        return alloc;
+    }
+    head = start + size;
+
+    alloc.offset = static_cast<GLintptr>(frameIndex) * frameSize + start;
+    alloc.ptr = mapped + alloc.offset;
+    alloc.size = size;
+    return alloc;
+}
+
+void RingBuffer::EndFrame() {
+    if (!mapped) return;
+
+    fences[frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frameIndex = (frameIndex + 1) % FRAMES;
+}
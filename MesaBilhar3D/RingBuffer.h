@@ -0,0 +1,53 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <GL/glew.h>
+
+namespace P3D {
+
+    // Bloco devolvido por RingBuffer::Allocate
+    struct RingAllocation {
+        void* ptr = nullptr;   // memória mapeada onde o CPU escreve diretamente
+        GLintptr offset = 0;   // offset dentro do buffer GL (para glBindBufferRange / glVertexAttribPointer)
+        GLsizeiptr size = 0;
+    };
+
+    // Buffer circular persistentemente mapeado para dados dinâmicos por frame
+    // (transformações das bolas, linhas de trajetória, geometria de debug).
+    // O buffer é dividido em FRAMES regiões; a região de um frame só volta a
+    // ser escrita depois de o fence colocado no fim desse frame ser sinalizado.
+    class RingBuffer {
+    public:
+        static const int FRAMES = 3;
+
+        RingBuffer();
+        ~RingBuffer();
+
+        bool Create(GLenum target, GLsizeiptr bytesPerFrame);
+        void Destroy();
+
+        void BeginFrame();
+        RingAllocation Allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+        void EndFrame();
+
+        GLuint GetBuffer() const { return buffer; }
+        GLenum GetTarget() const { return target; }
+        unsigned int GetStallCount() const { return stallCount; }
+
+    private:
+        GLuint buffer;
+        GLenum target;
+        unsigned char* mapped;
+        GLsizeiptr frameSize;
+        GLsizeiptr head;          // próximo byte livre dentro da região atual
+        int frameIndex;
+        GLsync fences[FRAMES];
+        unsigned int stallCount;  // nº de vezes que o CPU teve de esperar pela GPU
+
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,171 @@
+#include "Scene.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace P3D {
+
+    // Mesa e bolas
+    static const int BALL_COUNT = 15;
+    static const float BALL_RADIUS = 0.05f;
+    static const float TABLE_TOP_Y = 0.5f;
+
+    int Scene::AddMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+        SceneMesh mesh;
+        mesh.vertices = vertices;
+        mesh.indices = indices;
+        if (!vertices.empty()) {
+            mesh.bounds = ComputeBounds(&vertices[0].position, vertices.size(), sizeof(Vertex));
+        }
+        meshes.push_back(mesh);
+        return static_cast<int>(meshes.size()) - 1;
+    }
+
+    void Scene::AddStatic(int mesh, const glm::mat4& model, const glm::vec4& color) {
+        StaticObject object;
+        object.mesh = mesh;
+        object.model = model;
+        object.color = color;
+        statics.push_back(object);
+    }
+
+    // Cubo unitário centrado na origem, instanciado com escalas diferentes
+    static void AppendUnitCube(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        const glm::vec3 normals[6] = {
+            glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(-1, 0, 0),
+            glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, -1, 0)
+        };
+        for (int face = 0; face < 6; ++face) {
+            glm::vec3 n = normals[face];
+            // Dois eixos da face tais que u x v = n (ordem anti-horária vista de fora)
+            glm::vec3 u = (face >= 4) ? glm::vec3(n.y, 0, 0) : glm::vec3(n.z, 0, -n.x);
+            glm::vec3 v = glm::cross(n, u);
+
+            unsigned int base = static_cast<unsigned int>(vertices.size());
+            const glm::vec2 corners[4] = { glm::vec2(-1, -1), glm::vec2(1, -1), glm::vec2(1, 1), glm::vec2(-1, 1) };
+            for (int i = 0; i < 4; ++i) {
+                Vertex vertex;
+                vertex.position = 0.5f * (n + corners[i].x * u + corners[i].y * v);
+                vertex.texCoord = corners[i] * 0.5f + glm::vec2(0.5f);
+                vertex.normal = n;
+                vertices.push_back(vertex);
+            }
+            unsigned int quad[6] = { 0, 1, 2, 2, 3, 0 };
+            for (unsigned int i : quad) indices.push_back(base + i);
+        }
+    }
+
+    static glm::mat4 BoxTransform(const glm::vec3& center, const glm::vec3& size) {
+        return glm::scale(glm::translate(glm::mat4(1.0f), center), size);
+    }
+
+    // Tampo, corpo, tabelas, bolsos e pernas
+    static void BuildTable(Scene& scene) {
+        std::vector<Vertex> cubeVertices;
+        std::vector<unsigned int> cubeIndices;
+        AppendUnitCube(cubeVertices, cubeIndices);
+        int cube = scene.AddMesh(cubeVertices, cubeIndices);
+
+        const glm::vec4 cloth(0.05f, 0.45f, 0.15f, 1.0f);
+        const glm::vec4 wood(0.40f, 0.22f, 0.10f, 1.0f);
+        const glm::vec4 rail(0.04f, 0.35f, 0.12f, 1.0f);
+        const glm::vec4 pocket(0.02f, 0.02f, 0.02f, 1.0f);
+
+        // Tampo com a face superior em TABLE_TOP_Y e corpo de madeira por baixo
+        scene.AddStatic(cube, BoxTransform(glm::vec3(0.0f, TABLE_TOP_Y - 0.05f, 0.0f), glm::vec3(2.0f, 0.1f, 1.0f)), cloth);
+        scene.AddStatic(cube, BoxTransform(glm::vec3(0.0f, 0.15f, 0.0f), glm::vec3(2.2f, 0.5f, 1.2f)), wood);
+
+        // Tabelas
+        const float railY = TABLE_TOP_Y + 0.03f;
+        for (float side : { -1.0f, 1.0f }) {
+            scene.AddStatic(cube, BoxTransform(glm::vec3(0.0f, railY, side * 0.55f), glm::vec3(2.0f, 0.06f, 0.1f)), rail);
+            scene.AddStatic(cube, BoxTransform(glm::vec3(side * 1.05f, railY, 0.0f), glm::vec3(0.1f, 0.06f, 1.0f)), rail);
+        }
+
+        // 6 bolsos: 4 cantos + meio das tabelas compridas
+        for (float x : { -1.05f, 0.0f, 1.05f }) {
+            for (float z : { -0.55f, 0.55f }) {
+                scene.AddStatic(cube, BoxTransform(glm::vec3(x, railY + 0.005f, z), glm::vec3(0.12f, 0.07f, 0.12f)), pocket);
+            }
+        }
+
+        // Pernas
+        for (float x : { -0.95f, 0.95f }) {
+            for (float z : { -0.45f, 0.45f }) {
+                scene.AddStatic(cube, BoxTransform(glm::vec3(x, -0.3f, z), glm::vec3(0.12f, 0.4f, 0.12f)), wood);
+            }
+        }
+    }
+
+    // Posições das bolas em triângulo (5 filas) sobre o tampo da mesa
+    static std::vector<glm::vec3> RackPositions() {
+        std::vector<glm::vec3> positions;
+        const float rowStep = 1.7320508f * BALL_RADIUS; // 2R * cos(30)
+        for (int row = 0; row < 5; ++row) {
+            for (int i = 0; i <= row; ++i) {
+                float x = 0.4f + row * rowStep;
+                float z = (i - row * 0.5f) * 2.0f * BALL_RADIUS;
+                positions.push_back(glm::vec3(x, TABLE_TOP_Y + BALL_RADIUS, z));
+            }
+        }
+        return positions;
+    }
+
+    void BuildPoolScene(Scene& scene, const std::string& modelsDirectory) {
+        BuildTable(scene);
+
+        std::vector<glm::vec3> positions = RackPositions();
+        for (int i = 1; i <= BALL_COUNT; ++i) {
+            BallObject ball;
+            ball.mtlFilePath = modelsDirectory + "Ball" + std::to_string(i) + ".mtl";
+            ball.textureFilePath = ReadDiffuseMap(ball.mtlFilePath);
+            ball.position = positions[i - 1];
+            ball.radius = BALL_RADIUS;
+            scene.balls.push_back(ball);
+        }
+    }
+
+    std::string ReadDiffuseMap(const std::string& mtlFilePath) {
+        std::ifstream file(mtlFilePath);
+        if (!file.is_open()) return std::string();
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream iss(line);
+            std::string prefix;
+            iss >> prefix;
+            if (prefix == "map_Kd") {
+                std::string textureFileName;
+                iss >> textureFileName;
+                size_t slash = mtlFilePath.find_last_of("/\\");
+                std::string directory = slash == std::string::npos ? std::string() : mtlFilePath.substr(0, slash + 1);
+                return directory + textureFileName;
+            }
+        }
+        return std::string();
+    }
+
+    Camera OrbitCamera(float distance, float yaw, float pitch, float aspect) {
+        float camX = distance * cos(glm::radians(pitch)) * sin(glm::radians(yaw));
+        float camY = distance * sin(glm::radians(pitch));
+        float camZ = distance * cos(glm::radians(pitch)) * cos(glm::radians(yaw));
+
+        Camera camera;
+        camera.farPlane = 100.0f;
+        camera.view = glm::lookAt(glm::vec3(camX, camY, camZ), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+        camera.projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, camera.farPlane);
+        return camera;
+    }
+
+    Camera MinimapCamera() {
+        // Top-down, com -Z para cima para olhar "para frente"
+        Camera camera;
+        camera.farPlane = 20.0f;
+        camera.view = glm::lookAt(glm::vec3(0, 10, 0), glm::vec3(0, 0, 0), glm::vec3(0, 0, -1));
+        camera.projection = glm::ortho(-2.0f, 2.0f, -2.0f, 2.0f, 0.1f, camera.farPlane);
+        return camera;
+    }
+
+} // namespace P3D
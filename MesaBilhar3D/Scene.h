@@ -0,0 +1,69 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // Malha em memória partilhada pelos objetos estáticos que a referem
+    struct SceneMesh {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        Bounds bounds;
+    };
+
+    // Geometria estática de cor sólida (tampo, tabelas, bolsos, ...)
+    struct StaticObject {
+        int mesh;
+        glm::mat4 model;
+        glm::vec4 color;
+    };
+
+    // Bola: esfera paramétrica com a textura do seu .mtl
+    struct BallObject {
+        std::string mtlFilePath;
+        std::string textureFilePath;
+        glm::vec3 position;
+        float radius;
+    };
+
+    // Câmara de um passo de render
+    struct Camera {
+        glm::mat4 view;
+        glm::mat4 projection;
+        float farPlane;
+    };
+
+    // Retângulo de destino em pixels, origem no canto inferior esquerdo (como glViewport)
+    struct Viewport {
+        int x, y, width, height;
+    };
+
+    // Descrição da cena independente do backend (OpenGL ou rasterizador por software)
+    struct Scene {
+        std::vector<SceneMesh> meshes;
+        std::vector<StaticObject> statics;
+        std::vector<BallObject> balls;
+
+        int AddMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+        void AddStatic(int mesh, const glm::mat4& model, const glm::vec4& color);
+    };
+
+    // Mesa (cubo unitário escalado) + 15 bolas em triângulo; modelsDirectory termina em '/'
+    void BuildPoolScene(Scene& scene, const std::string& modelsDirectory);
+
+    // map_Kd do .mtl, relativo à pasta do .mtl; vazio se o ficheiro ou a entrada não existir
+    std::string ReadDiffuseMap(const std::string& mtlFilePath);
+
+    // Câmara orbital da vista principal (ângulos em graus) e câmara top-down do minimapa
+    Camera OrbitCamera(float distance, float yaw, float pitch, float aspect);
+    Camera MinimapCamera();
+
+} // namespace P3D
+
+#endif // SCENE_H
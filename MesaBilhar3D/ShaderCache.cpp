@@ -0,0 +1,283 @@
+#include "ShaderCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include "StartupTrace.h"
+#include "TextureBaker.h"
+
+namespace P3D {
+
+    static const char BINARY_MAGIC[4] = { 'P', '3', 'D', 'S' };
+    static const uint32_t BINARY_VERSION = 1;
+
+    // Cabeçalho do .p3dprog; segue-se o binário devolvido pelo glGetProgramBinary
+    struct BinaryHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint64_t driverHash;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+    };
+
+    // Binários maiores que isto são tratados como ficheiro corrompido
+    static const uint32_t MAX_BINARY_LENGTH = 64u << 20;
+
+    static GLuint SubmitShader(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    // Verificar erros de compilação (só depois de o programa estar pronto, para não bloquear)
+    static void CheckShader(GLuint shader) {
+        int success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            std::cout << "Erro shader: " << infoLog << std::endl;
+        }
+    }
+
+    static void MakeDirectory(std::string path) {
+        while (!path.empty() && (path.back() == '/' || path.back() == '\\')) path.pop_back();
+        if (path.empty()) return;
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+
+    static std::string HexString(uint64_t value) {
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+        return text;
+    }
+
+    ShaderCache& ShaderCache::Instance() {
+        static ShaderCache cache;
+        return cache;
+    }
+
+    void ShaderCache::SetDirectory(const std::string& path) {
+        directory = path;
+        if (!directory.empty() && directory.back() != '/' && directory.back() != '\\') directory += '/';
+    }
+
+    // Uma vez por processo (com o contexto já criado): formatos de binário e identidade do driver
+    void ShaderCache::CheckDriver() {
+        driverChecked = true;
+
+        GLint formats = 0;
+        if (GLEW_ARB_get_program_binary) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        binarySupported = formats > 0;
+
+        // Quantas threads o driver quiser para compilar em paralelo
+        if (GLEW_KHR_parallel_shader_compile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        else if (GLEW_ARB_parallel_shader_compile) glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        parallelCompile = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+
+        std::string driver;
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+            const GLubyte* value = glGetString(name);
+            if (value) driver += reinterpret_cast<const char*>(value);
+            driver += '\n';
+        }
+        driverHash = HashBytes(reinterpret_cast<const unsigned char*>(driver.data()), driver.size());
+    }
+
+    std::string ShaderCache::BinaryPath(uint64_t sourceHash) const {
+        uint64_t key[2] = { sourceHash, driverHash };
+        return directory + HexString(HashBytes(reinterpret_cast<const unsigned char*>(key), sizeof(key))) + ".p3dprog";
+    }
+
+    int ShaderCache::Request(const std::string& name, const char* vertexSource, const char* fragmentSource) {
+        TraceScope scope("shader.pedido", name);
+        auto start = std::chrono::steady_clock::now();
+        if (!driverChecked) CheckDriver();
+
+        Pending request;
+        ShaderProgramInfo info;
+        info.name = name;
+        info.submitTime = start;
+
+        const bool useDisk = binarySupported && !directory.empty();
+        if (useDisk) {
+            // '\0' entre os dois para "ab"+"c" não dar o mesmo que "a"+"bc"
+            std::string sources = vertexSource;
+            sources += '\0';
+            sources += fragmentSource;
+            request.sourceHash = HashBytes(reinterpret_cast<const unsigned char*>(sources.data()), sources.size());
+            request.binaryPath = BinaryPath(request.sourceHash);
+            request.program = LoadBinary(request.binaryPath, request.sourceHash);
+        }
+
+        if (request.program) {
+            ++stats.loaded;
+            request.finished = true;
+            info.fromBinary = true;
+            info.ready = true;
+            info.readyTime = std::chrono::steady_clock::now();
+        }
+        else {
+            // Nada de glGet* aqui: o driver pode continuar a compilar noutra thread
+            request.vertexShader = SubmitShader(GL_VERTEX_SHADER, vertexSource);
+            request.fragmentShader = SubmitShader(GL_FRAGMENT_SHADER, fragmentSource);
+            request.program = glCreateProgram();
+            if (useDisk) glProgramParameteri(request.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            glAttachShader(request.program, request.vertexShader);
+            glAttachShader(request.program, request.fragmentShader);
+            glLinkProgram(request.program);
+        }
+
+        pending.push_back(request);
+        infos.push_back(info);
+        stats.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<int>(pending.size()) - 1;
+    }
+
+    bool ShaderCache::Poll(int index) {
+        if (index < 0 || index >= static_cast<int>(pending.size())) return true;
+        ShaderProgramInfo& info = infos[index];
+        if (info.ready) return true;
+        // Sem a extensão não há como saber sem bloquear
+        if (!parallelCompile) return true;
+
+        auto start = std::chrono::steady_clock::now();
+        GLint done = GL_FALSE;
+        glGetProgramiv(pending[index].program, GL_COMPLETION_STATUS_KHR, &done);
+        if (done) {
+            info.ready = true;
+            info.readyTime = std::chrono::steady_clock::now();
+        }
+        stats.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return info.ready;
+    }
+
+    GLuint ShaderCache::Finish(int index) {
+        if (index < 0 || index >= static_cast<int>(pending.size())) return 0;
+        Pending& request = pending[index];
+        ShaderProgramInfo& info = infos[index];
+        if (request.finished) return info.failed ? 0 : request.program;
+
+        TraceScope scope("shader.recolha", info.name);
+        auto start = std::chrono::steady_clock::now();
+        CheckShader(request.vertexShader);
+        CheckShader(request.fragmentShader);
+
+        int success;
+        glGetProgramiv(request.program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(request.program, 512, nullptr, infoLog);
+            std::cout << "Erro link shader program: " << infoLog << std::endl;
+        }
+        if (!info.ready) {
+            info.ready = true;
+            info.readyTime = std::chrono::steady_clock::now();
+        }
+
+        glDetachShader(request.program, request.vertexShader);
+        glDetachShader(request.program, request.fragmentShader);
+        glDeleteShader(request.vertexShader);
+        glDeleteShader(request.fragmentShader);
+        request.vertexShader = request.fragmentShader = 0;
+        request.finished = true;
+
+        if (success) {
+            ++stats.compiled;
+            if (!request.binaryPath.empty()) SaveBinary(request.binaryPath, request.sourceHash, request.program);
+        }
+        else {
+            glDeleteProgram(request.program);
+            request.program = 0;
+            info.failed = true;
+        }
+        stats.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return request.program;
+    }
+
+    GLuint ShaderCache::CreateProgram(const char* vertexSource, const char* fragmentSource) {
+        return Finish(Request(std::string(), vertexSource, fragmentSource));
+    }
+
+    GLuint ShaderCache::LoadBinary(const std::string& path, uint64_t sourceHash) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return 0;
+
+        BinaryHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return 0;
+        if (!std::equal(BINARY_MAGIC, BINARY_MAGIC + 4, header.magic) || header.version != BINARY_VERSION ||
+            header.sourceHash != sourceHash || header.driverHash != driverHash ||
+            header.binaryLength == 0 || header.binaryLength > MAX_BINARY_LENGTH) {
+            return 0;
+        }
+        std::vector<char> binary(header.binaryLength);
+        if (!file.read(binary.data(), binary.size())) return 0;
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint success = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            // Ex.: atualização do driver que não muda a GL_VERSION
+            glDeleteProgram(program);
+            ++stats.rejected;
+            return 0;
+        }
+        return program;
+    }
+
+    void ShaderCache::SaveBinary(const std::string& path, uint64_t sourceHash, GLuint program) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0 || static_cast<uint32_t>(length) > MAX_BINARY_LENGTH) return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) return;
+
+        BinaryHeader header;
+        std::memcpy(header.magic, BINARY_MAGIC, 4);
+        header.version = BINARY_VERSION;
+        header.sourceHash = sourceHash;
+        header.driverHash = driverHash;
+        header.binaryFormat = format;
+        header.binaryLength = static_cast<uint32_t>(written);
+
+        MakeDirectory(directory);
+        // Grava num temporário e renomeia, para outro processo nunca ler um binário a meio
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Erro ao criar a cache de shaders: " << temporaryPath << std::endl;
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), written);
+            if (!file.good()) {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return;
+            }
+        }
+        std::remove(path.c_str());
+        std::rename(temporaryPath.c_str(), path.c_str());
+    }
+
+} // namespace P3D
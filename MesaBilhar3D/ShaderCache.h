@@ -0,0 +1,94 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+namespace P3D {
+
+    struct ShaderCacheStats {
+        unsigned int loaded = 0;        // programas carregados com glProgramBinary
+        unsigned int compiled = 0;      // compilados e ligados a partir do GLSL
+        unsigned int rejected = 0;      // binários no disco recusados pelo driver (caem em compiled)
+        double milliseconds = 0.0;      // tempo da thread GL dentro de Request/Poll/Finish
+    };
+
+    // Um pedido de programa: tempos desde o Request até o driver o dar como pronto
+    struct ShaderProgramInfo {
+        std::string name;
+        bool fromBinary = false;
+        bool failed = false;
+        bool ready = false;
+        std::chrono::steady_clock::time_point submitTime;
+        std::chrono::steady_clock::time_point readyTime;   // quando Poll/Finish o viu pronto
+    };
+
+    // Programas GLSL com cache em disco dos binários do driver (glGetProgramBinary).
+    // Cada ficheiro .p3dprog é identificado pelo hash dos sources e do GL_VENDOR,
+    // GL_RENDERER e GL_VERSION: mudar um shader, a placa ou o driver dá outro ficheiro. Se o
+    // driver recusar o binário (glProgramBinary falha) o programa é compilado e o
+    // ficheiro reescrito. Sem ARB_get_program_binary (ou sem formatos) compila sempre.
+    //
+    // A compilação é assíncrona: Request submete compile + link sem ler nenhum estado (o que
+    // obrigaria o driver a terminar ali), Poll pergunta GL_COMPLETION_STATUS_KHR sem
+    // bloquear e Finish recolhe o resultado. Com KHR/ARB_parallel_shader_compile o driver
+    // compila em threads próprias enquanto o resto da inicialização corre; sem a extensão
+    // Poll diz sempre pronto e o trabalho fica para o Finish.
+    // Só deve ser usada na thread do contexto GL.
+    class ShaderCache {
+    public:
+        static ShaderCache& Instance();
+
+        // Pasta dos binários (criada se não existir); vazio desliga a cache em disco
+        void SetDirectory(const std::string& directory);
+        const std::string& GetDirectory() const { return directory; }
+
+        // Submete o programa (vertex + fragment) e devolve o índice do pedido
+        int Request(const std::string& name, const char* vertexSource, const char* fragmentSource);
+        // Verdadeiro se Finish já não espera pelo driver
+        bool Poll(int request);
+        // Programa ligado (espera pelo driver se ainda estiver a compilar) ou 0 se falhou
+        GLuint Finish(int request);
+
+        // Request + Finish
+        GLuint CreateProgram(const char* vertexSource, const char* fragmentSource);
+
+        bool UsesParallelCompile() const { return parallelCompile; }
+        const ShaderCacheStats& GetStats() const { return stats; }
+        const std::vector<ShaderProgramInfo>& GetPrograms() const { return infos; }
+
+    private:
+        struct Pending {
+            GLuint program = 0;
+            GLuint vertexShader = 0;       // 0 depois do Finish ou se veio do binário
+            GLuint fragmentShader = 0;
+            std::string binaryPath;        // vazio = não gravar
+            uint64_t sourceHash = 0;
+            bool finished = false;
+        };
+
+        std::string directory = "shadercache/";
+        bool driverChecked = false;
+        bool binarySupported = false;
+        bool parallelCompile = false;
+        uint64_t driverHash = 0;
+        ShaderCacheStats stats;
+        std::vector<Pending> pending;
+        std::vector<ShaderProgramInfo> infos;
+
+        ShaderCache() = default;
+        ShaderCache(const ShaderCache&) = delete;
+        ShaderCache& operator=(const ShaderCache&) = delete;
+
+        void CheckDriver();
+        std::string BinaryPath(uint64_t sourceHash) const;
+        GLuint LoadBinary(const std::string& path, uint64_t sourceHash);
+        void SaveBinary(const std::string& path, uint64_t sourceHash, GLuint program);
+    };
+
+} // namespace P3D
+
+#endif // SHADERCACHE_H
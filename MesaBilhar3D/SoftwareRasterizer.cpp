@@ -0,0 +1,618 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+#include "ImageDecode.h"
+#include "P3D.h"
+#include "Sphere.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define P3D_RASTER_SSE 1
+#endif
+
+namespace P3D {
+
+    // Iluminação igual à dos shaders GL: ambiente 0.3 + difusa 0.7 com luz fixa
+    static const float AMBIENT = 0.3f;
+    static const glm::vec3 LIGHT_DIRECTION = glm::normalize(glm::vec3(0.3f, 1.0f, 0.5f));
+
+    // Vértices encaixados a 1/16 de pixel; com o centro dos pixels em .5 as funções de
+    // aresta são múltiplos de 1/256 e o desvio abaixo implementa a regra top-left
+    static const float SUBPIXEL = 16.0f;
+    static const float FILL_BIAS = 1.0f / 512.0f;
+
+    static uint32_t PackColor(float r, float g, float b, float a) {
+        auto channel = [](float c) {
+            c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+            return static_cast<uint32_t>(c * 255.0f + 0.5f);
+        };
+        return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+    }
+
+    // Bilinear com repetição (GL_REPEAT) num nível da cadeia de mipmaps
+    static uint32_t SampleBilinear(const std::vector<uint32_t>& texels, int w, int h, float u, float v) {
+        float fx = u * w - 0.5f;
+        float fy = v * h - 0.5f;
+        float flx = std::floor(fx);
+        float fly = std::floor(fy);
+        float tx = fx - flx;
+        float ty = fy - fly;
+
+        int x0 = static_cast<int>(flx) % w; if (x0 < 0) x0 += w;
+        int y0 = static_cast<int>(fly) % h; if (y0 < 0) y0 += h;
+        int x1 = x0 + 1 == w ? 0 : x0 + 1;
+        int y1 = y0 + 1 == h ? 0 : y0 + 1;
+
+        uint32_t c00 = texels[y0 * w + x0], c10 = texels[y0 * w + x1];
+        uint32_t c01 = texels[y1 * w + x0], c11 = texels[y1 * w + x1];
+
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            float a = static_cast<float>((c00 >> shift) & 0xFF);
+            float b = static_cast<float>((c10 >> shift) & 0xFF);
+            float c = static_cast<float>((c01 >> shift) & 0xFF);
+            float d = static_cast<float>((c11 >> shift) & 0xFF);
+            float top = a + (b - a) * tx;
+            float bottom = c + (d - c) * tx;
+            result |= static_cast<uint32_t>(top + (bottom - top) * ty + 0.5f) << shift;
+        }
+        return result;
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer(unsigned int count)
+        : threadCount(count), width(0), height(0), tilesX(0), tilesY(0)
+    {
+        if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+
+    SoftwareRasterizer::~SoftwareRasterizer() {
+        StopPool();
+    }
+
+    bool SoftwareRasterizer::LoadTexture(const std::string& textureFilePath, Texture& texture) {
+        DecodedImage image;
+        if (!DecodeImageFile(textureFilePath, image, 4)) return false;
+
+        TextureLevel base;
+        base.width = image.width;
+        base.height = image.height;
+        base.texels.resize(static_cast<size_t>(image.width) * image.height);
+        for (size_t i = 0; i < base.texels.size(); ++i) {
+            const unsigned char* p = &image.pixels[i * 4];
+            base.texels[i] = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+        texture.levels.push_back(std::move(base));
+
+        // Mipmaps até 1x1 (média de 2x2 texels por canal)
+        while (texture.levels.back().width > 1 || texture.levels.back().height > 1) {
+            const TextureLevel& src = texture.levels.back();
+            TextureLevel dst;
+            dst.width = std::max(1, src.width / 2);
+            dst.height = std::max(1, src.height / 2);
+            dst.texels.resize(static_cast<size_t>(dst.width) * dst.height);
+            for (int y = 0; y < dst.height; ++y) {
+                int sy0 = std::min(y * 2, src.height - 1), sy1 = std::min(y * 2 + 1, src.height - 1);
+                for (int x = 0; x < dst.width; ++x) {
+                    int sx0 = std::min(x * 2, src.width - 1), sx1 = std::min(x * 2 + 1, src.width - 1);
+                    uint32_t a = src.texels[sy0 * src.width + sx0], b = src.texels[sy0 * src.width + sx1];
+                    uint32_t c = src.texels[sy1 * src.width + sx0], d = src.texels[sy1 * src.width + sx1];
+                    uint32_t result = 0;
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        uint32_t sum = ((a >> shift) & 0xFF) + ((b >> shift) & 0xFF) +
+                            ((c >> shift) & 0xFF) + ((d >> shift) & 0xFF);
+                        result |= ((sum + 2) / 4) << shift;
+                    }
+                    dst.texels[y * dst.width + x] = result;
+                }
+            }
+            texture.levels.push_back(std::move(dst));
+        }
+        return true;
+    }
+
+    bool SoftwareRasterizer::Init(const Scene& scene, int w, int h) {
+        width = w;
+        height = h;
+        tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+        colorBuffer.assign(static_cast<size_t>(width) * height, 0);
+        depthBuffer.assign(static_cast<size_t>(width) * height, 1.0f);
+
+        for (const SceneMesh& sceneMesh : scene.meshes) {
+            Mesh mesh;
+            mesh.vertices = sceneMesh.vertices;
+            mesh.indices = sceneMesh.indices;
+            meshes.push_back(std::move(mesh));
+        }
+        statics = scene.statics;
+        for (const StaticObject& object : statics) {
+            staticBoxes.push_back(TransformAABB(scene.meshes[object.mesh].bounds.box, object.model));
+        }
+
+        // Texturas partilhadas por caminho; bolas sem textura são ignoradas (como no GL)
+        std::unordered_map<std::string, int> textureIDs;
+        for (const BallObject& object : scene.balls) {
+            auto it = textureIDs.find(object.textureFilePath);
+            int textureID;
+            if (it != textureIDs.end()) {
+                textureID = it->second;
+            }
+            else {
+                Texture texture;
+                if (object.textureFilePath.empty() || !LoadTexture(object.textureFilePath, texture)) {
+                    std::cerr << "Erro ao carregar textura: " << object.textureFilePath << std::endl;
+                    continue;
+                }
+                textureID = static_cast<int>(textures.size());
+                textures.push_back(std::move(texture));
+                textureIDs[object.textureFilePath] = textureID;
+            }
+
+            Ball ball;
+            for (int i = 0; i < SPHERE_LOD_COUNT; ++i) {
+                Mesh lod;
+                AppendSphere(lod.vertices, lod.indices, object.position, object.radius,
+                    SPHERE_LOD_SLICES[i], SPHERE_LOD_SLICES[i] / 2);
+                ball.lods.push_back(std::move(lod));
+            }
+            ball.bounds.center = object.position;
+            ball.bounds.radius = object.radius;
+            ball.texture = textureID;
+            balls.push_back(std::move(ball));
+        }
+
+        workers.resize(threadCount);
+        for (Worker& worker : workers) {
+            worker.bins.resize(static_cast<size_t>(tilesX) * tilesY);
+        }
+        StartPool();
+        return true;
+    }
+
+    void SoftwareRasterizer::Shutdown() {
+        meshes.clear();
+        statics.clear();
+        staticBoxes.clear();
+        balls.clear();
+        textures.clear();
+        StopPool();
+        workers.clear();
+    }
+
+    void SoftwareRasterizer::StartPool() {
+        StopPool();
+        poolStopping = false;
+        // Começam na geração atual: um pool recriado não corre a tarefa do passo anterior
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            pool.emplace_back(&SoftwareRasterizer::PoolLoop, this, i, poolGeneration);
+        }
+    }
+
+    void SoftwareRasterizer::StopPool() {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            poolStopping = true;
+        }
+        poolWake.notify_all();
+        for (std::thread& thread : pool) thread.join();
+        pool.clear();
+    }
+
+    void SoftwareRasterizer::PoolLoop(unsigned int index, uint64_t seen) {
+        for (;;) {
+            const std::function<void(unsigned int)>* task;
+            {
+                std::unique_lock<std::mutex> lock(poolMutex);
+                poolWake.wait(lock, [&]() { return poolStopping || poolGeneration != seen; });
+                if (poolStopping) return;
+                seen = poolGeneration;
+                task = poolTask;
+            }
+            (*task)(index);
+            {
+                std::lock_guard<std::mutex> lock(poolMutex);
+                if (--poolRunning > 0) continue;
+            }
+            poolDone.notify_one();
+        }
+    }
+
+    void SoftwareRasterizer::RunParallel(const std::function<void(unsigned int)>& task) {
+        if (pool.empty()) {
+            task(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            poolTask = &task;
+            poolRunning = static_cast<unsigned int>(pool.size());
+            ++poolGeneration;
+        }
+        poolWake.notify_all();
+        task(0);
+        std::unique_lock<std::mutex> lock(poolMutex);
+        poolDone.wait(lock, [this]() { return poolRunning == 0; });
+    }
+
+    void SoftwareRasterizer::BeginFrame(const glm::vec4& clearColor) {
+        std::fill(colorBuffer.begin(), colorBuffer.end(), PackColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a));
+        std::fill(depthBuffer.begin(), depthBuffer.end(), 1.0f);
+    }
+
+    void SoftwareRasterizer::RenderPass(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats* stats) {
+        PassStats local;
+        PassStats& passStats = stats ? *stats : local;
+
+        // Como glClear(GL_DEPTH_BUFFER_BIT): todo o framebuffer
+        std::fill(depthBuffer.begin(), depthBuffer.end(), 1.0f);
+
+        // Viewport (origem em baixo) -> retângulo em pixels com y para baixo
+        Rect scissor;
+        scissor.x0 = std::max(0, viewport.x);
+        scissor.x1 = std::min(width, viewport.x + viewport.width);
+        scissor.y0 = std::max(0, height - (viewport.y + viewport.height));
+        scissor.y1 = std::min(height, height - viewport.y);
+        if (scissor.x0 >= scissor.x1 || scissor.y0 >= scissor.y1) return;
+
+        glm::mat4 viewProjection = camera.projection * camera.view;
+        Frustum frustum;
+        frustum.Extract(viewProjection);
+
+        drawItems.clear();
+        for (size_t i = 0; i < statics.size(); ++i) {
+            passStats.cull.tested++;
+            if (!frustum.TestAABB(staticBoxes[i])) continue;
+            passStats.cull.visible++;
+
+            DrawItem item;
+            item.mesh = &meshes[statics[i].mesh];
+            item.texture = nullptr;
+            item.model = statics[i].model;
+            item.color = statics[i].color;
+            drawItems.push_back(item);
+        }
+        for (const Ball& ball : balls) {
+            passStats.cull.tested++;
+            if (!frustum.TestSphere(ball.bounds)) continue;
+            passStats.cull.visible++;
+
+            // Mesmos limiares que Model::SelectLOD
+            int lod = SPHERE_LOD_COUNT - 1;
+            if (!lowestLOD) {
+                float radius = ProjectedRadius(camera.view, camera.projection, ball.bounds.center,
+                    ball.bounds.radius, viewport.height);
+                for (int i = 0; i < SPHERE_LOD_COUNT; ++i) {
+                    if (radius >= SPHERE_LOD_SCREEN_RADIUS[i]) { lod = i; break; }
+                }
+            }
+
+            DrawItem item;
+            item.mesh = &ball.lods[lod];
+            item.texture = &textures[ball.texture];
+            item.model = glm::mat4(1.0f);
+            item.color = glm::vec4(1.0f);
+            drawItems.push_back(item);
+        }
+        passStats.render.drawCalls += static_cast<unsigned int>(drawItems.size());
+        if (drawItems.empty()) return;
+
+        // Geometria: cada thread processa um intervalo contíguo de draws e preenche os seus bins,
+        // por isso a ordem dos triângulos em cada tile é a mesma que em série
+        const size_t itemCount = drawItems.size();
+        RunParallel([&](unsigned int index) {
+            Worker& worker = workers[index];
+            worker.triangles.clear();
+            for (std::vector<uint32_t>& bin : worker.bins) bin.clear();
+
+            size_t begin = itemCount * index / threadCount;
+            size_t end = itemCount * (index + 1) / threadCount;
+            for (size_t i = begin; i < end; ++i) {
+                ProcessDraw(worker, drawItems[i], viewProjection, viewport, scissor);
+            }
+        });
+
+        // Rasterização: cada tile pertence a uma só thread, sem sincronização nos buffers
+        std::atomic<int> nextTile(0);
+        const int tileCount = tilesX * tilesY;
+        RunParallel([&](unsigned int) {
+            for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+                RasterizeTile(tile, scissor);
+            }
+        });
+    }
+
+    void SoftwareRasterizer::ProcessDraw(Worker& worker, const DrawItem& item, const glm::mat4& viewProjection,
+        const Viewport& viewport, const Rect& scissor) {
+        const Mesh& mesh = *item.mesh;
+        const glm::mat4 mvp = viewProjection * item.model;
+        const glm::mat3 normalMatrix(item.model);
+
+        // Vertex "shader": uma vez por vértice, partilhado pelos triângulos
+        worker.clipVertices.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+            const Vertex& v = mesh.vertices[i];
+            ClipVertex& out = worker.clipVertices[i];
+            out.position = mvp * glm::vec4(v.position, 1.0f);
+            out.texCoord = v.texCoord;
+            float diffuse = glm::dot(glm::normalize(normalMatrix * v.normal), LIGHT_DIRECTION);
+            out.light = AMBIENT + (1.0f - AMBIENT) * std::max(diffuse, 0.0f);
+        }
+
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            const ClipVertex* v[3] = {
+                &worker.clipVertices[mesh.indices[i]],
+                &worker.clipVertices[mesh.indices[i + 1]],
+                &worker.clipVertices[mesh.indices[i + 2]]
+            };
+
+            // Rejeição trivial: os 3 vértices fora do mesmo plano do frustum
+            int outside = 0x3F;
+            bool crossesNear = false;
+            for (int k = 0; k < 3; ++k) {
+                const glm::vec4& p = v[k]->position;
+                int code = 0;
+                if (p.x < -p.w) code |= 1;
+                if (p.x > p.w) code |= 2;
+                if (p.y < -p.w) code |= 4;
+                if (p.y > p.w) code |= 8;
+                if (p.z < -p.w) { code |= 16; crossesNear = true; }
+                if (p.z > p.w) code |= 32;
+                outside &= code;
+            }
+            if (outside) continue;
+
+            if (!crossesNear) {
+                SetupTriangle(worker, *v[0], *v[1], *v[2], item, viewport, scissor);
+                continue;
+            }
+
+            // Recorte no plano near (z >= -w): até 4 vértices, desenhados em leque
+            ClipVertex polygon[4];
+            int count = 0;
+            for (int k = 0; k < 3; ++k) {
+                const ClipVertex& a = *v[k];
+                const ClipVertex& b = *v[(k + 1) % 3];
+                float da = a.position.z + a.position.w;
+                float db = b.position.z + b.position.w;
+                if (da >= 0.0f) polygon[count++] = a;
+                if ((da >= 0.0f) != (db >= 0.0f)) {
+                    float t = da / (da - db);
+                    ClipVertex& c = polygon[count++];
+                    c.position = a.position + (b.position - a.position) * t;
+                    c.texCoord = a.texCoord + (b.texCoord - a.texCoord) * t;
+                    c.light = a.light + (b.light - a.light) * t;
+                }
+            }
+            for (int k = 1; k + 1 < count; ++k) {
+                SetupTriangle(worker, polygon[0], polygon[k], polygon[k + 1], item, viewport, scissor);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::SetupTriangle(Worker& worker, const ClipVertex& a, const ClipVertex& b, const ClipVertex& c,
+        const DrawItem& item, const Viewport& viewport, const Rect& scissor) {
+        const ClipVertex* in[3] = { &a, &b, &c };
+        float x[3], y[3], z[3], invW[3];
+        for (int k = 0; k < 3; ++k) {
+            const glm::vec4& p = in[k]->position;
+            invW[k] = 1.0f / p.w;
+            float sx = viewport.x + (p.x * invW[k] * 0.5f + 0.5f) * viewport.width;
+            float sy = height - (viewport.y + (p.y * invW[k] * 0.5f + 0.5f) * viewport.height);
+            x[k] = std::floor(sx * SUBPIXEL + 0.5f) / SUBPIXEL;
+            y[k] = std::floor(sy * SUBPIXEL + 0.5f) / SUBPIXEL;
+            z[k] = p.z * invW[k] * 0.5f + 0.5f;
+        }
+
+        // Frente = anti-horário em GL (y para cima), ou seja área negativa com y para baixo
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (area >= 0.0f) return;
+
+        // Troca 1 <-> 2 para ficar com área positiva e arestas >= 0 no interior
+        int order[3] = { 0, 2, 1 };
+        area = -area;
+
+        Triangle tri;
+        float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (int k = 1; k < 3; ++k) {
+            minX = std::min(minX, x[k]); maxX = std::max(maxX, x[k]);
+            minY = std::min(minY, y[k]); maxY = std::max(maxY, y[k]);
+        }
+        tri.minX = std::max(scissor.x0, static_cast<int>(std::floor(minX)));
+        tri.minY = std::max(scissor.y0, static_cast<int>(std::floor(minY)));
+        tri.maxX = std::min(scissor.x1, static_cast<int>(std::ceil(maxX)));
+        tri.maxY = std::min(scissor.y1, static_cast<int>(std::ceil(maxY)));
+        if (tri.minX >= tri.maxX || tri.minY >= tri.maxY) return;
+
+        for (int k = 0; k < 3; ++k) {
+            // Aresta oposta ao vértice k
+            int i0 = order[(k + 1) % 3], i1 = order[(k + 2) % 3];
+            float dx = x[i1] - x[i0];
+            float dy = y[i1] - y[i0];
+            tri.edgeA[k] = -dy;
+            tri.edgeB[k] = dx;
+            tri.edgeC[k] = dy * x[i0] - dx * y[i0];
+            bool topLeft = dy < 0.0f || (dy == 0.0f && dx > 0.0f);
+            if (!topLeft) tri.edgeC[k] -= FILL_BIAS;
+        }
+        tri.invArea = 1.0f / area;
+
+        // Atributos na forma a0 + l1 * (a1 - a0) + l2 * (a2 - a0)
+        for (int k = 0; k < 3; ++k) {
+            int src = order[k];
+            tri.z[k] = z[src];
+            tri.invW[k] = invW[src];
+            tri.uOverW[k] = in[src]->texCoord.x * invW[src];
+            tri.vOverW[k] = in[src]->texCoord.y * invW[src];
+            tri.lightOverW[k] = in[src]->light * invW[src];
+        }
+        float* planes[5] = { tri.z, tri.invW, tri.uOverW, tri.vOverW, tri.lightOverW };
+        for (float* plane : planes) {
+            plane[1] -= plane[0];
+            plane[2] -= plane[0];
+        }
+        tri.color = item.color;
+
+        // Mipmap por triângulo: razão entre a área em texels e a área em pixels
+        tri.texture = nullptr;
+        if (item.texture) {
+            const std::vector<TextureLevel>& levels = item.texture->levels;
+            glm::vec2 t0 = a.texCoord, t1 = b.texCoord, t2 = c.texCoord;
+            float texelArea = std::fabs((t1.x - t0.x) * (t2.y - t0.y) - (t2.x - t0.x) * (t1.y - t0.y)) *
+                levels[0].width * levels[0].height;
+            int level = 0;
+            if (texelArea > area) {
+                level = static_cast<int>(0.5f * std::log2(texelArea / area));
+                level = std::min(level, static_cast<int>(levels.size()) - 1);
+            }
+            tri.texture = &levels[level];
+        }
+
+        uint32_t index = static_cast<uint32_t>(worker.triangles.size());
+        worker.triangles.push_back(tri);
+
+        int tx0 = tri.minX / TILE_SIZE, tx1 = (tri.maxX - 1) / TILE_SIZE;
+        int ty0 = tri.minY / TILE_SIZE, ty1 = (tri.maxY - 1) / TILE_SIZE;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                worker.bins[ty * tilesX + tx].push_back(index);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::RasterizeTile(int tile, const Rect& scissor) {
+        Rect rect;
+        rect.x0 = std::max(scissor.x0, (tile % tilesX) * TILE_SIZE);
+        rect.y0 = std::max(scissor.y0, (tile / tilesX) * TILE_SIZE);
+        rect.x1 = std::min(scissor.x1, rect.x0 - rect.x0 % TILE_SIZE + TILE_SIZE);
+        rect.y1 = std::min(scissor.y1, rect.y0 - rect.y0 % TILE_SIZE + TILE_SIZE);
+        if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1) return;
+
+        // Workers por ordem = ordem dos draws
+        for (const Worker& worker : workers) {
+            for (uint32_t index : worker.bins[tile]) {
+                RasterizeTriangle(worker.triangles[index], rect);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::RasterizeTriangle(const Triangle& tri, const Rect& tileRect) {
+        const int x0 = std::max(tileRect.x0, tri.minX);
+        const int x1 = std::min(tileRect.x1, tri.maxX);
+        const int y0 = std::max(tileRect.y0, tri.minY);
+        const int y1 = std::min(tileRect.y1, tri.maxY);
+        if (x0 >= x1 || y0 >= y1) return;
+
+        auto shade = [&](float l1, float l2, uint32_t& pixel) {
+            float invW = tri.invW[0] + l1 * tri.invW[1] + l2 * tri.invW[2];
+            float w = 1.0f / invW;
+            float light = (tri.lightOverW[0] + l1 * tri.lightOverW[1] + l2 * tri.lightOverW[2]) * w;
+            float r = tri.color.r * light, g = tri.color.g * light, b = tri.color.b * light;
+            if (tri.texture) {
+                float u = (tri.uOverW[0] + l1 * tri.uOverW[1] + l2 * tri.uOverW[2]) * w;
+                float v = (tri.vOverW[0] + l1 * tri.vOverW[1] + l2 * tri.vOverW[2]) * w;
+                uint32_t texel = SampleBilinear(tri.texture->texels, tri.texture->width, tri.texture->height, u, v);
+                r *= (texel & 0xFF) / 255.0f;
+                g *= ((texel >> 8) & 0xFF) / 255.0f;
+                b *= ((texel >> 16) & 0xFF) / 255.0f;
+            }
+            pixel = PackColor(r, g, b, tri.color.a);
+        };
+
+#ifdef P3D_RASTER_SSE
+        const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 a0 = _mm_set1_ps(tri.edgeA[0]), a1 = _mm_set1_ps(tri.edgeA[1]), a2 = _mm_set1_ps(tri.edgeA[2]);
+        const __m128 invArea = _mm_set1_ps(tri.invArea);
+        const __m128 z0 = _mm_set1_ps(tri.z[0]), dz1 = _mm_set1_ps(tri.z[1]), dz2 = _mm_set1_ps(tri.z[2]);
+
+        for (int y = y0; y < y1; ++y) {
+            const float py = y + 0.5f;
+            const __m128 row0 = _mm_set1_ps(tri.edgeB[0] * py + tri.edgeC[0]);
+            const __m128 row1 = _mm_set1_ps(tri.edgeB[1] * py + tri.edgeC[1]);
+            const __m128 row2 = _mm_set1_ps(tri.edgeB[2] * py + tri.edgeC[2]);
+            float* depthRow = &depthBuffer[static_cast<size_t>(y) * width];
+            uint32_t* colorRow = &colorBuffer[static_cast<size_t>(y) * width];
+
+            for (int x = x0; x < x1; x += 4) {
+                // Funções de aresta de 4 pixels consecutivos
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+                const __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                const __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                const __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                    _mm_cmpge_ps(e2, zero));
+                int mask = _mm_movemask_ps(inside);
+                if (x1 - x < 4) mask &= (1 << (x1 - x)) - 1;
+                if (!mask) continue;
+
+                // Teste de profundidade nos 4 pixels
+                const __m128 l1 = _mm_mul_ps(e1, invArea);
+                const __m128 l2 = _mm_mul_ps(e2, invArea);
+                const __m128 z = _mm_add_ps(z0, _mm_add_ps(_mm_mul_ps(l1, dz1), _mm_mul_ps(l2, dz2)));
+                // Na última coluna de 4 só as colunas até x1 são lidas: as seguintes podem ser
+                // de outro tile, a ser escrito por outra thread
+                __m128 depth;
+                if (x1 - x >= 4) depth = _mm_loadu_ps(depthRow + x);
+                else {
+                    alignas(16) float tail[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                    for (int lane = 0; lane < x1 - x; ++lane) tail[lane] = depthRow[x + lane];
+                    depth = _mm_load_ps(tail);
+                }
+                mask &= _mm_movemask_ps(_mm_cmplt_ps(z, depth));
+                if (!mask) continue;
+
+                alignas(16) float zs[4], l1s[4], l2s[4];
+                _mm_store_ps(zs, z);
+                _mm_store_ps(l1s, l1);
+                _mm_store_ps(l2s, l2);
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (!(mask & (1 << lane))) continue;
+                    depthRow[x + lane] = zs[lane];
+                    shade(l1s[lane], l2s[lane], colorRow[x + lane]);
+                }
+            }
+        }
+#else
+        for (int y = y0; y < y1; ++y) {
+            const float py = y + 0.5f;
+            float* depthRow = &depthBuffer[static_cast<size_t>(y) * width];
+            uint32_t* colorRow = &colorBuffer[static_cast<size_t>(y) * width];
+            for (int x = x0; x < x1; ++x) {
+                const float px = x + 0.5f;
+                float e0 = tri.edgeA[0] * px + tri.edgeB[0] * py + tri.edgeC[0];
+                float e1 = tri.edgeA[1] * px + tri.edgeB[1] * py + tri.edgeC[1];
+                float e2 = tri.edgeA[2] * px + tri.edgeB[2] * py + tri.edgeC[2];
+                if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) continue;
+
+                float l1 = e1 * tri.invArea, l2 = e2 * tri.invArea;
+                float z = tri.z[0] + l1 * tri.z[1] + l2 * tri.z[2];
+                if (z >= depthRow[x]) continue;
+                depthRow[x] = z;
+                shade(l1, l2, colorRow[x]);
+            }
+        }
+#endif
+    }
+
+    bool SoftwareRasterizer::ReadPixels(std::vector<unsigned char>& rgba) {
+        const size_t count = static_cast<size_t>(width) * height;
+        rgba.resize(count * 4);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t c = colorBuffer[i];
+            rgba[i * 4 + 0] = static_cast<unsigned char>(c & 0xFF);
+            rgba[i * 4 + 1] = static_cast<unsigned char>((c >> 8) & 0xFF);
+            rgba[i * 4 + 2] = static_cast<unsigned char>((c >> 16) & 0xFF);
+            rgba[i * 4 + 3] = static_cast<unsigned char>(c >> 24);
+        }
+        return true;
+    }
+
+} // namespace P3D
@@ -0,0 +1,154 @@
+#ifndef SOFTWARERASTERIZER_H
+#define SOFTWARERASTERIZER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "RenderBackend.h"
+
+namespace P3D {
+
+    // Rasterizador por software para render sem GPU (testes, captura e benchmark de frames).
+    // Cada passo: transformação + recorte no plano near + binning dos triângulos por tile
+    // (uma lista por thread, sem locks), depois cada thread rasteriza tiles inteiros com
+    // funções de aresta SSE (4 pixels de cada vez) e amostragem de textura com correção
+    // de perspetiva. Mesma cena, LODs e iluminação que o GLRenderBackend.
+    class SoftwareRasterizer : public RenderBackend {
+    public:
+        static const int TILE_SIZE = 64;
+
+        // threadCount 0 = std::thread::hardware_concurrency()
+        explicit SoftwareRasterizer(unsigned int threadCount = 0);
+        ~SoftwareRasterizer() override;
+
+        bool Init(const Scene& scene, int width, int height) override;
+        void Shutdown() override;
+
+        void BeginFrame(const glm::vec4& clearColor) override;
+        void RenderPass(const Camera& camera, const Viewport& viewport, bool lowestLOD, PassStats* stats) override;
+        void EndFrame() override {}
+
+        bool ReadPixels(std::vector<unsigned char>& rgba) override;
+
+        int GetWidth() const override { return width; }
+        int GetHeight() const override { return height; }
+        const char* GetName() const override { return "Software"; }
+        unsigned int GetThreadCount() const { return threadCount; }
+
+    private:
+        struct TextureLevel {
+            int width;
+            int height;
+            std::vector<uint32_t> texels;   // RGBA8, R no byte menos significativo
+        };
+
+        // Cadeia de mipmaps gerada no carregamento (filtro caixa 2x2)
+        struct Texture {
+            std::vector<TextureLevel> levels;
+        };
+
+        struct Mesh {
+            std::vector<Vertex> vertices;
+            std::vector<unsigned int> indices;
+        };
+
+        struct Ball {
+            std::vector<Mesh> lods;         // SPHERE_LOD_SLICES, como Model::BuildLODs
+            BoundingSphere bounds;          // já em coordenadas de mundo
+            int texture;
+        };
+
+        struct DrawItem {
+            const Mesh* mesh;
+            const Texture* texture;         // nullptr = cor sólida
+            glm::mat4 model;
+            glm::vec4 color;
+        };
+
+        // Vértice depois do vertex "shader"
+        struct ClipVertex {
+            glm::vec4 position;
+            glm::vec2 texCoord;
+            float light;
+        };
+
+        // Triângulo em coordenadas de ecrã (y para baixo), pronto a rasterizar.
+        // Cada atributo é a0 + l1 * d1 + l2 * d2, com l1/l2 as coordenadas baricêntricas.
+        struct Triangle {
+            float edgeA[3], edgeB[3], edgeC[3];     // E(x, y) = A*x + B*y + C, >= 0 dentro
+            float invArea;
+            float z[3];                             // profundidade em [0, 1]
+            float invW[3];
+            float uOverW[3];
+            float vOverW[3];
+            float lightOverW[3];
+            glm::vec4 color;
+            const TextureLevel* texture;
+            int minX, minY, maxX, maxY;             // caixa em pixels, máximo exclusivo
+        };
+
+        // Estado de cada thread no passo de geometria
+        struct Worker {
+            std::vector<ClipVertex> clipVertices;
+            std::vector<Triangle> triangles;
+            std::vector<std::vector<uint32_t>> bins;    // índices de triangles por tile
+        };
+
+        struct Rect {
+            int x0, y0, x1, y1;
+        };
+
+        unsigned int threadCount;
+        int width;
+        int height;
+        int tilesX;
+        int tilesY;
+
+        std::vector<uint32_t> colorBuffer;
+        std::vector<float> depthBuffer;
+
+        std::vector<Mesh> meshes;
+        std::vector<StaticObject> statics;
+        std::vector<AABB> staticBoxes;
+        std::vector<Ball> balls;
+        std::vector<Texture> textures;
+
+        std::vector<DrawItem> drawItems;
+        std::vector<Worker> workers;
+
+        // Pool persistente (threadCount - 1 threads; a 0 é quem chama RunParallel), criado
+        // no Init: cada passo corre várias fases paralelas e criar threads em cada uma custava
+        // mais do que o trabalho em cenas pequenas
+        std::vector<std::thread> pool;
+        std::mutex poolMutex;
+        std::condition_variable poolWake;
+        std::condition_variable poolDone;
+        const std::function<void(unsigned int)>* poolTask = nullptr;
+        uint64_t poolGeneration = 0;
+        unsigned int poolRunning = 0;
+        bool poolStopping = false;
+
+        void StartPool();
+        void StopPool();
+        void PoolLoop(unsigned int index, uint64_t generation);
+
+        bool LoadTexture(const std::string& textureFilePath, Texture& texture);
+        void RunParallel(const std::function<void(unsigned int)>& task);
+
+        void ProcessDraw(Worker& worker, const DrawItem& item, const glm::mat4& viewProjection,
+            const Viewport& viewport, const Rect& scissor);
+        void SetupTriangle(Worker& worker, const ClipVertex& a, const ClipVertex& b, const ClipVertex& c,
+            const DrawItem& item, const Viewport& viewport, const Rect& scissor);
+        void RasterizeTile(int tile, const Rect& scissor);
+        void RasterizeTriangle(const Triangle& tri, const Rect& rect);
+    };
+
+} // namespace P3D
+
+#endif // SOFTWARERASTERIZER_H
@@ -0,0 +1,50 @@
+#include "Sphere.h"
+#include <cmath>
+
+namespace P3D {
+
+    void AppendSphere(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+        const glm::vec3& center, float radius, int slices, int stacks) {
+        const float PI = 3.14159265358979f;
+        const unsigned int base = static_cast<unsigned int>(vertices.size());
+
+        // (slices + 1) colunas: a costura em u = 1 precisa de vértices duplicados
+        for (int stack = 0; stack <= stacks; ++stack) {
+            float v = static_cast<float>(stack) / stacks;
+            float phi = v * PI;
+            for (int slice = 0; slice <= slices; ++slice) {
+                float u = static_cast<float>(slice) / slices;
+                float theta = u * 2.0f * PI;
+
+                glm::vec3 n(std::sin(phi) * std::sin(theta), std::cos(phi), std::sin(phi) * std::cos(theta));
+
+                Vertex vertex;
+                vertex.position = center + n * radius;
+                vertex.texCoord = glm::vec2(u, v);
+                vertex.normal = n;
+                vertices.push_back(vertex);
+            }
+        }
+
+        const unsigned int row = static_cast<unsigned int>(slices + 1);
+        for (int stack = 0; stack < stacks; ++stack) {
+            for (int slice = 0; slice < slices; ++slice) {
+                unsigned int i0 = base + stack * row + slice;
+                unsigned int i1 = i0 + row;
+
+                // Os triângulos degenerados junto aos polos são omitidos
+                if (stack != 0) {
+                    indices.push_back(i0);
+                    indices.push_back(i1);
+                    indices.push_back(i0 + 1);
+                }
+                if (stack != stacks - 1) {
+                    indices.push_back(i0 + 1);
+                    indices.push_back(i1);
+                    indices.push_back(i1 + 1);
+                }
+            }
+        }
+    }
+
+} // namespace P3D
@@ -0,0 +1,25 @@
+#ifndef SPHERE_H
+#define SPHERE_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // Cadeia de LODs para esferas: resolução (slices; stacks = slices / 2) e
+    // raio projetado mínimo em pixels de cada nível
+    const int SPHERE_LOD_COUNT = 4;
+    const int SPHERE_LOD_SLICES[SPHERE_LOD_COUNT] = { 48, 24, 12, 8 };
+    const float SPHERE_LOD_SCREEN_RADIUS[SPHERE_LOD_COUNT] = { 48.0f, 16.0f, 6.0f, 0.0f };
+
+    // Acrescenta uma esfera UV (slices x stacks) aos arrays dados.
+    // Mapeamento equiretangular: u = longitude, v = 0 no polo norte (+Y),
+    // igual ao das texturas PoolBalluv*.jpg.
+    void AppendSphere(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+        const glm::vec3& center, float radius, int slices, int stacks);
+
+} // namespace P3D
+
+#endif // SPHERE_H
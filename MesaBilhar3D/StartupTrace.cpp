@@ -0,0 +1,424 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include "StartupTrace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace P3D {
+
+    static const unsigned int NO_THREAD = ~0u;
+    static thread_local unsigned int threadIndex = NO_THREAD;
+    static thread_local int currentEvent = -1;
+
+    // Idade do processo em ms; 0 se o sistema não a disser. A resolução é a do relógio do
+    // sistema (~10 ms no /proc de Linux, ~1-16 ms no GetSystemTimeAsFileTime).
+    static double ProcessAgeMs() {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user, now;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+        GetSystemTimeAsFileTime(&now);
+        // Unidades de 100 ns
+        ULARGE_INTEGER c, n;
+        c.LowPart = creation.dwLowDateTime;
+        c.HighPart = creation.dwHighDateTime;
+        n.LowPart = now.dwLowDateTime;
+        n.HighPart = now.dwHighDateTime;
+        return n.QuadPart > c.QuadPart ? static_cast<double>(n.QuadPart - c.QuadPart) * 1e-4 : 0.0;
+#elif defined(__linux__)
+        // Campo 22 do /proc/self/stat: arranque em ticks desde o boot. O nome (campo 2) pode
+        // ter espaços e parênteses, por isso conta-se a partir do último ')'.
+        std::ifstream file("/proc/self/stat");
+        std::string stat;
+        if (!std::getline(file, stat)) return 0.0;
+        size_t close = stat.rfind(')');
+        if (close == std::string::npos) return 0.0;
+        std::istringstream fields(stat.substr(close + 1));
+        std::string field;
+        int index = 2;
+        while (index < 22 && (fields >> field)) ++index;
+        long ticksPerSecond = sysconf(_SC_CLK_TCK);
+        struct timespec boot;
+        if (index != 22 || ticksPerSecond <= 0 || clock_gettime(CLOCK_BOOTTIME, &boot) != 0) return 0.0;
+        double startMs = std::strtod(field.c_str(), nullptr) * 1000.0 / ticksPerSecond;
+        double nowMs = boot.tv_sec * 1000.0 + boot.tv_nsec * 1e-6;
+        return nowMs > startMs ? nowMs - startMs : 0.0;
+#else
+        return 0.0;
+#endif
+    }
+
+    static void MakeDirectory(std::string path) {
+        while (!path.empty() && (path.back() == '/' || path.back() == '\\')) path.pop_back();
+        if (path.empty()) return;
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+
+    static std::string JsonString(const std::string& text) {
+        std::string json = "\"";
+        for (char c : text) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                json += '\\';
+                json += c;
+            }
+            else if (u < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", u);
+                json += escaped;
+            }
+            else {
+                json += c;
+            }
+        }
+        return json + "\"";
+    }
+
+    static std::string JsonNumber(double value) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", value);
+        return text;
+    }
+
+    // ';' separa as frames e o último espaço separa o valor no formato das pilhas
+    static std::string FoldedFrame(const std::string& name) {
+        std::string frame = name;
+        std::replace(frame.begin(), frame.end(), ';', ':');
+        std::replace(frame.begin(), frame.end(), '\n', ' ');
+        return frame;
+    }
+
+    // Grava num temporário e renomeia, para o job nunca ler um relatório a meio
+    static bool WriteTextFile(const std::string& filePath, const std::string& text) {
+        std::string temporaryPath = filePath + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Erro ao criar o relatorio de arranque: " << temporaryPath << std::endl;
+                return false;
+            }
+            file << text;
+            if (!file.good()) {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+        std::remove(filePath.c_str());
+        return std::rename(temporaryPath.c_str(), filePath.c_str()) == 0;
+    }
+
+    StartupTrace& StartupTrace::Instance() {
+        static StartupTrace trace;
+        return trace;
+    }
+
+    void StartupTrace::Enable() {
+        if (IsRecording()) return;
+        preMainMs = ProcessAgeMs();
+        origin = std::chrono::steady_clock::now() -
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(preMainMs));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.clear();
+            threadNames.clear();
+            marks.clear();
+        }
+        threadIndex = NO_THREAD;
+        currentEvent = -1;
+        recording.store(true);
+        SetThreadName("principal");
+
+        // Loader, bibliotecas e construtores estáticos
+        if (preMainMs > 0.0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            TraceEvent event;
+            event.name = "antes-do-main";
+            event.thread = 0;
+            event.startMs = 0.0;
+            event.endMs = preMainMs;
+            events.push_back(event);
+        }
+    }
+
+    double StartupTrace::Now() const {
+        return ToTraceMs(std::chrono::steady_clock::now());
+    }
+
+    double StartupTrace::ToTraceMs(std::chrono::steady_clock::time_point time) const {
+        return std::chrono::duration<double, std::milli>(time - origin).count();
+    }
+
+    unsigned int StartupTrace::CurrentThread() {
+        // Chamado com o mutex fechado
+        if (threadIndex == NO_THREAD || threadIndex >= threadNames.size()) {
+            threadIndex = static_cast<unsigned int>(threadNames.size());
+            threadNames.push_back("thread " + std::to_string(threadIndex));
+        }
+        return threadIndex;
+    }
+
+    unsigned int StartupTrace::TrackIndex(const std::string& name) {
+        for (size_t i = 0; i < threadNames.size(); ++i) {
+            if (threadNames[i] == name) return static_cast<unsigned int>(i);
+        }
+        threadNames.push_back(name);
+        return static_cast<unsigned int>(threadNames.size()) - 1;
+    }
+
+    int StartupTrace::Begin(const char* name, const std::string& detail) {
+        if (!IsRecording()) return -1;
+        TraceEvent event;
+        event.name = name;
+        event.detail = detail;
+        event.parent = currentEvent;
+        event.startMs = Now();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        event.thread = CurrentThread();
+        events.push_back(event);
+        currentEvent = static_cast<int>(events.size()) - 1;
+        return currentEvent;
+    }
+
+    void StartupTrace::End(int index, uint64_t bytes) {
+        if (index < 0) return;
+        double now = Now();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index >= static_cast<int>(events.size())) return;
+        TraceEvent& event = events[index];
+        // Já fechado pelo Finish: o tempo fica o do Finish
+        if (event.endMs < 0.0) event.endMs = now;
+        event.bytes += bytes;
+        currentEvent = event.parent;
+    }
+
+    void StartupTrace::AddSpan(const std::string& track, const char* name, const std::string& detail,
+        double startMs, double endMs, uint64_t bytes) {
+        if (!IsRecording()) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        TraceEvent event;
+        event.name = name;
+        event.detail = detail;
+        event.thread = TrackIndex(track);
+        event.startMs = startMs;
+        event.endMs = std::max(startMs, endMs);
+        event.bytes = bytes;
+        events.push_back(event);
+    }
+
+    void StartupTrace::Mark(const char* name) {
+        if (!IsRecording()) return;
+        double now = Now();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& mark : marks) {
+            if (mark.first == name) return;
+        }
+        marks.emplace_back(name, now);
+    }
+
+    void StartupTrace::SetThreadName(const std::string& name) {
+        if (!IsRecording()) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        threadNames[CurrentThread()] = name;
+    }
+
+    void StartupTrace::SetMetadata(const std::string& key, const std::string& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& entry : metadata) {
+            if (entry.first == key) {
+                entry.second = value;
+                return;
+            }
+        }
+        metadata.emplace_back(key, value);
+    }
+
+    void StartupTrace::Finish() {
+        if (!recording.exchange(false)) return;
+        double now = Now();
+        std::lock_guard<std::mutex> lock(mutex);
+        finishMs = now;
+        for (TraceEvent& event : events) {
+            if (event.endMs < 0.0) event.endMs = now;
+        }
+    }
+
+    std::vector<TraceEvent> StartupTrace::GetEvents() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events;
+    }
+
+    std::vector<std::string> StartupTrace::GetThreadNames() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return threadNames;
+    }
+
+    // Duração de cada evento menos a dos filhos diretos (mesma thread por construção)
+    std::vector<double> StartupTrace::SelfTimes() const {
+        std::vector<double> self(events.size());
+        for (size_t i = 0; i < events.size(); ++i) {
+            self[i] = std::max(0.0, events[i].endMs - events[i].startMs);
+        }
+        for (const TraceEvent& event : events) {
+            if (event.parent >= 0) self[event.parent] -= std::max(0.0, event.endMs - event.startMs);
+        }
+        for (double& value : self) value = std::max(0.0, value);
+        return self;
+    }
+
+    // Uma linha por nome de fase, pela ordem em que cada fase começou
+    std::vector<StartupTrace::Phase> StartupTrace::SummarizePhases() const {
+        std::vector<double> self = SelfTimes();
+        std::vector<Phase> phases;
+        std::map<std::string, size_t> byName;
+        for (size_t i = 0; i < events.size(); ++i) {
+            const TraceEvent& event = events[i];
+            auto found = byName.find(event.name);
+            if (found == byName.end()) {
+                found = byName.emplace(event.name, phases.size()).first;
+                Phase phase;
+                phase.name = event.name;
+                phase.firstStartMs = event.startMs;
+                phases.push_back(phase);
+            }
+            Phase& phase = phases[found->second];
+            ++phase.count;
+            phase.totalMs += std::max(0.0, event.endMs - event.startMs);
+            phase.selfMs += self[i];
+            phase.firstStartMs = std::min(phase.firstStartMs, event.startMs);
+            phase.bytes += event.bytes;
+        }
+        std::stable_sort(phases.begin(), phases.end(), [](const Phase& a, const Phase& b) {
+            return a.firstStartMs < b.firstStartMs;
+        });
+        return phases;
+    }
+
+    bool StartupTrace::WriteFolded(const std::string& filePath) const {
+        // Pilhas iguais (ex.: as 16 texturas) somam-se, como faria o stackcollapse
+        std::vector<double> self = SelfTimes();
+        std::map<std::string, double> stacks;
+        for (size_t i = 0; i < events.size(); ++i) {
+            std::string stack;
+            for (int e = static_cast<int>(i); e >= 0; e = events[e].parent) {
+                stack = FoldedFrame(events[e].name) + (stack.empty() ? "" : ";") + stack;
+            }
+            stack = FoldedFrame(threadNames[events[i].thread]) + ";" + stack;
+            stacks[stack] += self[i];
+        }
+
+        std::string text;
+        for (const auto& stack : stacks) {
+            long long microseconds = static_cast<long long>(stack.second * 1000.0 + 0.5);
+            if (microseconds <= 0) continue;
+            text += stack.first + " " + std::to_string(microseconds) + "\n";
+        }
+        return WriteTextFile(filePath, text);
+    }
+
+    bool StartupTrace::WriteChromeTrace(const std::string& filePath) const {
+        std::string text = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto append = [&](const std::string& line) {
+            if (!first) text += ",\n";
+            text += line;
+            first = false;
+        };
+        for (size_t i = 0; i < threadNames.size(); ++i) {
+            append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(i) +
+                ",\"args\":{\"name\":" + JsonString(threadNames[i]) + "}}");
+        }
+        for (const TraceEvent& event : events) {
+            std::string line = "{\"name\":" + JsonString(event.name) + ",\"cat\":\"arranque\",\"ph\":\"X\",\"pid\":1,\"tid\":" +
+                std::to_string(event.thread) + ",\"ts\":" + JsonNumber(event.startMs * 1000.0) +
+                ",\"dur\":" + JsonNumber(std::max(0.0, event.endMs - event.startMs) * 1000.0) +
+                ",\"args\":{\"bytes\":" + std::to_string(event.bytes);
+            if (!event.detail.empty()) line += ",\"detail\":" + JsonString(event.detail);
+            append(line + "}}");
+        }
+        for (const auto& mark : marks) {
+            append("{\"name\":" + JsonString(mark.first) + ",\"cat\":\"arranque\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":" +
+                JsonNumber(mark.second * 1000.0) + "}");
+        }
+        text += "\n]}\n";
+        return WriteTextFile(filePath, text);
+    }
+
+    bool StartupTrace::WriteSummary(const std::string& filePath) const {
+        std::string text = "{\n  \"format\": \"p3d-startup\",\n  \"version\": 1,\n";
+        text += "  \"total_ms\": " + JsonNumber(finishMs) + ",\n";
+        text += "  \"pre_main_ms\": " + JsonNumber(preMainMs) + ",\n";
+
+        text += "  \"marks\": {";
+        for (size_t i = 0; i < marks.size(); ++i) {
+            text += (i ? ", " : "") + JsonString(marks[i].first) + ": " + JsonNumber(marks[i].second);
+        }
+        text += "},\n  \"metadata\": {";
+        for (size_t i = 0; i < metadata.size(); ++i) {
+            text += (i ? ", " : "") + JsonString(metadata[i].first) + ": " + JsonString(metadata[i].second);
+        }
+        text += "},\n  \"threads\": [";
+        for (size_t i = 0; i < threadNames.size(); ++i) {
+            text += (i ? ", " : "") + JsonString(threadNames[i]);
+        }
+        text += "],\n  \"phases\": [\n";
+        std::vector<Phase> phases = SummarizePhases();
+        for (size_t i = 0; i < phases.size(); ++i) {
+            const Phase& phase = phases[i];
+            text += "    {\"name\": " + JsonString(phase.name) + ", \"count\": " + std::to_string(phase.count) +
+                ", \"start_ms\": " + JsonNumber(phase.firstStartMs) + ", \"total_ms\": " + JsonNumber(phase.totalMs) +
+                ", \"self_ms\": " + JsonNumber(phase.selfMs) + ", \"bytes\": " + std::to_string(phase.bytes) + "}";
+            text += (i + 1 < phases.size()) ? ",\n" : "\n";
+        }
+        text += "  ]\n}\n";
+        return WriteTextFile(filePath, text);
+    }
+
+    bool StartupTrace::WriteReports(const std::string& directory) const {
+        std::string prefix = directory;
+        if (!prefix.empty() && prefix.back() != '/' && prefix.back() != '\\') prefix += '/';
+        MakeDirectory(prefix);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        bool folded = WriteFolded(prefix + "startup.folded");
+        bool trace = WriteChromeTrace(prefix + "startup.trace.json");
+        bool summary = WriteSummary(prefix + "startup.summary.json");
+        return folded && trace && summary;
+    }
+
+    void StartupTrace::PrintSummary() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::printf("Arranque: %.1f ms ate ao fim do trace (%.1f ms antes do main)\n", finishMs, preMainMs);
+        for (const auto& mark : marks) {
+            std::printf("  %-28s %9.1f ms\n", mark.first.c_str(), mark.second);
+        }
+        std::printf("  %-28s %5s %9s %9s %9s %10s\n", "fase", "n", "inicio", "total", "proprio", "KB");
+        for (const Phase& phase : SummarizePhases()) {
+            std::printf("  %-28s %5u %9.1f %9.1f %9.1f %10.1f\n", phase.name.c_str(), phase.count,
+                phase.firstStartMs, phase.totalMs, phase.selfMs, phase.bytes / 1024.0);
+        }
+    }
+
+} // namespace P3D
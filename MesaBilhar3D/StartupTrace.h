@@ -0,0 +1,131 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace P3D {
+
+    // Um intervalo do arranque. Os tempos contam desde a criação do processo (inclui o
+    // loader e os construtores estáticos, quando o sistema diz quando o processo nasceu).
+    struct TraceEvent {
+        std::string name;           // fase, igual em todas as execuções ("textura.descodificar")
+        std::string detail;         // o que foi processado (ficheiro, programa...)
+        unsigned int thread = 0;    // índice em StartupTrace::GetThreadNames()
+        int parent = -1;            // evento que o contém na mesma thread
+        double startMs = 0.0;
+        double endMs = -1.0;        // < 0 enquanto está aberto
+        uint64_t bytes = 0;
+    };
+
+    // Linha do tempo do arranque até ao primeiro frame apresentado (--startup-trace).
+    // Desligada não regista nada e cada TraceScope custa uma leitura atómica. Pode ser
+    // usada de qualquer thread; cada thread tem a sua pilha de eventos.
+    //
+    // WriteReports grava na pasta pedida:
+    //  - startup.folded: pilhas "thread;fase;subfase tempo_próprio_us", o formato do
+    //    flamegraph.pl / speedscope / inferno;
+    //  - startup.trace.json: Trace Event Format (chrome://tracing, Perfetto), um evento por
+    //    intervalo com thread, bytes e detalhe;
+    //  - startup.summary.json: totais por fase e marcos, com nomes estáveis para comparar
+    //    execuções num job de benchmark.
+    class StartupTrace {
+    public:
+        static StartupTrace& Instance();
+
+        // Começa a registar; a thread que chama passa a ser a "principal"
+        void Enable();
+        bool IsRecording() const { return recording.load(std::memory_order_relaxed); }
+
+        // Milissegundos desde a criação do processo
+        double Now() const;
+        double ToTraceMs(std::chrono::steady_clock::time_point time) const;
+
+        // Abre um evento na thread atual; devolve o índice para o End (-1 se não regista)
+        int Begin(const char* name, const std::string& detail = std::string());
+        void End(int event, uint64_t bytes = 0);
+        // Intervalo já medido noutro sítio (ex.: compilação de shaders nas threads do
+        // driver), numa linha própria do trace
+        void AddSpan(const std::string& track, const char* name, const std::string& detail,
+            double startMs, double endMs, uint64_t bytes = 0);
+        // Instante com nome (ex.: "primeiro-frame"); o primeiro de cada nome vai para o resumo
+        void Mark(const char* name);
+        void SetThreadName(const std::string& name);
+        // Pares chave/valor copiados para o resumo (GPU, opções da execução...)
+        void SetMetadata(const std::string& key, const std::string& value);
+
+        // Deixa de registar; os eventos ainda abertos são fechados agora
+        void Finish();
+
+        bool WriteReports(const std::string& directory) const;
+        void PrintSummary() const;
+
+        std::vector<TraceEvent> GetEvents() const;
+        std::vector<std::string> GetThreadNames() const;
+
+    private:
+        struct Phase {
+            std::string name;
+            unsigned int count = 0;
+            double totalMs = 0.0;
+            double selfMs = 0.0;        // sem o tempo dos filhos na mesma thread
+            double firstStartMs = 0.0;
+            uint64_t bytes = 0;
+        };
+
+        std::atomic<bool> recording{ false };
+        std::chrono::steady_clock::time_point origin;   // criação do processo
+        double preMainMs = 0.0;                         // 0 se o sistema não o disser
+        double finishMs = 0.0;
+
+        mutable std::mutex mutex;
+        std::vector<TraceEvent> events;
+        std::vector<std::string> threadNames;
+        std::vector<std::pair<std::string, double>> marks;
+        std::vector<std::pair<std::string, std::string>> metadata;
+
+        StartupTrace() = default;
+        StartupTrace(const StartupTrace&) = delete;
+        StartupTrace& operator=(const StartupTrace&) = delete;
+
+        unsigned int CurrentThread();
+        unsigned int TrackIndex(const std::string& name);
+        std::vector<Phase> SummarizePhases() const;
+        std::vector<double> SelfTimes() const;
+        bool WriteFolded(const std::string& filePath) const;
+        bool WriteChromeTrace(const std::string& filePath) const;
+        bool WriteSummary(const std::string& filePath) const;
+    };
+
+    // Evento do âmbito atual: TraceScope scope("obj", caminho); scope.AddBytes(n);
+    // End() fecha-o antes do fim do âmbito.
+    class TraceScope {
+    public:
+        explicit TraceScope(const char* name, const std::string& detail = std::string())
+            : event(StartupTrace::Instance().IsRecording() ? StartupTrace::Instance().Begin(name, detail) : -1), bytes(0) {
+        }
+        ~TraceScope() {
+            End();
+        }
+        void AddBytes(uint64_t count) { bytes += count; }
+        void End() {
+            if (event >= 0) StartupTrace::Instance().End(event, bytes);
+            event = -1;
+        }
+
+    private:
+        int event;
+        uint64_t bytes;
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // STARTUPTRACE_H
@@ -0,0 +1,239 @@
+#include "StaticBatch.h"
+#include <cstring>
+#include <iostream>
+
+namespace P3D {
+
+    StaticBatch::StaticBatch()
+        : VAO(0), VBO(0), EBO(0), indirectBuffer(0), uniformBuffer(0), multiDrawIndirect(false),
+        residency(MeshResidency::Positions), gpuBytes(0)
+    {
+    }
+
+    StaticBatch::~StaticBatch() {
+        Destroy();
+    }
+
+    void StaticBatch::Destroy() {
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        if (indirectBuffer) glDeleteBuffers(1, &indirectBuffer);
+        if (uniformBuffer) glDeleteBuffers(1, &uniformBuffer);
+        commandRing.Destroy();
+        VAO = VBO = EBO = indirectBuffer = uniformBuffer = 0;
+        gpuBytes = 0;
+    }
+
+    int StaticBatch::AddMesh(const std::vector<Vertex>& meshVertices, const std::vector<unsigned int>& meshIndices) {
+        Mesh mesh;
+        mesh.firstIndex = static_cast<GLuint>(indices.size());
+        mesh.indexCount = static_cast<GLuint>(meshIndices.size());
+        mesh.baseVertex = static_cast<GLint>(vertices.size());
+        if (!meshVertices.empty()) {
+            mesh.box = ComputeBounds(&meshVertices[0].position, meshVertices.size(), sizeof(Vertex)).box;
+        }
+
+        // Os índices ficam locais à malha; baseVertex desloca-os no draw
+        vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+        indices.insert(indices.end(), meshIndices.begin(), meshIndices.end());
+
+        meshes.push_back(mesh);
+        return static_cast<int>(meshes.size()) - 1;
+    }
+
+    int StaticBatch::AddDraw(int meshID, const glm::mat4& model, const glm::vec4& color) {
+        if (meshID < 0 || meshID >= static_cast<int>(meshes.size())) return -1;
+        if (draws.size() >= static_cast<size_t>(MAX_DRAWS)) {
+            std::cerr << "StaticBatch: limite de " << MAX_DRAWS << " draws atingido" << std::endl;
+            return -1;
+        }
+
+        const Mesh& mesh = meshes[meshID];
+
+        DrawEntry draw;
+        draw.meshID = meshID;
+        draw.worldBox = TransformAABB(mesh.box, model);
+        draws.push_back(draw);
+
+        StaticDrawData data;
+        data.model = model;
+        data.color = color;
+        drawData.push_back(data);
+
+        DrawElementsIndirectCommand command;
+        command.count = mesh.indexCount;
+        command.instanceCount = 1;
+        command.firstIndex = mesh.firstIndex;
+        command.baseVertex = mesh.baseVertex;
+        command.baseInstance = 0;
+        commands.push_back(command);
+
+        return static_cast<int>(draws.size()) - 1;
+    }
+
+    bool StaticBatch::Build() {
+        if (draws.empty()) return false;
+
+        multiDrawIndirect = GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_draw_parameters;
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+        SetupVertexAttributes(VertexFormat::Float32, 0, 1, 2);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+        glBindVertexArray(0);
+
+        // Dados por draw: tamanho fixo MAX_DRAWS para coincidir com o bloco do shader
+        glGenBuffers(1, &uniformBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, MAX_DRAWS * sizeof(StaticDrawData), nullptr, GL_STATIC_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, drawData.size() * sizeof(StaticDrawData), drawData.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        if (multiDrawIndirect) {
+            glGenBuffers(1, &indirectBuffer);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+                commands.data(), GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+            // A visibilidade muda os comandos em cada passo: escritos diretamente na memória
+            // mapeada em vez de copiados pelo driver
+            commandRing.Create(GL_DRAW_INDIRECT_BUFFER, MAX_PASSES * MAX_DRAWS * sizeof(DrawElementsIndirectCommand));
+        }
+
+        gpuBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int) +
+            MAX_DRAWS * sizeof(StaticDrawData);
+        if (multiDrawIndirect) gpuBytes += commands.size() * sizeof(DrawElementsIndirectCommand);
+        if (UsesCommandRing()) gpuBytes += RingBuffer::FRAMES * MAX_PASSES * MAX_DRAWS * sizeof(DrawElementsIndirectCommand);
+        ReleaseGeometry();
+        return true;
+    }
+
+    // O desenho só precisa de commands (visibilidade) e dos buffers GL. As posições
+    // mantêm a numeração dos vértices, por isso firstIndex/baseVertex continuam a servir.
+    void StaticBatch::ReleaseGeometry() {
+        if (residency == MeshResidency::BoundsOnly) {
+            FreeVector(vertices);
+            FreeVector(indices);
+            return;
+        }
+        positions.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) positions[i] = vertices[i].position;
+        if (residency == MeshResidency::Positions) FreeVector(vertices);
+    }
+
+    bool StaticBatch::GetCollisionMesh(int drawIndex, CollisionMesh& mesh) const {
+        if (drawIndex < 0 || drawIndex >= static_cast<int>(draws.size()) || positions.empty()) return false;
+        const Mesh& source = meshes[draws[drawIndex].meshID];
+        mesh.positions = positions.data();
+        mesh.indices = indices.data() + source.firstIndex;
+        mesh.indexCount = source.indexCount;
+        mesh.baseVertex = source.baseVertex;
+        mesh.model = drawData[drawIndex].model;
+        return true;
+    }
+
+    AssetMemory StaticBatch::GetMemory(const std::string& name) const {
+        AssetMemory memory;
+        memory.name = name;
+        memory.residency = ResidencyName(residency);
+        memory.cpuBytes = ReservedBytes(vertices) + ReservedBytes(indices) + ReservedBytes(positions) +
+            ReservedBytes(meshes) + ReservedBytes(draws) + ReservedBytes(drawData) + ReservedBytes(commands);
+        memory.gpuBytes = gpuBytes;
+        return memory;
+    }
+
+    const char* StaticBatch::ShaderHeader() const {
+        if (multiDrawIndirect) {
+            return "#version 330 core\n"
+                "#extension GL_ARB_shader_draw_parameters : require\n"
+                "#define DRAW_ID gl_DrawIDARB\n";
+        }
+        return "#version 330 core\n"
+            "uniform int uDrawID;\n"
+            "#define DRAW_ID uDrawID\n";
+    }
+
+    void StaticBatch::SetupProgram(GLuint shaderProgram) const {
+        GLuint blockIndex = glGetUniformBlockIndex(shaderProgram, "StaticDraws");
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(shaderProgram, blockIndex, UNIFORM_BINDING);
+        }
+    }
+
+    void StaticBatch::BeginFrame() {
+        if (UsesCommandRing()) commandRing.BeginFrame();
+    }
+
+    void StaticBatch::EndFrame() {
+        if (UsesCommandRing()) commandRing.EndFrame();
+    }
+
+    void StaticBatch::Draw(GLuint shaderProgram, const Frustum* frustum, CullStats* cullStats, RenderStats* renderStats) {
+        if (!VAO) return;
+
+        // Draws fora do frustum ficam com instanceCount 0 (gl_DrawID mantém-se igual ao índice)
+        unsigned int visibleCount = 0;
+        for (size_t i = 0; i < draws.size(); ++i) {
+            bool visible = !frustum || frustum->TestAABB(draws[i].worldBox);
+            commands[i].instanceCount = visible ? 1 : 0;
+            if (visible) ++visibleCount;
+        }
+        if (cullStats) {
+            cullStats->tested += static_cast<unsigned int>(draws.size());
+            cullStats->visible += visibleCount;
+        }
+        if (visibleCount == 0) return;
+
+        glUseProgram(shaderProgram);
+        glBindBufferBase(GL_UNIFORM_BUFFER, UNIFORM_BINDING, uniformBuffer);
+        glBindVertexArray(VAO);
+        if (renderStats) {
+            renderStats->programBinds++;
+            renderStats->vaoBinds++;
+        }
+
+        if (multiDrawIndirect) {
+            const GLsizeiptr commandBytes = commands.size() * sizeof(DrawElementsIndirectCommand);
+            RingAllocation allocation;
+            if (UsesCommandRing()) allocation = commandRing.Allocate(commandBytes, sizeof(GLuint));
+            if (allocation.ptr) {
+                std::memcpy(allocation.ptr, commands.data(), commandBytes);
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandRing.GetBuffer());
+            }
+            else {
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+                glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandBytes, commands.data());
+            }
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(allocation.offset),
+                static_cast<GLsizei>(commands.size()), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            if (renderStats) renderStats->drawCalls++;
+        }
+        else {
+            GLint drawIDLoc = glGetUniformLocation(shaderProgram, "uDrawID");
+            for (size_t i = 0; i < commands.size(); ++i) {
+                const DrawElementsIndirectCommand& command = commands[i];
+                if (command.instanceCount == 0) continue;
+
+                glUniform1i(drawIDLoc, static_cast<GLint>(i));
+                glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+                    (void*)(command.firstIndex * sizeof(unsigned int)), command.baseVertex);
+                if (renderStats) renderStats->drawCalls++;
+            }
+        }
+
+        glBindVertexArray(0);
+    }
+
+} // namespace P3D
@@ -0,0 +1,123 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "DrawQueue.h"
+#include "Frustum.h"
+#include "Residency.h"
+#include "RingBuffer.h"
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // Layout exigido por glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    // Dados por draw lidos no vertex shader com gl_DrawID (std140: 80 bytes)
+    struct StaticDrawData {
+        glm::mat4 model;
+        glm::vec4 color;
+    };
+
+    // Geometria de colisão de um draw: vértice i da malha = positions[baseVertex + indices[i]],
+    // em espaço do modelo (model leva-o para o mundo)
+    struct CollisionMesh {
+        const glm::vec3* positions;
+        const unsigned int* indices;
+        GLuint indexCount;
+        GLint baseVertex;
+        glm::mat4 model;
+    };
+
+    // Junta toda a geometria estática (mesa, tabelas, bolsos, ...) num único
+    // VBO/EBO e desenha tudo com um glMultiDrawElementsIndirect.
+    // Sem GL_ARB_multi_draw_indirect / GL_ARB_shader_draw_parameters faz um
+    // glDrawElementsBaseVertex por draw com o índice no uniform uDrawID.
+    class StaticBatch {
+    public:
+        static const int MAX_DRAWS = 128;        // tem de coincidir com o array do shader
+        static const GLuint UNIFORM_BINDING = 0; // binding point do bloco StaticDraws
+        static const int MAX_PASSES = 8;         // Draws por frame com espaço no anel de comandos
+
+        StaticBatch();
+        ~StaticBatch();
+
+        // Devolve o ID da malha; a mesma malha pode ser usada por vários draws
+        int AddMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+        // Devolve o índice do draw (= gl_DrawID) ou -1 se MAX_DRAWS foi atingido
+        int AddDraw(int meshID, const glm::mat4& model, const glm::vec4& color);
+
+        bool Build();
+        // Liberta os buffers GL (tem de ser chamado com o contexto ainda ativo)
+        void Destroy();
+        // Cabeçalho a pôr antes do vertex shader: define DRAW_ID para o caminho escolhido
+        const char* ShaderHeader() const;
+        // Liga o bloco StaticDraws do programa ao UNIFORM_BINDING
+        void SetupProgram(GLuint shaderProgram) const;
+
+        // Delimitam um frame: os comandos indiretos de cada Draw são escritos num RingBuffer
+        // persistentemente mapeado, cuja região só é reutilizada quando a GPU acabar o frame
+        void BeginFrame();
+        void EndFrame();
+        // Desenha os draws dentro do frustum (se dado); view/projection já definidos no programa
+        void Draw(GLuint shaderProgram, const Frustum* frustum, CullStats* cullStats, RenderStats* renderStats);
+
+        bool UsesMultiDrawIndirect() const { return multiDrawIndirect; }
+        // Sem ARB_buffer_storage os comandos vão por glBufferSubData
+        bool UsesCommandRing() const { return commandRing.GetBuffer() != 0; }
+        size_t GetDrawCount() const { return draws.size(); }
+
+        // O que fica na CPU depois do Build (ver MeshResidency); por omissão só as posições
+        void SetResidency(MeshResidency policy) { residency = policy; }
+        // Falso antes do Build, com BoundsOnly ou com drawIndex inválido
+        bool GetCollisionMesh(int drawIndex, CollisionMesh& mesh) const;
+        AssetMemory GetMemory(const std::string& name) const;
+
+    private:
+        struct Mesh {
+            GLuint firstIndex;
+            GLuint indexCount;
+            GLint baseVertex;
+            AABB box;
+        };
+
+        struct DrawEntry {
+            int meshID;
+            AABB worldBox;
+        };
+
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<glm::vec3> positions;   // cópia para colisões, feita no Build
+        std::vector<Mesh> meshes;
+        std::vector<DrawEntry> draws;
+        std::vector<StaticDrawData> drawData;
+        std::vector<DrawElementsIndirectCommand> commands;
+
+        GLuint VAO, VBO, EBO;
+        GLuint indirectBuffer;          // caminho glBufferSubData (sem anel ou anel esgotado)
+        RingBuffer commandRing;
+        GLuint uniformBuffer;
+        bool multiDrawIndirect;
+        MeshResidency residency;
+        size_t gpuBytes;
+
+        void ReleaseGeometry();
+
+        StaticBatch(const StaticBatch&) = delete;
+        StaticBatch& operator=(const StaticBatch&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // STATICBATCH_H
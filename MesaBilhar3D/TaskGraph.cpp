@@ -0,0 +1,222 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include "StartupTrace.h"
+
+namespace P3D {
+
+    TaskGraph::TaskGraph(unsigned int count)
+        : threadCount(count)
+    {
+        if (threadCount == 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            threadCount = hardware > 1 ? hardware - 1 : 1;
+        }
+    }
+
+    int TaskGraph::Add(const std::string& name, TaskQueue queue, Work work, const std::vector<int>& dependencies) {
+        if (ran) {
+            std::cerr << "Erro ao acrescentar tarefa depois do Run: " << name << std::endl;
+            return -1;
+        }
+        const int index = static_cast<int>(tasks.size());
+        std::unique_ptr<Task> task(new Task());
+        task->name = name;
+        task->queue = queue;
+        task->work = std::move(work);
+        for (int dependency : dependencies) {
+            // Só tarefas anteriores: o grafo fica acíclico por construção
+            if (dependency < 0 || dependency >= index) {
+                std::cerr << "Erro ao acrescentar tarefa " << name << ": dependencia invalida " << dependency << std::endl;
+                continue;
+            }
+            task->dependencies.push_back(dependency);
+            tasks[dependency]->dependents.push_back(index);
+        }
+        task->remaining.store(static_cast<int>(task->dependencies.size()));
+        tasks.push_back(std::move(task));
+        return index;
+    }
+
+    bool TaskGraph::Succeeded(int task) const {
+        return task >= 0 && task < static_cast<int>(tasks.size()) && tasks[task]->state == TaskState::Done;
+    }
+
+    // worker >= 0: a tarefa foi libertada por esse worker e vai para a fila dele
+    void TaskGraph::Schedule(int task, int worker) {
+        if (tasks[task]->queue == TaskQueue::GLThread) {
+            {
+                std::lock_guard<std::mutex> lock(glMutex);
+                glTasks.push_back(task);
+            }
+            glWake.notify_one();
+            return;
+        }
+
+        int target = worker >= 0 ? worker : static_cast<int>(nextQueue.fetch_add(1) % threadCount);
+        {
+            std::lock_guard<std::mutex> lock(workerQueues[target]->mutex);
+            workerQueues[target]->tasks.push_back(task);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            ++queued;
+        }
+        workAvailable.notify_one();
+    }
+
+    bool TaskGraph::PopWorkerTask(int worker, int& task) {
+        bool found = false;
+        {
+            WorkerQueue& own = *workerQueues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                found = true;
+            }
+        }
+        for (unsigned int i = 1; !found && i < threadCount; ++i) {
+            WorkerQueue& victim = *workerQueues[(worker + i) % threadCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                found = true;
+                steals.fetch_add(1);
+            }
+        }
+        if (found) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            --queued;
+        }
+        return found;
+    }
+
+    void TaskGraph::Execute(int index, int worker) {
+        Task& task = *tasks[index];
+        if (task.dependencyFailed.load()) {
+            Complete(index, false, worker);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool success = false;
+        {
+            TraceScope scope(task.name.c_str());
+            success = task.work();
+        }
+        task.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        task.state = success ? TaskState::Done : TaskState::Failed;
+        Complete(index, success, worker);
+    }
+
+    void TaskGraph::Complete(int index, bool success, int worker) {
+        Task& task = *tasks[index];
+        if (task.state == TaskState::Waiting) task.state = TaskState::Skipped;
+        for (int dependent : task.dependents) {
+            if (!success) tasks[dependent]->dependencyFailed.store(true);
+            // A última dependência a terminar agenda a tarefa (a fila é a de quem a libertou)
+            if (tasks[dependent]->remaining.fetch_sub(1) == 1) Schedule(dependent, worker);
+        }
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(glMutex);
+            last = --unfinished == 0;
+        }
+        if (last) glWake.notify_one();
+    }
+
+    void TaskGraph::WorkerLoop(int worker) {
+        StartupTrace::Instance().SetThreadName("carregador " + std::to_string(worker + 1));
+        for (;;) {
+            int task = -1;
+            if (PopWorkerTask(worker, task)) {
+                Execute(task, worker);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            workAvailable.wait(lock, [this]() { return queued > 0 || finished; });
+            if (finished && queued == 0) return;
+        }
+    }
+
+    void TaskGraph::Run(const std::function<void()>& idle) {
+        if (ran) return;
+        ran = true;
+        runStart = std::chrono::steady_clock::now();
+        unfinished = static_cast<int>(tasks.size());
+
+        workerQueues.clear();
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            workerQueues.emplace_back(new WorkerQueue());
+        }
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (tasks[i]->dependencies.empty()) Schedule(static_cast<int>(i), -1);
+        }
+
+        std::vector<std::thread> workers;
+        if (!tasks.empty()) {
+            for (unsigned int i = 0; i < threadCount; ++i) {
+                workers.emplace_back(&TaskGraph::WorkerLoop, this, static_cast<int>(i));
+            }
+        }
+
+        // Esta thread só corre as tarefas GL, pela ordem em que ficam prontas
+        auto hasWork = [this]() { return !glTasks.empty() || unfinished == 0; };
+        std::unique_lock<std::mutex> lock(glMutex);
+        for (;;) {
+            if (!idle) glWake.wait(lock, hasWork);
+            else if (!glWake.wait_for(lock, std::chrono::milliseconds(2), hasWork)) {
+                lock.unlock();
+                idle();
+                lock.lock();
+                continue;
+            }
+            if (glTasks.empty()) break;
+            int task = glTasks.front();
+            glTasks.pop_front();
+            lock.unlock();
+            Execute(task, -1);
+            if (idle) idle();
+            lock.lock();
+        }
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> sleepLock(sleepMutex);
+            finished = true;
+        }
+        workAvailable.notify_all();
+        for (std::thread& worker : workers) worker.join();
+
+        ComputeStats();
+    }
+
+    void TaskGraph::ComputeStats() {
+        stats = TaskGraphStats();
+        stats.tasks = static_cast<unsigned int>(tasks.size());
+        stats.workers = threadCount;
+        stats.steals = steals.load();
+        stats.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - runStart).count();
+
+        // As dependências têm sempre índices menores: uma passagem chega
+        std::vector<double> finish(tasks.size(), 0.0);
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            const Task& task = *tasks[i];
+            if (task.state == TaskState::Failed) ++stats.failed;
+            if (task.state == TaskState::Skipped) ++stats.skipped;
+            stats.workMs += task.durationMs;
+            if (task.queue == TaskQueue::GLThread) stats.glThreadMs += task.durationMs;
+
+            double ready = 0.0;
+            for (int dependency : task.dependencies) ready = std::max(ready, finish[dependency]);
+            finish[i] = ready + task.durationMs;
+            stats.criticalPathMs = std::max(stats.criticalPathMs, finish[i]);
+        }
+    }
+
+} // namespace P3D
@@ -0,0 +1,121 @@
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace P3D {
+
+    // Onde a tarefa corre: numa thread do pool ou na thread que chamou Run (a do contexto GL)
+    enum class TaskQueue {
+        Worker,
+        GLThread
+    };
+
+    struct TaskGraphStats {
+        unsigned int tasks = 0;
+        unsigned int failed = 0;         // devolveram falso
+        unsigned int skipped = 0;        // não correram porque uma dependência falhou
+        unsigned int workers = 0;
+        unsigned int steals = 0;         // tarefas tiradas da fila de outra thread
+        double wallMs = 0.0;             // Run do início ao fim
+        double workMs = 0.0;             // soma das durações de todas as tarefas
+        double glThreadMs = 0.0;         // soma das tarefas GLThread (corridas em série)
+        double criticalPathMs = 0.0;     // caminho mais longo pelas dependências, com as durações medidas
+    };
+
+    // Grafo de tarefas com dependências explícitas, corrido uma vez por Run.
+    // As tarefas Worker correm num pool com roubo de trabalho: cada thread tem a sua fila,
+    // tira do fim as tarefas que ela própria libertou (os dados ainda estão na cache) e,
+    // sem trabalho, rouba do início da fila de outra. As tarefas GLThread (envios para a
+    // GPU) correm todas na thread que chamou Run, pela ordem em que ficam prontas.
+    // Uma tarefa que devolve falso faz saltar todas as que dependem dela.
+    class TaskGraph {
+    public:
+        typedef std::function<bool()> Work;
+
+        // threadCount 0 = hardware_concurrency() - 1 (a thread GL também trabalha), mínimo 1
+        explicit TaskGraph(unsigned int threadCount = 0);
+
+        // Acrescenta uma tarefa; as dependências têm de ter sido acrescentadas antes.
+        // Devolve o índice da tarefa.
+        int Add(const std::string& name, TaskQueue queue, Work work, const std::vector<int>& dependencies = std::vector<int>());
+
+        // Corre o grafo todo e só volta quando todas as tarefas terminaram ou foram saltadas.
+        // idle corre na thread GL depois de cada tarefa GL e a cada ~2 ms enquanto espera
+        // (ex.: recolher os shaders que o driver já compilou).
+        void Run(const std::function<void()>& idle = std::function<void()>());
+
+        // Depois do Run: verdadeiro se a tarefa correu e devolveu verdadeiro
+        bool Succeeded(int task) const;
+        const TaskGraphStats& GetStats() const { return stats; }
+        size_t GetTaskCount() const { return tasks.size(); }
+
+    private:
+        enum class TaskState {
+            Waiting,
+            Done,
+            Failed,
+            Skipped
+        };
+
+        struct Task {
+            std::string name;
+            TaskQueue queue = TaskQueue::Worker;
+            Work work;
+            std::vector<int> dependents;
+            std::vector<int> dependencies;
+            std::atomic<int> remaining{ 0 };    // dependências por terminar
+            std::atomic<bool> dependencyFailed{ false };
+            TaskState state = TaskState::Waiting;
+            double durationMs = 0.0;
+        };
+
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<int> tasks;
+        };
+
+        unsigned int threadCount;
+        std::vector<std::unique_ptr<Task>> tasks;
+        std::vector<std::unique_ptr<WorkerQueue>> workerQueues;
+        TaskGraphStats stats;
+        bool ran = false;
+
+        // Adormecer os workers sem perder notificações: queued só muda com sleepMutex
+        std::mutex sleepMutex;
+        std::condition_variable workAvailable;
+        int queued = 0;
+        bool finished = false;
+
+        // Fila da thread GL e contagem de tarefas por terminar (fim do Run)
+        std::mutex glMutex;
+        std::condition_variable glWake;
+        std::deque<int> glTasks;
+        int unfinished = 0;
+
+        std::atomic<unsigned int> steals{ 0 };
+        std::atomic<unsigned int> nextQueue{ 0 };
+        std::chrono::steady_clock::time_point runStart;
+
+        void Schedule(int task, int worker);
+        void Execute(int task, int worker);
+        void Complete(int task, bool success, int worker);
+        bool PopWorkerTask(int worker, int& task);
+        void WorkerLoop(int worker);
+        void ComputeStats();
+
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+    };
+
+} // namespace P3D
+
+#endif // TASKGRAPH_H
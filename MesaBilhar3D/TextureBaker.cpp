@@ -0,0 +1,525 @@
+#include "TextureBaker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define P3D_BAKER_SSE 1
+#endif
+
+#include "ImageDecode.h"
+
+namespace P3D {
+
+    static const char PACK_MAGIC[4] = { 'P', '3', 'D', 'T' };
+    static const uint32_t PACK_VERSION = 1;
+
+    // Cabeçalho do .p3dtex; segue-se, por nível, largura, altura, bytes e os blocos
+    struct PackHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t format;
+        uint32_t mipCount;
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+    };
+
+    struct PackMipHeader {
+        uint32_t width;
+        uint32_t height;
+        uint32_t byteCount;
+        uint32_t reserved;
+    };
+
+    static bool FileStamp(const std::string& path, uint64_t& size, int64_t& time) {
+#ifdef _WIN32
+        struct _stat64 info;
+        if (_stat64(path.c_str(), &info) != 0) return false;
+#else
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+#endif
+        size = static_cast<uint64_t>(info.st_size);
+        time = static_cast<int64_t>(info.st_mtime);
+        return true;
+    }
+
+    static bool ReadFile(const std::string& filePath, std::vector<unsigned char>& data) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        std::streamoff size = file.tellg();
+        if (size <= 0) return false;
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+    }
+
+    uint64_t HashBytes(const unsigned char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string BakedTexturePath(const std::string& imageFilePath) {
+        size_t dot = imageFilePath.find_last_of('.');
+        size_t slash = imageFilePath.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return imageFilePath + ".p3dtex";
+        return imageFilePath.substr(0, dot) + ".p3dtex";
+    }
+
+    // ---------------------------------------------------------------- mipmaps
+    // As imagens estão em sRGB: a média de 2x2 texels faz-se em luz linear e o resultado
+    // volta a sRGB, senão os níveis pequenos ficam mais escuros do que a imagem original.
+    // O alfa já é linear.
+
+    static const int LINEAR_TO_SRGB_STEPS = 4096;
+
+    struct SRGBTables {
+        float toLinear[256];
+        unsigned char toSRGB[LINEAR_TO_SRGB_STEPS + 1];
+
+        SRGBTables() {
+            for (int i = 0; i < 256; ++i) {
+                float c = i / 255.0f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i <= LINEAR_TO_SRGB_STEPS; ++i) {
+                float l = static_cast<float>(i) / LINEAR_TO_SRGB_STEPS;
+                float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                toSRGB[i] = static_cast<unsigned char>(std::min(255.0f, c * 255.0f + 0.5f));
+            }
+        }
+    };
+
+    static const SRGBTables& Tables() {
+        static const SRGBTables tables;
+        return tables;
+    }
+
+    static unsigned char LinearToSRGB(float l) {
+        l = std::min(1.0f, std::max(0.0f, l));
+        return Tables().toSRGB[static_cast<int>(l * LINEAR_TO_SRGB_STEPS + 0.5f)];
+    }
+
+    // Nível em RGBA float linear, 4 floats por texel
+    struct LinearImage {
+        uint32_t width;
+        uint32_t height;
+        std::vector<float> texels;
+    };
+
+    static void ToLinear(const unsigned char* rgba, uint32_t width, uint32_t height, LinearImage& image) {
+        const SRGBTables& tables = Tables();
+        image.width = width;
+        image.height = height;
+        image.texels.resize(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+            image.texels[i * 4 + 0] = tables.toLinear[rgba[i * 4 + 0]];
+            image.texels[i * 4 + 1] = tables.toLinear[rgba[i * 4 + 1]];
+            image.texels[i * 4 + 2] = tables.toLinear[rgba[i * 4 + 2]];
+            image.texels[i * 4 + 3] = rgba[i * 4 + 3] / 255.0f;
+        }
+    }
+
+    static void ToSRGB8(const LinearImage& image, std::vector<unsigned char>& rgba) {
+        rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+        for (size_t i = 0; i < static_cast<size_t>(image.width) * image.height; ++i) {
+            rgba[i * 4 + 0] = LinearToSRGB(image.texels[i * 4 + 0]);
+            rgba[i * 4 + 1] = LinearToSRGB(image.texels[i * 4 + 1]);
+            rgba[i * 4 + 2] = LinearToSRGB(image.texels[i * 4 + 2]);
+            float a = std::min(1.0f, std::max(0.0f, image.texels[i * 4 + 3]));
+            rgba[i * 4 + 3] = static_cast<unsigned char>(a * 255.0f + 0.5f);
+        }
+    }
+
+    // Filtro de caixa 2x2; nas dimensões ímpares o último texel repete-se
+    static void Downsample(const LinearImage& source, LinearImage& target) {
+        target.width = std::max(1u, source.width / 2);
+        target.height = std::max(1u, source.height / 2);
+        target.texels.resize(static_cast<size_t>(target.width) * target.height * 4);
+
+        const size_t stride = static_cast<size_t>(source.width) * 4;
+        for (uint32_t y = 0; y < target.height; ++y) {
+            const float* row0 = &source.texels[std::min(2 * y, source.height - 1) * stride];
+            const float* row1 = &source.texels[std::min(2 * y + 1, source.height - 1) * stride];
+            float* out = &target.texels[static_cast<size_t>(y) * target.width * 4];
+            for (uint32_t x = 0; x < target.width; ++x) {
+                const size_t x0 = std::min(2 * x, source.width - 1) * 4;
+                const size_t x1 = std::min(2 * x + 1, source.width - 1) * 4;
+#ifdef P3D_BAKER_SSE
+                // Um texel RGBA por registo: 4 somas e uma multiplicação para os 4 canais
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+                    _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+                _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+                for (int c = 0; c < 4; ++c) {
+                    out[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+                }
+#endif
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------- BC1 / BC3
+
+    static uint16_t Pack565(const float color[3]) {
+        int r = static_cast<int>(std::min(255.0f, std::max(0.0f, color[0])) * 31.0f / 255.0f + 0.5f);
+        int g = static_cast<int>(std::min(255.0f, std::max(0.0f, color[1])) * 63.0f / 255.0f + 0.5f);
+        int b = static_cast<int>(std::min(255.0f, std::max(0.0f, color[2])) * 31.0f / 255.0f + 0.5f);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    static void Unpack565(uint16_t packed, int color[3]) {
+        int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // Escolhe o índice mais próximo para cada texel; devolve o erro quadrático total
+    static int ChooseColorIndices(const unsigned char block[64], uint16_t c0, uint16_t c1, uint32_t& indices) {
+        int palette[4][3];
+        Unpack565(c0, palette[0]);
+        Unpack565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        int error = 0;
+        indices = 0;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                int dr = block[i * 4 + 0] - palette[p][0];
+                int dg = block[i * 4 + 1] - palette[p][1];
+                int db = block[i * 4 + 2] - palette[p][2];
+                int e = dr * dr + dg * dg + db * db;
+                if (e < bestError) { bestError = e; best = p; }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+            error += bestError;
+        }
+        return error;
+    }
+
+    // Extremos pelo eixo principal das cores do bloco, depois um passo de mínimos quadrados
+    // com os índices escolhidos. Usa sempre o modo de 4 cores (c0 > c1).
+    static void EncodeColorBlock(const unsigned char block[64], unsigned char out[8]) {
+        float mean[3] = { 0, 0, 0 };
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 3; ++c) mean[c] += block[i * 4 + c];
+        }
+        for (int c = 0; c < 3; ++c) mean[c] /= 16.0f;
+
+        float cov[6] = { 0, 0, 0, 0, 0, 0 };   // xx xy xz yy yz zz
+        for (int i = 0; i < 16; ++i) {
+            float r = block[i * 4 + 0] - mean[0], g = block[i * 4 + 1] - mean[1], b = block[i * 4 + 2] - mean[2];
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+        // Iteração de potência a partir da diagonal (1, 1, 1)
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 6; ++iteration) {
+            float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+            if (length < 1e-6f) break;
+            axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+        }
+
+        int minIndex = 0, maxIndex = 0;
+        float minDot = 1e30f, maxDot = -1e30f;
+        for (int i = 0; i < 16; ++i) {
+            float d = block[i * 4 + 0] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+            if (d < minDot) { minDot = d; minIndex = i; }
+            if (d > maxDot) { maxDot = d; maxIndex = i; }
+        }
+        float endpoint0[3], endpoint1[3];
+        for (int c = 0; c < 3; ++c) {
+            endpoint0[c] = block[maxIndex * 4 + c];
+            endpoint1[c] = block[minIndex * 4 + c];
+        }
+        uint16_t c0 = Pack565(endpoint0), c1 = Pack565(endpoint1);
+        uint32_t indices;
+        int error = ChooseColorIndices(block, c0, c1, indices);
+
+        // Mínimos quadrados: cada texel é w*c0 + (1-w)*c1 com w = 1, 0, 2/3, 1/3
+        static const float WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0, ab = 0, bb = 0, ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+        for (int i = 0; i < 16; ++i) {
+            float w = WEIGHTS[(indices >> (2 * i)) & 3];
+            aa += w * w; ab += w * (1 - w); bb += (1 - w) * (1 - w);
+            for (int c = 0; c < 3; ++c) {
+                ax[c] += w * block[i * 4 + c];
+                bx[c] += (1 - w) * block[i * 4 + c];
+            }
+        }
+        float det = aa * bb - ab * ab;
+        if (std::fabs(det) > 1e-4f) {
+            for (int c = 0; c < 3; ++c) {
+                endpoint0[c] = (bb * ax[c] - ab * bx[c]) / det;
+                endpoint1[c] = (aa * bx[c] - ab * ax[c]) / det;
+            }
+            uint16_t r0 = Pack565(endpoint0), r1 = Pack565(endpoint1);
+            uint32_t refined;
+            int refinedError = ChooseColorIndices(block, r0, r1, refined);
+            if (refinedError < error) {
+                c0 = r0; c1 = r1; indices = refined; error = refinedError;
+            }
+        }
+
+        if (c0 < c1) {
+            // Trocar os extremos troca também 0<->1 e 2<->3
+            std::swap(c0, c1);
+            indices ^= 0x55555555u;
+        }
+        else if (c0 == c1) {
+            indices = 0;
+        }
+        out[0] = static_cast<unsigned char>(c0 & 0xFF);
+        out[1] = static_cast<unsigned char>(c0 >> 8);
+        out[2] = static_cast<unsigned char>(c1 & 0xFF);
+        out[3] = static_cast<unsigned char>(c1 >> 8);
+        for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+
+    // Alfa do BC3: a0 = máximo, a1 = mínimo, 8 valores interpolados e índices de 3 bits
+    static void EncodeAlphaBlock(const unsigned char block[64], unsigned char out[8]) {
+        int a0 = 0, a1 = 255;
+        for (int i = 0; i < 16; ++i) {
+            a0 = std::max(a0, static_cast<int>(block[i * 4 + 3]));
+            a1 = std::min(a1, static_cast<int>(block[i * 4 + 3]));
+        }
+        out[0] = static_cast<unsigned char>(a0);
+        out[1] = static_cast<unsigned char>(a1);
+        uint64_t indices = 0;
+        if (a0 > a1) {
+            int palette[8] = { a0, a1 };
+            for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            for (int i = 0; i < 16; ++i) {
+                int best = 0, bestError = 1 << 30;
+                for (int p = 0; p < 8; ++p) {
+                    int e = std::abs(block[i * 4 + 3] - palette[p]);
+                    if (e < bestError) { bestError = e; best = p; }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+        for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+
+    static void EncodeLevel(const std::vector<unsigned char>& rgba, uint32_t width, uint32_t height,
+        BakedFormat format, std::vector<unsigned char>& blocks) {
+        const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const size_t blockBytes = format == BakedFormat::BC3 ? 16 : 8;
+        blocks.resize(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+        unsigned char block[64];
+        unsigned char* out = blocks.data();
+        for (uint32_t by = 0; by < blocksY; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                // Níveis com menos de 4 texels repetem a última linha/coluna
+                for (uint32_t y = 0; y < 4; ++y) {
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        uint32_t sx = std::min(bx * 4 + x, width - 1), sy = std::min(by * 4 + y, height - 1);
+                        std::memcpy(block + (y * 4 + x) * 4, &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+                    }
+                }
+                if (format == BakedFormat::BC3) {
+                    EncodeAlphaBlock(block, out);
+                    out += 8;
+                }
+                EncodeColorBlock(block, out);
+                out += 8;
+            }
+        }
+    }
+
+    bool BakeTexture(const std::string& imageFilePath, BakedTexture& baked) {
+        std::vector<unsigned char> file;
+        if (!ReadFile(imageFilePath, file) || !FileStamp(imageFilePath, baked.sourceSize, baked.sourceTime)) {
+            std::cerr << "Erro ao abrir a imagem: " << imageFilePath << std::endl;
+            return false;
+        }
+        baked.sourceHash = HashBytes(file.data(), file.size());
+
+        DecodedImage image;
+        if (!DecodeImage(file.data(), file.size(), image, 4)) {
+            std::cerr << "Erro ao descodificar a imagem: " << imageFilePath << std::endl;
+            return false;
+        }
+
+        // BC3 só se o alfa for mesmo usado; um PNG RGBA opaco fica em BC1
+        const size_t texelCount = static_cast<size_t>(image.width) * image.height;
+        bool hasAlpha = false;
+        for (size_t i = 0; i < texelCount && !hasAlpha; ++i) hasAlpha = image.pixels[i * 4 + 3] != 255;
+        baked.format = hasAlpha ? BakedFormat::BC3 : BakedFormat::BC1;
+        baked.mips.clear();
+
+        LinearImage level;
+        ToLinear(image.pixels.data(), static_cast<uint32_t>(image.width), static_cast<uint32_t>(image.height), level);
+        std::vector<unsigned char> rgba;
+        rgba.swap(image.pixels);
+
+        for (;;) {
+            BakedMip mip;
+            mip.width = level.width;
+            mip.height = level.height;
+            EncodeLevel(rgba, level.width, level.height, baked.format, mip.blocks);
+            baked.mips.push_back(std::move(mip));
+            if (level.width == 1 && level.height == 1) break;
+
+            LinearImage next;
+            Downsample(level, next);
+            level.width = next.width;
+            level.height = next.height;
+            level.texels.swap(next.texels);
+            ToSRGB8(level, rgba);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- pacote
+
+    bool WriteBakedTexture(const std::string& packFilePath, const BakedTexture& baked) {
+        PackHeader header;
+        std::memcpy(header.magic, PACK_MAGIC, 4);
+        header.version = PACK_VERSION;
+        header.format = static_cast<uint32_t>(baked.format);
+        header.mipCount = static_cast<uint32_t>(baked.mips.size());
+        header.sourceHash = baked.sourceHash;
+        header.sourceSize = baked.sourceSize;
+        header.sourceTime = baked.sourceTime;
+
+        // Grava num temporário e renomeia, para um leitor nunca ver um pacote a meio
+        std::string temporaryPath = packFilePath + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const BakedMip& mip : baked.mips) {
+                PackMipHeader mipHeader = { mip.width, mip.height, static_cast<uint32_t>(mip.blocks.size()), 0 };
+                file.write(reinterpret_cast<const char*>(&mipHeader), sizeof(mipHeader));
+                file.write(reinterpret_cast<const char*>(mip.blocks.data()), mip.blocks.size());
+            }
+            if (!file.good()) {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+        std::remove(packFilePath.c_str());
+        return std::rename(temporaryPath.c_str(), packFilePath.c_str()) == 0;
+    }
+
+    bool ReadBakedTexture(const std::string& imageFilePath, BakedTexture& baked) {
+        std::vector<unsigned char> pack;
+        return ReadFile(BakedTexturePath(imageFilePath), pack) && ParseBakedTexture(imageFilePath, pack.data(), pack.size(), baked);
+    }
+
+    bool ParseBakedTexture(const std::string& imageFilePath, const unsigned char* data, size_t size, BakedTexture& baked) {
+        size_t offset = 0;
+        auto read = [&](void* target, size_t count) {
+            if (size - offset < count) return false;
+            std::memcpy(target, data + offset, count);
+            offset += count;
+            return true;
+        };
+
+        PackHeader header;
+        if (!read(&header, sizeof(header))) return false;
+        if (!std::equal(PACK_MAGIC, PACK_MAGIC + 4, header.magic) || header.version != PACK_VERSION ||
+            (header.format != static_cast<uint32_t>(BakedFormat::BC1) && header.format != static_cast<uint32_t>(BakedFormat::BC3)) ||
+            header.mipCount == 0 || header.mipCount > 32) {
+            return false;
+        }
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        if (FileStamp(imageFilePath, sourceSize, sourceTime) &&
+            (sourceSize != header.sourceSize || sourceTime != header.sourceTime)) {
+            return false;
+        }
+
+        baked.format = static_cast<BakedFormat>(header.format);
+        baked.sourceHash = header.sourceHash;
+        baked.sourceSize = header.sourceSize;
+        baked.sourceTime = header.sourceTime;
+        baked.mips.resize(header.mipCount);
+        const size_t blockBytes = baked.format == BakedFormat::BC3 ? 16 : 8;
+        for (BakedMip& mip : baked.mips) {
+            PackMipHeader mipHeader;
+            if (!read(&mipHeader, sizeof(mipHeader))) return false;
+            if (mipHeader.width == 0 || mipHeader.height == 0 || mipHeader.width > 16384 || mipHeader.height > 16384 ||
+                mipHeader.byteCount != ((mipHeader.width + 3) / 4) * ((mipHeader.height + 3) / 4) * blockBytes) {
+                return false;
+            }
+            mip.width = mipHeader.width;
+            mip.height = mipHeader.height;
+            mip.blocks.resize(mipHeader.byteCount);
+            if (!read(mip.blocks.data(), mip.blocks.size())) return false;
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- --bake-textures
+
+    int RunTextureBaker(const std::vector<std::string>& inputs, bool force) {
+        std::vector<std::string> images;
+        CollectImageFiles(inputs, images);
+        if (images.empty()) {
+            std::cerr << "Erro: nenhuma imagem para processar" << std::endl;
+            return -1;
+        }
+
+        int failures = 0;
+        size_t totalRaw = 0, totalBaked = 0;
+        std::printf("%-40s %11s %4s %6s %10s %10s %8s\n", "imagem", "tamanho", "fmt", "mips", "RGBA8 KB", "pacote KB", "ms");
+        for (const std::string& image : images) {
+            BakedTexture baked;
+            if (!force && ReadBakedTexture(image, baked)) {
+                std::printf("%-40s %11s\n", image.c_str(), "atualizado");
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            if (!BakeTexture(image, baked) || !WriteBakedTexture(BakedTexturePath(image), baked)) {
+                std::cerr << "Erro ao gerar o pacote de " << image << std::endl;
+                ++failures;
+                continue;
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // Referência: o upload antigo (RGB/RGBA + glGenerateMipmap) ocupa ~4 bytes por texel com mips
+            size_t raw = 0, packed = 0;
+            for (const BakedMip& mip : baked.mips) {
+                raw += static_cast<size_t>(mip.width) * mip.height * 4;
+                packed += mip.blocks.size();
+            }
+            totalRaw += raw;
+            totalBaked += packed;
+            char size[32];
+            std::snprintf(size, sizeof(size), "%ux%u", baked.mips[0].width, baked.mips[0].height);
+            std::printf("%-40s %11s %4s %6zu %10.1f %10.1f %8.1f\n", image.c_str(), size,
+                baked.format == BakedFormat::BC3 ? "BC3" : "BC1", baked.mips.size(),
+                raw / 1024.0, packed / 1024.0, ms);
+        }
+        if (totalBaked > 0) {
+            std::printf("VRAM: %.1f KB -> %.1f KB (%.1fx menos)\n", totalRaw / 1024.0, totalBaked / 1024.0,
+                static_cast<double>(totalRaw) / totalBaked);
+        }
+        return failures == 0 ? 0 : -1;
+    }
+
+} // namespace P3D
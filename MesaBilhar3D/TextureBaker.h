@@ -0,0 +1,55 @@
+#ifndef TEXTUREBAKER_H
+#define TEXTUREBAKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace P3D {
+
+    // Formatos comprimidos em blocos de 4x4 (S3TC); os valores são os gravados no pacote
+    enum class BakedFormat : uint32_t {
+        BC1 = 1,    // RGB, 8 bytes por bloco (4 bits/texel)
+        BC3 = 3     // RGBA, BC1 + alfa interpolado, 16 bytes por bloco (8 bits/texel)
+    };
+
+    struct BakedMip {
+        uint32_t width;
+        uint32_t height;
+        std::vector<unsigned char> blocks;
+    };
+
+    // Textura já comprimida com a cadeia de mipmaps completa (até 1x1)
+    struct BakedTexture {
+        BakedFormat format = BakedFormat::BC1;
+        std::vector<BakedMip> mips;
+        uint64_t sourceHash = 0;    // HashBytes do ficheiro de imagem original
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+    };
+
+    // FNV-1a de 64 bits (também é a chave de conteúdo da TextureCache)
+    uint64_t HashBytes(const unsigned char* data, size_t size);
+
+    // Pacote ao lado da imagem: mesmo nome, extensão .p3dtex
+    std::string BakedTexturePath(const std::string& imageFilePath);
+
+    // Descodifica a imagem, gera os mipmaps em espaço linear (a partir de sRGB) e comprime
+    // cada nível em BC1 (sem alfa) ou BC3 (com alfa)
+    bool BakeTexture(const std::string& imageFilePath, BakedTexture& baked);
+
+    bool WriteBakedTexture(const std::string& packFilePath, const BakedTexture& baked);
+    // Lê o pacote da imagem; falha se não existir ou se a imagem mudou depois de ser gerado
+    // (uma imagem ausente não invalida o pacote, para se poder distribuir só os .p3dtex)
+    bool ReadBakedTexture(const std::string& imageFilePath, BakedTexture& baked);
+    // O mesmo a partir do pacote já lido para memória (ex.: por um FileBatch)
+    bool ParseBakedTexture(const std::string& imageFilePath, const unsigned char* data, size_t size, BakedTexture& baked);
+
+    // --bake-textures: cada entrada é uma imagem ou uma pasta (todas as .jpg/.png/.tga/.bmp);
+    // sem force só se geram os pacotes em falta ou desatualizados. 0 se tudo correu bem.
+    int RunTextureBaker(const std::vector<std::string>& inputs, bool force);
+
+} // namespace P3D
+
+#endif // TEXTUREBAKER_H
@@ -0,0 +1,386 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <sys/stat.h>
+
+#include "FileBatch.h"
+#include "StartupTrace.h"
+
+namespace P3D {
+
+    // Caminho absoluto sem "..", "." nem links; se o ficheiro não existir fica o original
+    static std::string CanonicalPath(const std::string& path) {
+#ifdef _WIN32
+        char buffer[_MAX_PATH];
+        if (!_fullpath(buffer, path.c_str(), _MAX_PATH)) return path;
+        std::string canonical = buffer;
+        // NTFS não distingue maiúsculas nem o tipo de barra
+        for (char& c : canonical) {
+            c = (c == '/') ? '\\' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return canonical;
+#else
+        char buffer[PATH_MAX];
+        if (!realpath(path.c_str(), buffer)) return path;
+        return buffer;
+#endif
+    }
+
+    static bool FileStamp(const std::string& path, uint64_t& size, int64_t& time) {
+#ifdef _WIN32
+        struct _stat64 info;
+        if (_stat64(path.c_str(), &info) != 0) return false;
+#else
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+#endif
+        size = static_cast<uint64_t>(info.st_size);
+        time = static_cast<int64_t>(info.st_mtime);
+        return true;
+    }
+
+    static bool ReadFile(const std::string& filePath, std::vector<unsigned char>& data) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        std::streamoff size = file.tellg();
+        if (size <= 0) return false;
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+    }
+
+    static void SetSamplerState(GLuint texture) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    // Imagem PNG/JPEG já descodificada (Prepare): o driver gera os mipmaps
+    static GLuint UploadImage(const DecodedImage& image, size_t& bytes) {
+        TraceScope uploadScope("textura.enviar");
+        uploadScope.AddBytes(image.pixels.size());
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        SetSamplerState(texture);
+
+        // Linhas RGB sem padding: o alinhamento de 4 bytes por omissão só serve a RGBA
+        GLenum format = (image.channels == 4) ? GL_RGBA : GL_RGB;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        // Os drivers guardam RGB8 com 4 bytes por texel; a cadeia de mipmaps soma ~1/3
+        bytes = static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 4 * 4 / 3;
+        return texture;
+    }
+
+    // Pacote do --bake-textures: todos os níveis já comprimidos, enviados tal como estão
+    static GLuint UploadBaked(const BakedTexture& baked, size_t& bytes) {
+        GLenum format = baked.format == BakedFormat::BC3 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+        TraceScope scope("textura.enviar");
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        SetSamplerState(texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(baked.mips.size()) - 1);
+
+        bytes = 0;
+        for (size_t level = 0; level < baked.mips.size(); ++level) {
+            const BakedMip& mip = baked.mips[level];
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), format, mip.width, mip.height, 0,
+                static_cast<GLsizei>(mip.blocks.size()), mip.blocks.data());
+            bytes += mip.blocks.size();
+        }
+        scope.AddBytes(bytes);
+        return texture;
+    }
+
+    TextureCache& TextureCache::Instance() {
+        static TextureCache cache;
+        return cache;
+    }
+
+    GLuint TextureCache::AddReference(Entry& entry) {
+        if (entry.references++ == 0) unused.erase(entry.lruPosition);
+        return entry.texture;
+    }
+
+    GLuint TextureCache::Acquire(const std::string& filePath) {
+        TraceScope scope("textura", filePath);
+        PreparedTexture prepared;
+        Prepare(filePath, prepared);
+        return Acquire(prepared);
+    }
+
+    void TextureCache::AddReads(const std::string& filePath, FileBatch& files) const {
+        uint64_t size = 0;
+        int64_t time = 0;
+        const std::string packFilePath = BakedTexturePath(filePath);
+        if (GLEW_EXT_texture_compression_s3tc && FileStamp(packFilePath, size, time)) files.Add(packFilePath);
+        else files.Add(filePath);
+    }
+
+    bool TextureCache::Prepare(const std::string& filePath, PreparedTexture& prepared, FileBatch* files) {
+        prepared = PreparedTexture();
+        prepared.filePath = filePath;
+        prepared.canonicalPath = CanonicalPath(filePath);
+        // Sem a imagem (só o .p3dtex distribuído) a data de referência é a do pacote
+        prepared.stamped = FileStamp(prepared.canonicalPath, prepared.fileSize, prepared.fileTime) ||
+            FileStamp(BakedTexturePath(prepared.canonicalPath), prepared.fileSize, prepared.fileTime);
+
+        // Caminho já visto e ficheiro igual: nem se abre o ficheiro
+        {
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            auto path = paths.find(prepared.canonicalPath);
+            if (prepared.stamped && path != paths.end() &&
+                path->second.fileSize == prepared.fileSize && path->second.fileTime == prepared.fileTime) {
+                return true;
+            }
+        }
+        return Load(prepared, false, files);
+    }
+
+    // Lê o ficheiro (se ainda não foi lido) e descodifica-o. Sem decode, um conteúdo que já
+    // esteja na cache fica só com o hash.
+    bool TextureCache::Load(PreparedTexture& prepared, bool decode, FileBatch* files) {
+        std::vector<unsigned char> file;
+        // Ficheiro já lido pelo lote (nulo se não foi pedido ou se a leitura falhou)
+        const std::vector<unsigned char>* source = nullptr;
+        if (!prepared.hashed) {
+            // O pacote guarda o hash da imagem de onde veio, por isso a deduplicação por
+            // conteúdo funciona igual com e sem pacote
+            TraceScope readScope("textura.ler");
+            if (GLEW_EXT_texture_compression_s3tc) {
+                const std::vector<unsigned char>* pack = files ? files->Wait(BakedTexturePath(prepared.filePath)) : nullptr;
+                prepared.fromBaked = pack ? ParseBakedTexture(prepared.canonicalPath, pack->data(), pack->size(), prepared.baked) :
+                    ReadBakedTexture(prepared.canonicalPath, prepared.baked);
+            }
+            if (prepared.fromBaked) {
+                prepared.contentHash = prepared.baked.sourceHash;
+                for (const BakedMip& mip : prepared.baked.mips) readScope.AddBytes(mip.blocks.size());
+            }
+            else {
+                source = files ? files->Wait(prepared.filePath) : nullptr;
+                if (!source || source->empty()) {
+                    if (!ReadFile(prepared.canonicalPath, file)) {
+                        prepared.failed = true;
+                        return false;
+                    }
+                    source = &file;
+                }
+                prepared.contentHash = HashBytes(source->data(), source->size());
+                readScope.AddBytes(source->size());
+            }
+            prepared.hashed = true;
+        }
+
+        // Mesmo conteúdo com outro nome (cópias da mesma imagem em pastas diferentes)
+        if (!decode) {
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            if (contents.count(prepared.contentHash)) {
+                prepared.baked = BakedTexture();
+                return true;
+            }
+        }
+
+        if (prepared.fromBaked) {
+            // Já lido no Prepare e descartado porque o conteúdo estava na cache
+            if (prepared.baked.mips.empty() && !ReadBakedTexture(prepared.canonicalPath, prepared.baked)) {
+                prepared.failed = true;
+                return false;
+            }
+            prepared.decoded = true;
+            return true;
+        }
+
+        if (!source) {
+            if (!ReadFile(prepared.canonicalPath, file)) {
+                prepared.failed = true;
+                return false;
+            }
+            source = &file;
+        }
+        TraceScope decodeScope("textura.descodificar");
+        if (!DecodeImage(source->data(), source->size(), prepared.image)) {
+            prepared.failed = true;
+            return false;
+        }
+        // Cinzento e cinzento+alfa passam a RGB/RGBA, como o formato GL do envio espera
+        if (prepared.image.channels < 3) ConvertImageChannels(prepared.image, prepared.image.channels == 2 ? 4 : 3);
+        decodeScope.AddBytes(prepared.image.pixels.size());
+        prepared.decoded = true;
+        return true;
+    }
+
+    GLuint TextureCache::Acquire(PreparedTexture& prepared) {
+        const std::string& canonical = prepared.canonicalPath;
+        if (prepared.failed) {
+            std::cerr << "Falha ao carregar textura: " << prepared.filePath << std::endl;
+            return 0;
+        }
+
+        auto path = paths.find(canonical);
+        if (path != paths.end()) {
+            if (prepared.stamped && path->second.fileSize == prepared.fileSize && path->second.fileTime == prepared.fileTime) {
+                ++stats.pathHits;
+                return AddReference(entries.at(path->second.texture));
+            }
+            // O ficheiro mudou: quem já tem a textura antiga continua com ela
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            paths.erase(path);
+        }
+
+        // O Prepare encontrou o caminho na cache mas a textura foi despejada entretanto
+        if (!prepared.hashed && !Load(prepared, false)) {
+            std::cerr << "Falha ao carregar textura: " << prepared.filePath << std::endl;
+            return 0;
+        }
+
+        auto content = contents.find(prepared.contentHash);
+        if (content != contents.end()) {
+            ++stats.contentHits;
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            paths[canonical] = PathEntry{ content->second, prepared.fileSize, prepared.fileTime };
+            return AddReference(entries.at(content->second));
+        }
+
+        if (!prepared.decoded && !Load(prepared, true)) {
+            std::cerr << "Falha ao carregar textura: " << prepared.filePath << std::endl;
+            return 0;
+        }
+
+        size_t bytes = 0;
+        GLuint texture = prepared.fromBaked ? UploadBaked(prepared.baked, bytes) : UploadImage(prepared.image, bytes);
+        // Os pixels já estão na GPU
+        prepared.image = DecodedImage();
+        prepared.baked = BakedTexture();
+        prepared.decoded = false;
+        if (!texture) {
+            std::cerr << "Falha ao carregar textura: " << prepared.filePath << std::endl;
+            return 0;
+        }
+        ++stats.misses;
+        if (prepared.fromBaked) ++stats.bakedLoads;
+
+        Entry entry;
+        entry.texture = texture;
+        entry.contentHash = prepared.contentHash;
+        entry.bytes = bytes;
+        entry.references = 1;
+        entries.emplace(texture, entry);
+        {
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            paths[canonical] = PathEntry{ texture, prepared.fileSize, prepared.fileTime };
+            contents[prepared.contentHash] = texture;
+        }
+        stats.residentBytes += entry.bytes;
+        stats.textureCount = entries.size();
+
+        if (budget > 0) Evict(budget);
+        return texture;
+    }
+
+    void TextureCache::Forget(const std::string& filePath) {
+        std::lock_guard<std::mutex> lock(lookupMutex);
+        paths.erase(CanonicalPath(filePath));
+    }
+
+    void TextureCache::AppendMemory(std::vector<AssetMemory>& report) const {
+        // O mesmo conteúdo pode ter vários caminhos: fica o primeiro por ordem alfabética
+        std::unordered_map<GLuint, std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            for (const auto& path : paths) {
+                std::string& name = names[path.second.texture];
+                if (name.empty() || path.first < name) name = path.first;
+            }
+        }
+        std::vector<AssetMemory> textures;
+        for (const auto& entry : entries) {
+            AssetMemory memory;
+            const std::string& path = names[entry.first];
+            if (path.empty()) memory.name = "textura " + std::to_string(entry.first);
+            else memory.name = path.substr(path.find_last_of("/\\") + 1);
+            memory.residency = "textura";
+            memory.gpuBytes = entry.second.bytes;
+            textures.push_back(memory);
+        }
+        std::sort(textures.begin(), textures.end(), [](const AssetMemory& a, const AssetMemory& b) { return a.name < b.name; });
+        report.insert(report.end(), textures.begin(), textures.end());
+    }
+
+    void TextureCache::Release(GLuint texture) {
+        if (texture == 0) return;
+        auto it = entries.find(texture);
+        if (it == entries.end() || it->second.references == 0) {
+            std::cerr << "Erro ao libertar textura fora da cache: " << texture << std::endl;
+            return;
+        }
+        Entry& entry = it->second;
+        if (--entry.references == 0) {
+            unused.push_front(texture);
+            entry.lruPosition = unused.begin();
+            if (budget > 0) Evict(budget);
+        }
+    }
+
+    void TextureCache::SetBudget(size_t bytes) {
+        budget = bytes;
+        if (budget > 0) Evict(budget);
+    }
+
+    // Apaga as texturas sem referências, da menos usada para a mais usada, até caber em targetBytes
+    void TextureCache::Evict(size_t targetBytes) {
+        while (stats.residentBytes > targetBytes && !unused.empty()) {
+            GLuint texture = unused.back();
+            unused.pop_back();
+            Erase(texture);
+            ++stats.evictions;
+        }
+    }
+
+    void TextureCache::Erase(GLuint texture) {
+        auto it = entries.find(texture);
+        if (it == entries.end()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            auto content = contents.find(it->second.contentHash);
+            if (content != contents.end() && content->second == texture) contents.erase(content);
+            for (auto path = paths.begin(); path != paths.end();) {
+                if (path->second.texture == texture) path = paths.erase(path);
+                else ++path;
+            }
+        }
+
+        stats.residentBytes -= it->second.bytes;
+        glDeleteTextures(1, &texture);
+        entries.erase(it);
+        stats.textureCount = entries.size();
+    }
+
+    void TextureCache::Clear() {
+        for (auto& entry : entries) {
+            glDeleteTextures(1, &entry.second.texture);
+        }
+        entries.clear();
+        {
+            std::lock_guard<std::mutex> lock(lookupMutex);
+            paths.clear();
+            contents.clear();
+        }
+        unused.clear();
+        stats.residentBytes = 0;
+        stats.textureCount = 0;
+    }
+
+} // namespace P3D
@@ -0,0 +1,131 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+
+#include "ImageDecode.h"
+#include "Residency.h"
+#include "TextureBaker.h"
+
+namespace P3D {
+
+    class FileBatch;
+
+    struct TextureCacheStats {
+        uint64_t pathHits = 0;      // caminho canónico já carregado (sem ler o ficheiro)
+        uint64_t contentHits = 0;   // ficheiro diferente com o mesmo conteúdo
+        uint64_t misses = 0;        // enviado para a GPU
+        uint64_t bakedLoads = 0;    // dos misses, os que vieram de um .p3dtex (sem descodificar)
+        uint64_t evictions = 0;
+        size_t residentBytes = 0;   // estimativa de VRAM (com mipmaps)
+        size_t textureCount = 0;
+    };
+
+    // Imagem lida e descodificada por TextureCache::Prepare, pronta para o Acquire
+    struct PreparedTexture {
+        std::string filePath;           // como foi pedido (mensagens de erro)
+        std::string canonicalPath;
+        uint64_t fileSize = 0;
+        int64_t fileTime = 0;
+        bool stamped = false;
+        bool failed = false;            // ficheiro em falta ou imagem inválida
+        bool hashed = false;            // ficheiro lido e contentHash calculado
+        bool decoded = false;           // image (ou baked) com os dados para enviar
+        bool fromBaked = false;
+        uint64_t contentHash = 0;
+        DecodedImage image;
+        BakedTexture baked;
+    };
+
+    // Cache de texturas do processo: cada imagem é descodificada e enviada uma só vez,
+    // identificada pelo caminho canónico e pelo hash do conteúdo do ficheiro. Se houver um
+    // .p3dtex atualizado ao lado da imagem (--bake-textures) e o driver suportar S3TC, os
+    // mipmaps já comprimidos são enviados sem descodificar nada. As texturas
+    // têm contagem de referências; as que ficam sem referências continuam residentes
+    // (um novo Acquire devolve-as logo) até o total passar do orçamento de VRAM, altura
+    // em que as menos usadas recentemente são apagadas.
+    // Prepare pode correr em qualquer thread (carregamento em paralelo); o resto só deve
+    // ser usado na thread do contexto GL.
+    class TextureCache {
+    public:
+        static TextureCache& Instance();
+
+        // Devolve a textura (com mais uma referência) ou 0 se a imagem não carregar.
+        // Igual a Prepare + Acquire(prepared) na mesma thread.
+        GLuint Acquire(const std::string& filePath);
+        // Lê e descodifica a imagem sem tocar em GL. Não lê nada se o caminho já estiver
+        // na cache, nem descodifica se o conteúdo já estiver. Falso se a imagem não carregar.
+        // Com files, usa o que AddReads lá pediu em vez de ler o ficheiro.
+        bool Prepare(const std::string& filePath, PreparedTexture& prepared, FileBatch* files = nullptr);
+        // Pede ao lote o ficheiro que o Prepare vai ler: o pacote .p3dtex se existir e a
+        // GPU tiver S3TC (só na thread GL), senão a imagem
+        void AddReads(const std::string& filePath, FileBatch& files) const;
+        // Envia a imagem preparada (ou reutiliza a textura residente). Se entretanto a
+        // textura que o Prepare encontrou tiver sido despejada, lê a imagem outra vez aqui.
+        GLuint Acquire(PreparedTexture& prepared);
+        // Larga uma referência obtida com Acquire; 0 é ignorado
+        void Release(GLuint texture);
+        // O ficheiro mudou (recarregamento a quente): o próximo Prepare do caminho volta a
+        // lê-lo mesmo com o tamanho e a data iguais. Quem tem a textura antiga fica com ela.
+        void Forget(const std::string& filePath);
+
+        // 0 = sem limite. Só as texturas sem referências podem ser despejadas.
+        void SetBudget(size_t bytes);
+        size_t GetBudget() const { return budget; }
+
+        // Apaga todas as texturas; chamar antes de destruir o contexto GL
+        void Clear();
+
+        const TextureCacheStats& GetStats() const { return stats; }
+        // Uma linha por textura residente, com o nome do ficheiro. Os pixels descodificados
+        // morrem com o PreparedTexture depois do envio: na CPU não fica nada.
+        void AppendMemory(std::vector<AssetMemory>& report) const;
+
+    private:
+        struct Entry {
+            GLuint texture = 0;
+            uint64_t contentHash = 0;
+            size_t bytes = 0;
+            int references = 0;
+            std::list<GLuint>::iterator lruPosition;    // válido só com references == 0
+        };
+
+        // Caminho canónico -> textura, com o tamanho/data do ficheiro quando foi lido
+        struct PathEntry {
+            GLuint texture = 0;
+            uint64_t fileSize = 0;
+            int64_t fileTime = 0;
+        };
+
+        std::unordered_map<GLuint, Entry> entries;
+        std::unordered_map<std::string, PathEntry> paths;
+        std::unordered_map<uint64_t, GLuint> contents;
+        std::list<GLuint> unused;           // sem referências, a mais recente à frente
+        // paths e contents são lidos pelo Prepare noutras threads; só a thread GL os altera,
+        // sempre com o mutex
+        mutable std::mutex lookupMutex;
+
+        size_t budget = 256u << 20;
+        TextureCacheStats stats;
+
+        TextureCache() = default;
+        ~TextureCache() = default;
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        bool Load(PreparedTexture& prepared, bool decode, FileBatch* files = nullptr);
+        GLuint AddReference(Entry& entry);
+        void Evict(size_t targetBytes);
+        void Erase(GLuint texture);
+    };
+
+} // namespace P3D
+
+#endif // TEXTURECACHE_H
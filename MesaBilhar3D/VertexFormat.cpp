@@ -0,0 +1,208 @@
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace P3D {
+
+    const char* OctDecodeGLSL = R"(
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.y += (n.y >= 0.0) ? -t : t;
+    return normalize(n);
+}
+)";
+
+    const char* DequantizeGLSL = R"(
+uniform vec3 uPosMin;
+uniform vec3 uPosExtent;
+uniform vec2 uUVMin;
+uniform vec2 uUVExtent;
+vec3 dequantPosition(vec3 q) { return uPosMin + q * uPosExtent; }
+vec2 dequantTexCoord(vec2 q) { return uUVMin + q * uUVExtent; }
+)";
+
+    glm::vec2 OctEncode(const glm::vec3& n) {
+        float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        if (l1 <= 0.0f) return glm::vec2(0.0f, 0.0f);
+
+        glm::vec2 p(n.x / l1, n.y / l1);
+        if (n.z < 0.0f) {
+            // Dobrar o hemisfério inferior sobre os cantos do quadrado
+            float px = (1.0f - std::fabs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f);
+            float py = (1.0f - std::fabs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f);
+            p = glm::vec2(px, py);
+        }
+        return p;
+    }
+
+    glm::vec3 OctDecode(const glm::vec2& e) {
+        glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+        float t = n.z < 0.0f ? -n.z : 0.0f;
+        n.x += (n.x >= 0.0f) ? -t : t;
+        n.y += (n.y >= 0.0f) ? -t : t;
+        return glm::normalize(n);
+    }
+
+    GLsizei VertexStride(VertexFormat format) {
+        switch (format) {
+        case VertexFormat::Compact: return sizeof(CompactVertex);
+        case VertexFormat::Quantized: return sizeof(QuantizedVertex);
+        default: return sizeof(Vertex);
+        }
+    }
+
+    static uint16_t QuantizeUnorm16(float value, float minValue, float extent) {
+        if (extent <= 0.0f) return 0;
+        float t = (value - minValue) / extent;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        return static_cast<uint16_t>(std::lround(t * 65535.0f));
+    }
+
+    static int8_t QuantizeSnorm8(float value) {
+        if (value < -1.0f) value = -1.0f;
+        if (value > 1.0f) value = 1.0f;
+        return static_cast<int8_t>(std::lround(value * 127.0f));
+    }
+
+    static void QuantizeVertices(const std::vector<Vertex>& vertices, QuantizedVertex* dst, QuantizationInfo& quant) {
+        quant = QuantizationInfo();
+        if (vertices.empty()) return;
+
+        glm::vec3 posMin = vertices[0].position, posMax = vertices[0].position;
+        glm::vec2 uvMin = vertices[0].texCoord, uvMax = vertices[0].texCoord;
+        for (const Vertex& v : vertices) {
+            posMin = glm::min(posMin, v.position);
+            posMax = glm::max(posMax, v.position);
+            uvMin = glm::min(uvMin, v.texCoord);
+            uvMax = glm::max(uvMax, v.texCoord);
+        }
+        quant.positionMin = posMin;
+        quant.positionExtent = posMax - posMin;
+        quant.texCoordMin = uvMin;
+        quant.texCoordExtent = uvMax - uvMin;
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex& v = vertices[i];
+            QuantizedVertex& q = dst[i];
+
+            glm::vec3 pos;
+            for (int c = 0; c < 3; ++c) {
+                q.position[c] = QuantizeUnorm16(v.position[c], posMin[c], quant.positionExtent[c]);
+                pos[c] = posMin[c] + q.position[c] / 65535.0f * quant.positionExtent[c];
+            }
+            quant.maxPositionError = std::max(quant.maxPositionError, glm::length(pos - v.position));
+
+            glm::vec2 uv;
+            for (int c = 0; c < 2; ++c) {
+                q.texCoord[c] = QuantizeUnorm16(v.texCoord[c], uvMin[c], quant.texCoordExtent[c]);
+                uv[c] = uvMin[c] + q.texCoord[c] / 65535.0f * quant.texCoordExtent[c];
+            }
+            quant.maxTexCoordError = std::max(quant.maxTexCoordError, glm::length(uv - v.texCoord));
+
+            float len = glm::length(v.normal);
+            if (len > 0.0f) {
+                glm::vec3 n = v.normal / len;
+                glm::vec2 oct = OctEncode(n);
+                q.normal[0] = QuantizeSnorm8(oct.x);
+                q.normal[1] = QuantizeSnorm8(oct.y);
+                glm::vec3 decoded = OctDecode(glm::vec2(q.normal[0] / 127.0f, q.normal[1] / 127.0f));
+                float cosAngle = std::min(1.0f, std::max(-1.0f, glm::dot(n, decoded)));
+                quant.maxNormalError = std::max(quant.maxNormalError, glm::degrees(std::acos(cosAngle)));
+            }
+            else {
+                q.normal[0] = q.normal[1] = 0;
+            }
+        }
+    }
+
+    void PackVertices(const std::vector<Vertex>& vertices, VertexFormat format, std::vector<unsigned char>& out,
+        QuantizationInfo* quant) {
+        out.resize(vertices.size() * VertexStride(format));
+
+        if (format == VertexFormat::Float32) {
+            if (!vertices.empty()) std::memcpy(out.data(), vertices.data(), out.size());
+            return;
+        }
+
+        if (format == VertexFormat::Quantized) {
+            QuantizationInfo info;
+            QuantizeVertices(vertices, reinterpret_cast<QuantizedVertex*>(out.data()), info);
+            if (quant) *quant = info;
+            return;
+        }
+
+        CompactVertex* dst = reinterpret_cast<CompactVertex*>(out.data());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex& v = vertices[i];
+            dst[i].position[0] = v.position.x;
+            dst[i].position[1] = v.position.y;
+            dst[i].position[2] = v.position.z;
+            dst[i].texCoord = glm::packHalf2x16(v.texCoord);
+            dst[i].normal = glm::packSnorm2x16(OctEncode(v.normal));
+        }
+    }
+
+    void SetupVertexAttributes(VertexFormat format, GLint posLoc, GLint texLoc, GLint normLoc) {
+        GLsizei stride = VertexStride(format);
+
+        if (format == VertexFormat::Float32) {
+            if (posLoc != -1) {
+                glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, position));
+                glEnableVertexAttribArray(posLoc);
+            }
+            if (texLoc != -1) {
+                glVertexAttribPointer(texLoc, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, texCoord));
+                glEnableVertexAttribArray(texLoc);
+            }
+            if (normLoc != -1) {
+                glVertexAttribPointer(normLoc, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, normal));
+                glEnableVertexAttribArray(normLoc);
+            }
+            return;
+        }
+
+        if (format == VertexFormat::Quantized) {
+            if (posLoc != -1) {
+                glVertexAttribPointer(posLoc, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(QuantizedVertex, position));
+                glEnableVertexAttribArray(posLoc);
+            }
+            if (texLoc != -1) {
+                glVertexAttribPointer(texLoc, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(QuantizedVertex, texCoord));
+                glEnableVertexAttribArray(texLoc);
+            }
+            if (normLoc != -1) {
+                glVertexAttribPointer(normLoc, 2, GL_BYTE, GL_TRUE, stride, (void*)offsetof(QuantizedVertex, normal));
+                glEnableVertexAttribArray(normLoc);
+            }
+            return;
+        }
+
+        if (posLoc != -1) {
+            glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(CompactVertex, position));
+            glEnableVertexAttribArray(posLoc);
+        }
+        if (texLoc != -1) {
+            glVertexAttribPointer(texLoc, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(CompactVertex, texCoord));
+            glEnableVertexAttribArray(texLoc);
+        }
+        if (normLoc != -1) {
+            // vec2 em [-1,1]; o shader reconstrói a normal com octDecode()
+            glVertexAttribPointer(normLoc, 2, GL_SHORT, GL_TRUE, stride, (void*)offsetof(CompactVertex, normal));
+            glEnableVertexAttribArray(normLoc);
+        }
+    }
+
+    void SetQuantizationUniforms(GLuint shaderProgram, const QuantizationInfo& quant) {
+        glUniform3fv(glGetUniformLocation(shaderProgram, "uPosMin"), 1, glm::value_ptr(quant.positionMin));
+        glUniform3fv(glGetUniformLocation(shaderProgram, "uPosExtent"), 1, glm::value_ptr(quant.positionExtent));
+        glUniform2fv(glGetUniformLocation(shaderProgram, "uUVMin"), 1, glm::value_ptr(quant.texCoordMin));
+        glUniform2fv(glGetUniformLocation(shaderProgram, "uUVExtent"), 1, glm::value_ptr(quant.texCoordExtent));
+    }
+
+} // namespace P3D
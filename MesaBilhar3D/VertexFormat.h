@@ -0,0 +1,75 @@
+#ifndef VERTEXFORMAT_H
+#define VERTEXFORMAT_H
+
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace P3D {
+
+    // Vértice intercalado (um único VBO, um único stream de fetch por vértice)
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec2 texCoord;
+        glm::vec3 normal;
+    };
+
+    // Variante comprimida: UV em half-float e normal octaédrica em 2x snorm16.
+    // 20 bytes por vértice em vez de 32.
+    struct CompactVertex {
+        float position[3];
+        uint32_t texCoord;   // glm::packHalf2x16
+        uint32_t normal;     // glm::packSnorm2x16(OctEncode(n))
+    };
+
+    // Variante quantizada: posição em unorm16 relativa à AABB da malha,
+    // normal octaédrica em 2x snorm8 e UV em unorm16 relativo ao retângulo de UVs.
+    // 12 bytes por vértice; a desquantização é feita no vertex shader.
+    struct QuantizedVertex {
+        uint16_t position[3];
+        int8_t normal[2];
+        uint16_t texCoord[2];
+    };
+
+    enum class VertexFormat {
+        Float32,
+        Compact,
+        Quantized
+    };
+
+    // Parâmetros de desquantização e erro máximo medido ao quantizar
+    struct QuantizationInfo {
+        glm::vec3 positionMin = glm::vec3(0.0f);
+        glm::vec3 positionExtent = glm::vec3(1.0f);
+        glm::vec2 texCoordMin = glm::vec2(0.0f);
+        glm::vec2 texCoordExtent = glm::vec2(1.0f);
+
+        float maxPositionError = 0.0f;   // unidades do modelo
+        float maxTexCoordError = 0.0f;   // unidades de UV
+        float maxNormalError = 0.0f;     // graus
+    };
+
+    glm::vec2 OctEncode(const glm::vec3& n);
+    glm::vec3 OctDecode(const glm::vec2& e);
+
+    // Constrói o buffer a enviar para a GPU no formato pedido
+    // (para Quantized, quant recebe os parâmetros de desquantização e os erros)
+    void PackVertices(const std::vector<Vertex>& vertices, VertexFormat format, std::vector<unsigned char>& out,
+        QuantizationInfo* quant = nullptr);
+    GLsizei VertexStride(VertexFormat format);
+
+    // Configura os atributos do VAO atualmente ligado (locations dadas; -1 = ignorar)
+    void SetupVertexAttributes(VertexFormat format, GLint posLoc, GLint texLoc, GLint normLoc);
+
+    // Define os uniforms uPosMin/uPosExtent/uUVMin/uUVExtent do programa atual
+    void SetQuantizationUniforms(GLuint shaderProgram, const QuantizationInfo& quant);
+
+    // Função GLSL para descodificar a normal dos formatos Compact e Quantized no vertex shader
+    extern const char* OctDecodeGLSL;
+    // Funções GLSL dequantPosition()/dequantTexCoord() para o formato Quantized
+    extern const char* DequantizeGLSL;
+
+} // namespace P3D
+
+#endif // VERTEXFORMAT_H
@@ -0,0 +1,199 @@
+#include "VertexFormatBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "ShaderCache.h"
+#include "Sphere.h"
+
+namespace P3D {
+
+    static const VertexFormat FORMATS[3] = { VertexFormat::Float32, VertexFormat::Compact, VertexFormat::Quantized };
+    static const char* FORMAT_NAMES[3] = { "Float32", "Compact", "Quantized" };
+
+    // Viewport onde se desenha: poucos pixels, o custo fica nos vértices
+    static const int VIEWPORT_SIZE = 32;
+
+    static const char* fragmentShaderSource = R"(
+#version 330 core
+in vec3 vColor;
+out vec4 FragColor;
+void main(){
+    FragColor = vec4(vColor, 1.0);
+}
+)";
+
+    // Um vertex shader por formato, com a descodificação que o formato exige; os três
+    // usam a posição, o UV e a normal para nenhum atributo ser descartado pelo compilador
+    static std::string VertexShaderSource(VertexFormat format) {
+        std::string source = "#version 330 core\n"
+            "layout(location=0) in vec3 position;\n"
+            "layout(location=1) in vec2 texcoord;\n";
+        source += format == VertexFormat::Float32 ? "layout(location=2) in vec3 normal;\n" : "layout(location=2) in vec2 normal;\n";
+        if (format != VertexFormat::Float32) source += OctDecodeGLSL;
+        if (format == VertexFormat::Quantized) source += DequantizeGLSL;
+        source += "uniform mat4 mvp;\nout vec3 vColor;\nvoid main(){\n";
+        if (format == VertexFormat::Quantized) {
+            source += "    vec3 p = dequantPosition(position);\n    vec2 uv = dequantTexCoord(texcoord);\n";
+        }
+        else {
+            source += "    vec3 p = position;\n    vec2 uv = texcoord;\n";
+        }
+        source += format == VertexFormat::Float32 ? "    vec3 n = normal;\n" : "    vec3 n = octDecode(normal);\n";
+        source += "    gl_Position = mvp * vec4(p, 1.0);\n"
+            "    vColor = n * 0.5 + 0.5 + vec3(uv, 0.0) * 0.01;\n"
+            "}\n";
+        return source;
+    }
+
+    static bool MeasureFormat(VertexFormat format, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+        const VertexFormatBenchmarkOptions& options, VertexFormatResult& result) {
+        std::string vertexSource = VertexShaderSource(format);
+        GLuint program = ShaderCache::Instance().CreateProgram(vertexSource.c_str(), fragmentShaderSource);
+        if (!program) return false;
+
+        std::vector<unsigned char> packed;
+        PackVertices(vertices, format, packed, &result.quantization);
+        result.format = format;
+        result.vertexCount = vertices.size();
+        result.vertexBufferBytes = packed.size();
+        result.indexBufferBytes = indices.size() * sizeof(unsigned int);
+
+        GLuint vao = 0, vbo = 0, ebo = 0, query = 0;
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+        glGenQueries(1, &query);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+        SetupVertexAttributes(format, 0, 1, 2);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, result.indexBufferBytes, indices.data(), GL_STATIC_DRAW);
+
+        glUseProgram(program);
+        if (format == VertexFormat::Quantized) SetQuantizationUniforms(program, result.quantization);
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 10.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        GLint mvpLoc = glGetUniformLocation(program, "mvp");
+
+        // Os primeiros frames (envio dos buffers, compilação tardia do driver) não contam
+        const int warmup = 3;
+        double gpuTotal = 0.0, cpuTotal = 0.0;
+        for (int frame = 0; frame < warmup + options.frames; ++frame) {
+            auto start = std::chrono::steady_clock::now();
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            for (int draw = 0; draw < options.draws; ++draw) {
+                glm::mat4 model = glm::rotate(glm::mat4(1.0f), draw * 0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+                glm::mat4 mvp = projection * view * model;
+                glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp));
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+            }
+            glEndQuery(GL_TIME_ELAPSED);
+            glFinish();
+            double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            if (frame < warmup) continue;
+            gpuTotal += nanoseconds / 1.0e6;
+            cpuTotal += cpuMs;
+        }
+        result.gpuMs = gpuTotal / options.frames;
+        result.cpuMs = cpuTotal / options.frames;
+
+        glBindVertexArray(0);
+        glDeleteQueries(1, &query);
+        glDeleteBuffers(1, &ebo);
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(program);
+        return true;
+    }
+
+    bool MeasureVertexFormats(const VertexFormatBenchmarkOptions& options, std::vector<VertexFormatResult>& results) {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        int slices = std::max(8, options.slices);
+        AppendSphere(vertices, indices, glm::vec3(0.0f), 1.0f, slices, slices / 2);
+
+        VertexFormatBenchmarkOptions settings = options;
+        settings.draws = std::max(1, options.draws);
+        settings.frames = std::max(1, options.frames);
+
+        glViewport(0, 0, VIEWPORT_SIZE, VIEWPORT_SIZE);
+        glEnable(GL_DEPTH_TEST);
+        results.clear();
+        for (int i = 0; i < 3; ++i) {
+            VertexFormatResult result;
+            if (!MeasureFormat(FORMATS[i], vertices, indices, settings, result)) {
+                std::cerr << "Erro ao criar o programa do formato " << FORMAT_NAMES[i] << std::endl;
+                return false;
+            }
+            results.push_back(result);
+        }
+        return true;
+    }
+
+    int RunVertexFormatBenchmark(const VertexFormatBenchmarkOptions& options) {
+        if (!glfwInit()) {
+            std::cerr << "Erro ao inicializar o GLFW" << std::endl;
+            return -1;
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* window = glfwCreateWindow(VIEWPORT_SIZE, VIEWPORT_SIZE, "bench-vertex-formats", nullptr, nullptr);
+        if (!window) {
+            std::cerr << "Erro ao criar a janela do benchmark" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(window);
+        glewExperimental = GL_TRUE;
+        if (glewInit() != GLEW_OK) {
+            std::cerr << "Erro ao inicializar o GLEW" << std::endl;
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return -1;
+        }
+        // Os programas do benchmark não interessam à cache do jogo
+        ShaderCache::Instance().SetDirectory("");
+        const GLubyte* rendererName = glGetString(GL_RENDERER);
+        std::string renderer = rendererName ? reinterpret_cast<const char*>(rendererName) : "?";
+
+        std::vector<VertexFormatResult> results;
+        bool measured = MeasureVertexFormats(options, results);
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        if (!measured) return -1;
+
+        std::printf("Esfera %d slices: %u vertices, %d draws/frame, media de %d frames (%s)\n", options.slices,
+            results.empty() ? 0u : static_cast<unsigned int>(results[0].vertexCount), options.draws, options.frames,
+            renderer.c_str());
+        std::printf("%-10s %8s %10s %10s %9s %9s %10s\n", "formato", "bytes/v", "VBO KB", "EBO KB", "GPU ms", "CPU ms", "fetch GB/s");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const VertexFormatResult& result = results[i];
+            // Bytes de vértices lidos por frame (cada draw lê o VBO inteiro) a dividir pelo tempo de GPU
+            double bandwidth = result.gpuMs > 0.0
+                ? static_cast<double>(result.vertexBufferBytes) * options.draws / (result.gpuMs * 1.0e6) : 0.0;
+            std::printf("%-10s %8d %10.1f %10.1f %9.3f %9.3f %10.2f\n", FORMAT_NAMES[i], VertexStride(result.format),
+                result.vertexBufferBytes / 1024.0, result.indexBufferBytes / 1024.0, result.gpuMs, result.cpuMs, bandwidth);
+        }
+        for (const VertexFormatResult& result : results) {
+            if (result.format != VertexFormat::Quantized) continue;
+            std::printf("Quantized: erro max posicao %g, uv %g, normal %.2f graus\n", result.quantization.maxPositionError,
+                result.quantization.maxTexCoordError, result.quantization.maxNormalError);
+        }
+        return 0;
+    }
+
+} // namespace P3D
@@ -0,0 +1,38 @@
+#ifndef VERTEXFORMATBENCHMARK_H
+#define VERTEXFORMATBENCHMARK_H
+
+#include <cstddef>
+#include <vector>
+
+#include "VertexFormat.h"
+
+namespace P3D {
+
+    // Esfera com slices x slices/2 quads desenhada draws vezes por frame num viewport
+    // pequeno, para o tempo ser dominado pelo fetch e pelo vertex shader e não pelos pixels
+    struct VertexFormatBenchmarkOptions {
+        int slices = 512;       // ~130K vértices, ~790K índices
+        int draws = 50;
+        int frames = 20;
+    };
+
+    // Resultado de um formato: memória dos buffers e tempos médios por frame
+    struct VertexFormatResult {
+        VertexFormat format = VertexFormat::Float32;
+        size_t vertexCount = 0;
+        size_t vertexBufferBytes = 0;
+        size_t indexBufferBytes = 0;
+        double gpuMs = 0.0;             // GL_TIME_ELAPSED
+        double cpuMs = 0.0;             // submissão + glFinish
+        QuantizationInfo quantization;  // erros, só com Quantized
+    };
+
+    // Mede Float32, Compact e Quantized com o contexto GL atual. Falso se um programa não ligar.
+    bool MeasureVertexFormats(const VertexFormatBenchmarkOptions& options, std::vector<VertexFormatResult>& results);
+
+    // --bench-vertex-formats: cria uma janela escondida, mede e imprime a tabela. 0 se correu.
+    int RunVertexFormatBenchmark(const VertexFormatBenchmarkOptions& options);
+
+} // namespace P3D
+
+#endif // VERTEXFORMATBENCHMARK_H
@@ -1,41 +1,28 @@
-#include "loadOBJ.h"
-#include "tiny_obj_loader.h"
-#include <glad/glad.h>
-#include <iostream>
+#include "loadobj.h"
+#include <GL/glew.h>
+#include <stdexcept>
 
-Mesh loadOBJ(const std::string& filepath) {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
+#include "MeshImport.h"
 
-    std::string base_dir = "models/";
-    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err,
-        filepath.c_str(), base_dir.c_str());
-
-    if (!warn.empty()) std::cout << "WARN: " << warn << std::endl;
-    if (!err.empty()) std::cerr << "ERR: " << err << std::endl;
-    if (!ret) throw std::runtime_error("Failed to load OBJ");
+Mesh loadOBJ(const std::string& filepath, bool upload) {
+    P3D::MeshData imported;
+    if (!P3D::ImportMesh(filepath, imported)) throw std::runtime_error("Failed to load OBJ");
 
+    // Só posições (3 floats por vértice), como antes
     std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-
-    for (const auto& shape : shapes) {
-        for (const auto& index : shape.mesh.indices) {
-            float vx = attrib.vertices[3 * index.vertex_index + 0];
-            float vy = attrib.vertices[3 * index.vertex_index + 1];
-            float vz = attrib.vertices[3 * index.vertex_index + 2];
-            vertices.push_back(vx);
-            vertices.push_back(vy);
-            vertices.push_back(vz);
-        }
+    vertices.reserve(imported.vertices.size() * 3);
+    for (const P3D::Vertex& vertex : imported.vertices) {
+        vertices.push_back(vertex.position.x);
+        vertices.push_back(vertex.position.y);
+        vertices.push_back(vertex.position.z);
     }
 
-    for (unsigned int i = 0; i < vertices.size() / 3; i++) indices.push_back(i);
-
+    // Trocados, não copiados: só o Mesh devolvido fica com a geometria
     Mesh mesh;
-    mesh.vertices = vertices;
-    mesh.indices = indices;
+    mesh.vertices.swap(vertices);
+    mesh.indices.swap(imported.indices);
+    mesh.VAO = mesh.VBO = mesh.EBO = 0;
+    if (!upload) return mesh;
 
     glGenVertexArrays(1, &mesh.VAO);
     glGenBuffers(1, &mesh.VBO);
@@ -43,10 +30,10 @@ Mesh loadOBJ(const std::string& filepath) {
 
     glBindVertexArray(mesh.VAO);
     glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), &mesh.vertices[0], GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), &mesh.indices[0], GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
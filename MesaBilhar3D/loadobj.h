@@ -9,4 +9,5 @@ struct Mesh {
     unsigned int VAO, VBO, EBO;
 };
 
-Mesh loadOBJ(const std::string& filepath);
+// upload = false deixa VAO/VBO/EBO a 0 e não precisa de contexto GL
+Mesh loadOBJ(const std::string& filepath, bool upload = true);